@@ -112,6 +112,24 @@ void evaluatePatchesLimit(OpenSubdiv_Evaluator *evaluator,
       patch_coords, num_patch_coords, P, dPdu, dPdv);
 }
 
+void createLimitStencils(OpenSubdiv_Evaluator *evaluator,
+                         const OpenSubdiv_PatchCoord *patch_coords,
+                         const int num_patch_coords)
+{
+  evaluator->impl->eval_output->createLimitStencils(patch_coords, num_patch_coords);
+}
+
+void evaluateLimitStencils(OpenSubdiv_Evaluator *evaluator,
+                           const int start_stencil_index,
+                           const int num_stencils,
+                           float *P,
+                           float *dPdu,
+                           float *dPdv)
+{
+  evaluator->impl->eval_output->evaluateLimitStencils(
+      start_stencil_index, num_stencils, P, dPdu, dPdv);
+}
+
 void evaluateVarying(OpenSubdiv_Evaluator *evaluator,
                      const int ptex_face_index,
                      float face_u,
@@ -149,6 +167,9 @@ void assignFunctionPointers(OpenSubdiv_Evaluator *evaluator)
   evaluator->evaluateFaceVarying = evaluateFaceVarying;
 
   evaluator->evaluatePatchesLimit = evaluatePatchesLimit;
+
+  evaluator->createLimitStencils = createLimitStencils;
+  evaluator->evaluateLimitStencils = evaluateLimitStencils;
 }
 
 }  // namespace
@@ -35,6 +35,11 @@
 #include <opensubdiv/osd/types.h>
 #include <opensubdiv/version.h>
 
+#ifdef WITH_TBB
+#  include <tbb/blocked_range.h>
+#  include <tbb/parallel_for.h>
+#endif
+
 #include "MEM_guardedalloc.h"
 
 #include "internal/base/type.h"
@@ -508,6 +513,12 @@ class VolatileEvalOutput {
                                   device_context_);
   }
 
+  // Coarse and refined control points, valid after refine().
+  const float *getSrcData()
+  {
+    return src_data_->BindCpuBuffer();
+  }
+
   void evalPatchesFaceVarying(const int face_varying_channel,
                               const PatchCoord *patch_coord,
                               const int num_patch_coords,
@@ -585,8 +596,9 @@ class CpuEvalOutput : public VolatileEvalOutput<CpuVertexBuffer,
 // Evaluator wrapper for anonymous API.
 
 CpuEvalOutputAPI::CpuEvalOutputAPI(CpuEvalOutput *implementation,
-                                   OpenSubdiv::Far::PatchMap *patch_map)
-    : implementation_(implementation), patch_map_(patch_map)
+                                   OpenSubdiv::Far::PatchMap *patch_map,
+                                   const PatchTable *patch_table)
+    : implementation_(implementation), patch_map_(patch_map), patch_table_(patch_table)
 {
 }
 
@@ -735,6 +747,32 @@ void CpuEvalOutputAPI::evaluatePatchesLimit(const OpenSubdiv_PatchCoord *patch_c
                                             float *P,
                                             float *dPdu,
                                             float *dPdv)
+{
+#ifdef WITH_TBB
+  // Evaluate large batches in blocks from multiple threads. Blocks are big
+  // enough to amortize patch coordinates conversion and evaluator lookup.
+  const int grain_size = 1024;
+  if (num_patch_coords > grain_size) {
+    tbb::parallel_for(tbb::blocked_range<int>(0, num_patch_coords, grain_size),
+                      [&](const tbb::blocked_range<int> &range) {
+                        const int offset = range.begin() * 3;
+                        evaluatePatchesLimitRange(patch_coords + range.begin(),
+                                                  range.size(),
+                                                  P + offset,
+                                                  (dPdu != NULL) ? dPdu + offset : NULL,
+                                                  (dPdv != NULL) ? dPdv + offset : NULL);
+                      });
+    return;
+  }
+#endif
+  evaluatePatchesLimitRange(patch_coords, num_patch_coords, P, dPdu, dPdv);
+}
+
+void CpuEvalOutputAPI::evaluatePatchesLimitRange(const OpenSubdiv_PatchCoord *patch_coords,
+                                                 const int num_patch_coords,
+                                                 float *P,
+                                                 float *dPdu,
+                                                 float *dPdv)
 {
   StackOrHeapPatchCoordArray patch_coords_array;
   convertPatchCoordsToArray(patch_coords, num_patch_coords, patch_map_, &patch_coords_array);
@@ -747,6 +785,79 @@ void CpuEvalOutputAPI::evaluatePatchesLimit(const OpenSubdiv_PatchCoord *patch_c
   }
 }
 
+void CpuEvalOutputAPI::createLimitStencils(const OpenSubdiv_PatchCoord *patch_coords,
+                                           const int num_patch_coords)
+{
+  // Gregory basis end caps have the most control points of the patch types we create.
+  const int max_patch_vertices = 20;
+  float wP[max_patch_vertices], wDu[max_patch_vertices], wDv[max_patch_vertices];
+  limit_stencil_offsets_.resize(num_patch_coords + 1);
+  limit_stencil_indices_.clear();
+  limit_stencil_weights_.clear();
+  limit_stencil_indices_.reserve(num_patch_coords * 16);
+  limit_stencil_weights_.reserve(num_patch_coords * 16 * 3);
+  for (int i = 0; i < num_patch_coords; ++i) {
+    const OpenSubdiv_PatchCoord &patch_coord = patch_coords[i];
+    const PatchTable::PatchHandle *handle = patch_map_->FindPatch(
+        patch_coord.ptex_face, patch_coord.u, patch_coord.v);
+    const OpenSubdiv::Far::ConstIndexArray patch_vertices = patch_table_->GetPatchVertices(
+        *handle);
+    assert(patch_vertices.size() <= max_patch_vertices);
+    patch_table_->EvaluateBasis(*handle, patch_coord.u, patch_coord.v, wP, wDu, wDv);
+    limit_stencil_offsets_[i] = limit_stencil_indices_.size();
+    for (int j = 0; j < patch_vertices.size(); ++j) {
+      limit_stencil_indices_.push_back(patch_vertices[j]);
+      limit_stencil_weights_.push_back(wP[j]);
+      limit_stencil_weights_.push_back(wDu[j]);
+      limit_stencil_weights_.push_back(wDv[j]);
+    }
+  }
+  limit_stencil_offsets_[num_patch_coords] = limit_stencil_indices_.size();
+}
+
+void CpuEvalOutputAPI::evaluateLimitStencils(const int start_stencil_index,
+                                             const int num_stencils,
+                                             float *P,
+                                             float *dPdu,
+                                             float *dPdv)
+{
+  assert(start_stencil_index >= 0);
+  assert(start_stencil_index + num_stencils < limit_stencil_offsets_.size());
+  const float *src = implementation_->getSrcData();
+  const int *indices = limit_stencil_indices_.data();
+  const float *weights = limit_stencil_weights_.data();
+  for (int i = 0; i < num_stencils; ++i) {
+    const int stencil_index = start_stencil_index + i;
+    float p[3] = {0.0f, 0.0f, 0.0f};
+    float du[3] = {0.0f, 0.0f, 0.0f};
+    float dv[3] = {0.0f, 0.0f, 0.0f};
+    for (int j = limit_stencil_offsets_[stencil_index];
+         j < limit_stencil_offsets_[stencil_index + 1];
+         ++j) {
+      const float *co = src + indices[j] * 3;
+      const float *w = weights + j * 3;
+      for (int k = 0; k < 3; ++k) {
+        p[k] += w[0] * co[k];
+        du[k] += w[1] * co[k];
+        dv[k] += w[2] * co[k];
+      }
+    }
+    for (int k = 0; k < 3; ++k) {
+      P[i * 3 + k] = p[k];
+    }
+    if (dPdu != NULL) {
+      for (int k = 0; k < 3; ++k) {
+        dPdu[i * 3 + k] = du[k];
+      }
+    }
+    if (dPdv != NULL) {
+      for (int k = 0; k < 3; ++k) {
+        dPdv[i * 3 + k] = dv[k];
+      }
+    }
+  }
+}
+
 }  // namespace opensubdiv
 }  // namespace blender
 
@@ -874,7 +985,8 @@ OpenSubdiv_EvaluatorImpl *openSubdiv_createEvaluatorInternal(
   // Wrap everything we need into an object which we control from our side.
   OpenSubdiv_EvaluatorImpl *evaluator_descr;
   evaluator_descr = new OpenSubdiv_EvaluatorImpl();
-  evaluator_descr->eval_output = new blender::opensubdiv::CpuEvalOutputAPI(eval_output, patch_map);
+  evaluator_descr->eval_output = new blender::opensubdiv::CpuEvalOutputAPI(
+      eval_output, patch_map, patch_table);
   evaluator_descr->patch_map = patch_map;
   evaluator_descr->patch_table = patch_table;
   // TOOD(sergey): Look into whether we've got duplicated stencils arrays.
@@ -27,6 +27,7 @@
 #include <opensubdiv/far/patchTable.h>
 
 #include "internal/base/memory.h"
+#include "internal/base/type.h"
 
 struct OpenSubdiv_PatchCoord;
 struct OpenSubdiv_TopologyRefiner;
@@ -45,8 +46,10 @@ class CpuEvalOutput;
 // and such separate?
 class CpuEvalOutputAPI {
  public:
-  // NOTE: API object becomes an owner of evaluator. Patch we are referencing.
-  CpuEvalOutputAPI(CpuEvalOutput *implementation, OpenSubdiv::Far::PatchMap *patch_map);
+  // NOTE: API object becomes an owner of evaluator. Patch map and table we are referencing.
+  CpuEvalOutputAPI(CpuEvalOutput *implementation,
+                   OpenSubdiv::Far::PatchMap *patch_map,
+                   const OpenSubdiv::Far::PatchTable *patch_table);
   ~CpuEvalOutputAPI();
 
   // Set coarse positions from a continuous array of coordinates.
@@ -122,6 +125,7 @@ class CpuEvalOutputAPI {
 
   // Evaluate given ptex face at given bilinear coordinate.
   // If derivatives are NULL, they will not be evaluated.
+  // Large batches are evaluated from multiple threads when built with TBB.
   //
   // NOTE: Output arrays must point to a memory of size float[3]*num_patch_coords.
   void evaluatePatchesLimit(const OpenSubdiv_PatchCoord *patch_coords,
@@ -130,9 +134,41 @@ class CpuEvalOutputAPI {
                             float *dPdu,
                             float *dPdv);
 
+  // Limit stencils.
+
+  // Store refined control points and their patch basis weights for every
+  // given coordinate.
+  void createLimitStencils(const OpenSubdiv_PatchCoord *patch_coords, const int num_patch_coords);
+
+  // Evaluate stencils [start_stencil_index, start_stencil_index + num_stencils)
+  // as weighted sums of the refined control points.
+  //
+  // NOTE: Output arrays are indexed relative to start_stencil_index and must
+  // point to a memory of size float[3]*num_stencils.
+  void evaluateLimitStencils(const int start_stencil_index,
+                             const int num_stencils,
+                             float *P,
+                             float *dPdu,
+                             float *dPdv);
+
  protected:
+  // Single threaded evaluation of a batch.
+  void evaluatePatchesLimitRange(const OpenSubdiv_PatchCoord *patch_coords,
+                                 const int num_patch_coords,
+                                 float *P,
+                                 float *dPdu,
+                                 float *dPdv);
+
   CpuEvalOutput *implementation_;
   OpenSubdiv::Far::PatchMap *patch_map_;
+  const OpenSubdiv::Far::PatchTable *patch_table_;
+
+  // Limit stencils in compressed rows: stencil i uses control points
+  // limit_stencil_indices_[limit_stencil_offsets_[i]...limit_stencil_offsets_[i + 1]],
+  // with weights for position and both derivatives interleaved.
+  vector<int> limit_stencil_offsets_;
+  vector<int> limit_stencil_indices_;
+  vector<float> limit_stencil_weights_;
 };
 
 }  // namespace opensubdiv
@@ -113,6 +113,7 @@ typedef struct OpenSubdiv_Evaluator {
 
   // Evaluate limit surface.
   // If derivatives are NULL, they will not be evaluated.
+  // Large batches are evaluated from multiple threads.
   //
   // NOTE: Output arrays must point to a memory of size float[3]*num_patch_coords.
   void (*evaluatePatchesLimit)(struct OpenSubdiv_Evaluator *evaluator,
@@ -122,6 +123,31 @@ typedef struct OpenSubdiv_Evaluator {
                                float *dPdu,
                                float *dPdv);
 
+  // Limit stencils.
+  //
+  // Stencils store indices and weights of the refined control points of the
+  // patches at given coordinates, so repeated evaluation of the same
+  // coordinates after refine() is a weighted sum instead of a patch lookup
+  // and basis evaluation.
+
+  // Create limit stencils for the given coordinates, replacing previously
+  // created ones. Stencils stay valid for the lifetime of the evaluator.
+  void (*createLimitStencils)(struct OpenSubdiv_Evaluator *evaluator,
+                              const struct OpenSubdiv_PatchCoord *patch_coords,
+                              const int num_patch_coords);
+
+  // Evaluate limit stencils in the range [start_stencil_index,
+  // start_stencil_index + num_stencils). Output arrays are indexed relative to
+  // the start of the range, derivatives are optional.
+  //
+  // Is safe to be called from multiple threads for different ranges.
+  void (*evaluateLimitStencils)(struct OpenSubdiv_Evaluator *evaluator,
+                                const int start_stencil_index,
+                                const int num_stencils,
+                                float *P,
+                                float *dPdu,
+                                float *dPdv);
+
   // Implementation of the evaluator.
   struct OpenSubdiv_EvaluatorImpl *impl;
 } OpenSubdiv_Evaluator;
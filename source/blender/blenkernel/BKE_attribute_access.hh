@@ -25,6 +25,7 @@
 
 #include "BLI_color.hh"
 #include "BLI_float3.hh"
+#include "BLI_index_range.hh"
 
 struct Mesh;
 
@@ -99,12 +100,25 @@ class ReadAttribute {
     this->get_internal(index, r_value);
   }
 
+  /* Read the values in the range into a buffer, which is expected to be uninitialized. This is
+   * much faster than calling #get for every element. */
+  void get_range(const IndexRange range, void *r_buffer) const
+  {
+    BLI_assert(range.one_after_last() <= size_);
+    if (range.size() > 0) {
+      this->get_range_internal(range, r_buffer);
+    }
+  }
+
   /* Get a span that contains all attribute values. */
   fn::GSpan get_span() const;
 
  protected:
   /* r_value is expected to be uninitialized. */
   virtual void get_internal(const int64_t index, void *r_value) const = 0;
+  /* The default implementation calls #get_internal for every element. Subclasses override this
+   * to avoid a virtual call per element. */
+  virtual void get_range_internal(const IndexRange range, void *r_buffer) const;
 
   virtual void initialize_span() const;
 };
@@ -170,6 +184,24 @@ class WriteAttribute {
     this->set_internal(index, value);
   }
 
+  /* Read the values in the range into a buffer, which is expected to be uninitialized. */
+  void get_range(const IndexRange range, void *r_buffer) const
+  {
+    BLI_assert(range.one_after_last() <= size_);
+    if (range.size() > 0) {
+      this->get_range_internal(range, r_buffer);
+    }
+  }
+
+  /* Write the values from the buffer into the elements in the range. */
+  void set_range(const IndexRange range, const void *buffer)
+  {
+    BLI_assert(range.one_after_last() <= size_);
+    if (range.size() > 0) {
+      this->set_range_internal(range, buffer);
+    }
+  }
+
   /* Get a span that new attribute values can be written into. When all values have been changed,
    * #apply_span has to be called. The span might not contain the original attribute values. */
   fn::GMutableSpan get_span();
@@ -179,6 +211,9 @@ class WriteAttribute {
  protected:
   virtual void get_internal(const int64_t index, void *r_value) const = 0;
   virtual void set_internal(const int64_t index, const void *value) = 0;
+  /* The default implementations call #get_internal and #set_internal for every element. */
+  virtual void get_range_internal(const IndexRange range, void *r_buffer) const;
+  virtual void set_range_internal(const IndexRange range, const void *buffer);
 
   virtual void initialize_span();
   virtual void apply_span_if_necessary();
@@ -213,6 +248,13 @@ template<typename T> class TypedReadAttribute {
     return value;
   }
 
+  /* Copy the values in the range into the span, which is expected to be uninitialized. */
+  void get_range(const IndexRange range, MutableSpan<T> r_values) const
+  {
+    BLI_assert(range.size() == r_values.size());
+    attribute_->get_range(range, r_values.data());
+  }
+
   /* Get a span to that contains all attribute values for faster and more convenient access. */
   Span<T> get_span() const
   {
@@ -251,6 +293,13 @@ template<typename T> class TypedWriteAttribute {
     attribute_->set(index, &value);
   }
 
+  /* Write the values into the elements in the range. */
+  void set_range(const IndexRange range, Span<T> values)
+  {
+    BLI_assert(range.size() == values.size());
+    attribute_->set_range(range, values.data());
+  }
+
   /* Get a span that new values can be written into. Once all values have been updated #apply_span
    * has to be called. The span might *not* contain the initial attribute values, so one should
    * generally only write to the span. */
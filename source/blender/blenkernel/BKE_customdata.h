@@ -74,6 +74,12 @@ typedef enum eCDAllocType {
   CD_REFERENCE = 3,
   /** Do a full copy of all layers, only allowed if source has same number of elements. */
   CD_DUPLICATE = 4,
+  /**
+   * Share the data of all layers with the source, which is reference counted. Layers are treated
+   * like #CD_REFERENCE layers and copied on the first #CustomData_duplicate_referenced_layer.
+   * Only allowed if source has same number of elements.
+   */
+  CD_SHARE = 5,
 } eCDAllocType;
 
 #define CD_TYPE_AS_MASK(_type) (CustomDataMask)((CustomDataMask)1 << (CustomDataMask)(_type))
@@ -219,6 +225,7 @@ int CustomData_number_of_layers(const struct CustomData *data, int type);
 int CustomData_number_of_layers_typemask(const struct CustomData *data, CustomDataMask mask);
 
 /* duplicate data of a layer with flag NOFREE, and remove that flag.
+ * shared layers are only copied when other users remain.
  * returns the layer data */
 void *CustomData_duplicate_referenced_layer(struct CustomData *data,
                                             const int type,
@@ -249,6 +256,11 @@ void CustomData_copy_data(const struct CustomData *source,
                           int source_index,
                           int dest_index,
                           int count);
+void CustomData_copy_data_indices(const struct CustomData *source,
+                                  struct CustomData *dest,
+                                  const int *source_indices,
+                                  int dest_index,
+                                  int count);
 void CustomData_copy_data_named(const struct CustomData *source,
                                 struct CustomData *dest,
                                 int source_index,
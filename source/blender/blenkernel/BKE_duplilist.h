@@ -27,6 +27,8 @@ extern "C" {
 #endif
 
 struct Depsgraph;
+struct DupliObject;
+struct DupliStream;
 struct ListBase;
 struct Object;
 struct ParticleSystem;
@@ -40,6 +42,13 @@ struct ListBase *object_duplilist(struct Depsgraph *depsgraph,
                                   struct Object *ob);
 void free_object_duplilist(struct ListBase *lb);
 
+/* Iterate over instances without building a dupli-list, see #object_dupli_stream_begin. */
+struct DupliStream *object_dupli_stream_begin(struct Depsgraph *depsgraph,
+                                              struct Scene *sce,
+                                              struct Object *ob);
+struct DupliObject *object_dupli_stream_next(struct DupliStream *stream);
+void object_dupli_stream_end(struct DupliStream *stream);
+
 typedef struct DupliObject {
   struct DupliObject *next, *prev;
   struct Object *ob;
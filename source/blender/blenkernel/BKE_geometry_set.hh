@@ -88,6 +88,12 @@ class GeometryComponent {
 
   GeometryComponentType type() const;
 
+  /* Returns false when the component references data that is owned by someone else, which might
+   * be freed or modified while the component still exists. */
+  virtual bool owns_direct_data() const;
+  /* Make a copy of referenced data, so that the component can outlive its original owner. */
+  virtual void ensure_owns_direct_data();
+
   /* Returns true when the geometry component supports this attribute domain. */
   virtual bool attribute_domain_supported(const AttributeDomain domain) const;
   /* Returns true when the given data type is supported in the given domain. */
@@ -227,6 +233,8 @@ struct GeometrySet {
 
   void compute_boundbox_without_instances(blender::float3 *r_min, blender::float3 *r_max) const;
 
+  void ensure_owns_direct_data();
+
   friend std::ostream &operator<<(std::ostream &stream, const GeometrySet &geometry_set);
   friend bool operator==(const GeometrySet &a, const GeometrySet &b);
   uint64_t hash() const;
@@ -273,10 +281,14 @@ class MeshComponent : public GeometryComponent {
   Mesh *release();
 
   void copy_vertex_group_names_from_object(const struct Object &object);
+  const blender::Map<std::string, int> &vertex_group_names() const;
 
   const Mesh *get_for_read() const;
   Mesh *get_for_write();
 
+  bool owns_direct_data() const final;
+  void ensure_owns_direct_data() final;
+
   bool attribute_domain_supported(const AttributeDomain domain) const final;
   bool attribute_domain_with_type_supported(const AttributeDomain domain,
                                             const CustomDataType data_type) const final;
@@ -319,6 +331,9 @@ class PointCloudComponent : public GeometryComponent {
   const PointCloud *get_for_read() const;
   PointCloud *get_for_write();
 
+  bool owns_direct_data() const final;
+  void ensure_owns_direct_data() final;
+
   bool attribute_domain_supported(const AttributeDomain domain) const final;
   bool attribute_domain_with_type_supported(const AttributeDomain domain,
                                             const CustomDataType data_type) const final;
@@ -346,6 +346,7 @@ float *BKE_image_get_float_pixels_for_frame(struct Image *image, int frame, int
 /* Image modifications */
 bool BKE_image_is_dirty(struct Image *image);
 void BKE_image_mark_dirty(struct Image *image, struct ImBuf *ibuf);
+struct ImBuf *BKE_image_ibuf_ensure_writable(struct Image *ima, struct ImBuf *ibuf);
 bool BKE_image_buffer_format_writable(struct ImBuf *ibuf);
 bool BKE_image_is_dirty_writable(struct Image *image, bool *is_format_writable);
 
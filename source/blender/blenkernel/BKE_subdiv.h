@@ -97,6 +97,7 @@ typedef enum eSubdivStatsValue {
   SUBDIV_STATS_SUBDIV_TO_CCG,
   SUBDIV_STATS_SUBDIV_TO_CCG_ELEMENTS,
   SUBDIV_STATS_TOPOLOGY_COMPARE,
+  SUBDIV_STATS_EVALUATOR_LIMIT_STENCILS,
 
   NUM_SUBDIV_STATS_VALUES,
 } eSubdivStatsValue;
@@ -122,6 +123,8 @@ typedef struct SubdivStats {
       double subdiv_to_ccg_elements_time;
       /* Time spent on CCG elements evaluation/initialization. */
       double topology_compare_time;
+      /* Time spent on limit stencils creation. */
+      double evaluator_limit_stencils_time;
     };
     double values_[NUM_SUBDIV_STATS_VALUES];
   };
@@ -182,6 +185,19 @@ typedef struct Subdiv {
   struct OpenSubdiv_Evaluator *evaluator;
   /* Optional displacement evaluator. */
   struct SubdivDisplacement *displacement_evaluator;
+  /* Limit stencils of the evaluator, see BKE_subdiv_eval_limit_stencils_create(). */
+  struct {
+    /* Coordinates the stencils are created for. */
+    struct OpenSubdiv_PatchCoord *patch_coords;
+    int num_patch_coords;
+    /* Owner defined identifier of the coordinates layout, such as the resolution of the
+     * subdivided mesh. */
+    int tag;
+    /* Layout which was evaluated without stencils last time. Owners only create stencils when
+     * the same layout is evaluated again, since creation does not pay off for a single
+     * evaluation. */
+    int requested_tag;
+  } limit_stencils;
   /* Statistics for debugging. */
   SubdivStats stats;
 
@@ -212,6 +212,10 @@ typedef struct SubdivCCG {
     bool coords;
     /* Corresponds to MULTIRES_HIDDEN_MODIFIED. */
     bool hidden;
+    /* Indexed by grid index, hash of grid elements at the time of the last reshape to multires
+     * displacement. NULL until the first reshape. Allows to only reshape grids which were
+     * modified since then. */
+    uint64_t *reshape_grid_hashes;
   } dirty;
 
   /* Cached values, are not supposed to be accessed directly. */
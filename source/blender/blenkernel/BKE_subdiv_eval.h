@@ -30,6 +30,7 @@ extern "C" {
 #endif
 
 struct Mesh;
+struct OpenSubdiv_PatchCoord;
 struct Subdiv;
 
 /* Returns true if evaluator is ready for use. */
@@ -102,6 +103,41 @@ void BKE_subdiv_eval_displacement(struct Subdiv *subdiv,
 void BKE_subdiv_eval_final_point(
     struct Subdiv *subdiv, const int ptex_face_index, const float u, const float v, float r_P[3]);
 
+/* Batched point queries.
+ *
+ * Evaluate limit surface at an array of (ptex face, u, v) coordinates in a single call, which
+ * avoids per-point evaluator overhead. Large batches are evaluated from multiple threads by the
+ * evaluator, callers do not need to split them. Derivatives are optional, output arrays
+ * are indexed by coordinate. */
+void BKE_subdiv_eval_limit_points(struct Subdiv *subdiv,
+                                  const struct OpenSubdiv_PatchCoord *patch_coords,
+                                  const int num_patch_coords,
+                                  float (*r_P)[3],
+                                  float (*r_dPdu)[3],
+                                  float (*r_dPdv)[3]);
+
+/* Limit stencils.
+ *
+ * Precompute patch weights for a fixed set of coordinates, so evaluating them again after coarse
+ * positions changed is a weighted sum of refined control points. Meant for deforming meshes, which
+ * evaluate the same coordinates on every update. Stencils are kept with the evaluator, which is
+ * recreated when topology changes. */
+
+void BKE_subdiv_eval_limit_stencils_create(struct Subdiv *subdiv,
+                                           const struct OpenSubdiv_PatchCoord *patch_coords,
+                                           const int num_patch_coords,
+                                           const int tag);
+/* Check whether stencils were created for the given layout. */
+bool BKE_subdiv_eval_has_limit_stencils(const struct Subdiv *subdiv,
+                                        const int num_patch_coords,
+                                        const int tag);
+/* Evaluate points and derivatives of all stencils, output arrays are indexed by coordinate.
+ * Uses multiple threads. */
+void BKE_subdiv_eval_limit_stencils(struct Subdiv *subdiv,
+                                    float (*r_P)[3],
+                                    float (*r_dPdu)[3],
+                                    float (*r_dPdv)[3]);
+
 /* Patch queries at given resolution.
  *
  * Will evaluate patch at uniformly distributed (u, v) coordinates on a grid
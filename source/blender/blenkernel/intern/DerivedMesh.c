@@ -1758,6 +1758,55 @@ static void mesh_runtime_check_normals_valid(const Mesh *mesh)
   BLI_assert(!(mesh->runtime.cd_dirty_poly & CD_MASK_NORMAL));
 }
 
+/**
+ * Take the GPU batch cache of the previous evaluated mesh when it can be reused for the next one.
+ *
+ * This is the case when the previous result only had deform modifiers applied and the original
+ * mesh was not changed since, so the next result will have the same topology as long as the
+ * modifier stack is still deform only. That is checked in #mesh_batch_cache_reuse.
+ */
+static void *mesh_batch_cache_take(Object *ob)
+{
+  if (!ob->runtime.is_data_eval_owned || ob->runtime.data_eval == NULL ||
+      GS(ob->runtime.data_eval->name) != ID_ME || ob->runtime.data_orig == NULL) {
+    return NULL;
+  }
+
+  Mesh *mesh_eval_prev = (Mesh *)ob->runtime.data_eval;
+  const Mesh *mesh = (const Mesh *)ob->runtime.data_orig;
+  if (!mesh_eval_prev->runtime.deformed_only || (mesh->id.recalc & ID_RECALC_COPY_ON_WRITE)) {
+    return NULL;
+  }
+
+  void *batch_cache = mesh_eval_prev->runtime.batch_cache;
+  mesh_eval_prev->runtime.batch_cache = NULL;
+  return batch_cache;
+}
+
+/**
+ * Give the batch cache taken by #mesh_batch_cache_take to the new evaluated mesh, or free it when
+ * the topology might have changed.
+ */
+static void mesh_batch_cache_reuse(Object *ob,
+                                   Mesh *mesh_eval,
+                                   const bool is_mesh_eval_owned,
+                                   const int totelem_prev[4],
+                                   void *batch_cache)
+{
+  if (is_mesh_eval_owned && mesh_eval->runtime.deformed_only &&
+      mesh_eval->runtime.batch_cache == NULL && mesh_eval->totvert == totelem_prev[0] &&
+      mesh_eval->totedge == totelem_prev[1] && mesh_eval->totloop == totelem_prev[2] &&
+      mesh_eval->totpoly == totelem_prev[3]) {
+    mesh_eval->runtime.batch_cache = batch_cache;
+    ob->runtime.is_batch_cache_deform_only = true;
+    return;
+  }
+
+  Mesh mesh_tmp = {{NULL}};
+  mesh_tmp.runtime.batch_cache = batch_cache;
+  BKE_mesh_batch_cache_free(&mesh_tmp);
+}
+
 static void mesh_build_data(struct Depsgraph *depsgraph,
                             Scene *scene,
                             Object *ob,
@@ -1770,6 +1819,18 @@ static void mesh_build_data(struct Depsgraph *depsgraph,
    * they aren't cleaned up properly on mode switch, causing crashes, e.g T58150. */
   BLI_assert(ob->id.tag & LIB_TAG_COPIED_ON_WRITE);
 
+  /* Keep the GPU batch cache of the previous result for deform only updates, see
+   * #BKE_MESH_BATCH_DIRTY_DEFORM. */
+  void *batch_cache_prev = mesh_batch_cache_take(ob);
+  int totelem_prev[4] = {0};
+  if (batch_cache_prev != NULL) {
+    const Mesh *mesh_eval_prev = (const Mesh *)ob->runtime.data_eval;
+    totelem_prev[0] = mesh_eval_prev->totvert;
+    totelem_prev[1] = mesh_eval_prev->totedge;
+    totelem_prev[2] = mesh_eval_prev->totloop;
+    totelem_prev[3] = mesh_eval_prev->totpoly;
+  }
+
   BKE_object_free_derived_caches(ob);
   if (DEG_is_active(depsgraph)) {
     BKE_sculpt_update_object_before_eval(ob);
@@ -1807,6 +1868,10 @@ static void mesh_build_data(struct Depsgraph *depsgraph,
   const bool is_mesh_eval_owned = (mesh_eval != mesh->runtime.mesh_eval);
   BKE_object_eval_assign_data(ob, &mesh_eval->id, is_mesh_eval_owned);
 
+  if (batch_cache_prev != NULL) {
+    mesh_batch_cache_reuse(ob, mesh_eval, is_mesh_eval_owned, totelem_prev, batch_cache_prev);
+  }
+
   ob->runtime.mesh_deform_eval = mesh_deform_eval;
   ob->runtime.last_data_mask = *dataMask;
   ob->runtime.last_need_mapping = need_mapping;
@@ -74,14 +74,20 @@ fn::GSpan ReadAttribute::get_span() const
   return fn::GSpan(cpp_type_, array_buffer_, size_);
 }
 
+void ReadAttribute::get_range_internal(const IndexRange range, void *r_buffer) const
+{
+  const int element_size = cpp_type_.size();
+  for (const int64_t i : IndexRange(range.size())) {
+    this->get_internal(range.start() + i, POINTER_OFFSET(r_buffer, i * element_size));
+  }
+}
+
 void ReadAttribute::initialize_span() const
 {
   const int element_size = cpp_type_.size();
   array_buffer_ = MEM_mallocN_aligned(size_ * element_size, cpp_type_.alignment(), __func__);
   array_is_temporary_ = true;
-  for (const int i : IndexRange(size_)) {
-    this->get_internal(i, POINTER_OFFSET(array_buffer_, i * element_size));
-  }
+  this->get_range_internal(IndexRange(size_), array_buffer_);
 }
 
 WriteAttribute::~WriteAttribute()
@@ -111,6 +117,22 @@ fn::GMutableSpan WriteAttribute::get_span()
   return fn::GMutableSpan(cpp_type_, array_buffer_, size_);
 }
 
+void WriteAttribute::get_range_internal(const IndexRange range, void *r_buffer) const
+{
+  const int element_size = cpp_type_.size();
+  for (const int64_t i : IndexRange(range.size())) {
+    this->get_internal(range.start() + i, POINTER_OFFSET(r_buffer, i * element_size));
+  }
+}
+
+void WriteAttribute::set_range_internal(const IndexRange range, const void *buffer)
+{
+  const int element_size = cpp_type_.size();
+  for (const int64_t i : IndexRange(range.size())) {
+    this->set_internal(range.start() + i, POINTER_OFFSET(buffer, i * element_size));
+  }
+}
+
 void WriteAttribute::initialize_span()
 {
   array_buffer_ = MEM_mallocN_aligned(cpp_type_.size() * size_, cpp_type_.alignment(), __func__);
@@ -130,10 +152,7 @@ void WriteAttribute::apply_span_if_necessary()
   /* Only works when the span has been initialized beforehand. */
   BLI_assert(array_buffer_ != nullptr);
 
-  const int element_size = cpp_type_.size();
-  for (const int i : IndexRange(size_)) {
-    this->set_internal(i, POINTER_OFFSET(array_buffer_, i * element_size));
-  }
+  this->set_range_internal(IndexRange(size_), array_buffer_);
 }
 
 class VertexWeightWriteAttribute final : public WriteAttribute {
@@ -160,6 +179,20 @@ class VertexWeightWriteAttribute final : public WriteAttribute {
     weight->weight = *reinterpret_cast<const float *>(value);
   }
 
+  void get_range_internal(const IndexRange range, void *r_buffer) const override
+  {
+    get_range_internal(dverts_, dvert_index_, range, r_buffer);
+  }
+
+  void set_range_internal(const IndexRange range, const void *buffer) override
+  {
+    const float *weights = static_cast<const float *>(buffer);
+    for (const int64_t i : IndexRange(range.size())) {
+      MDeformWeight *weight = BKE_defvert_ensure_index(&dverts_[range.start() + i], dvert_index_);
+      weight->weight = weights[i];
+    }
+  }
+
   static void get_internal(const MDeformVert *dverts,
                            const int dvert_index,
                            const int64_t index,
@@ -178,6 +211,21 @@ class VertexWeightWriteAttribute final : public WriteAttribute {
     }
     *(float *)r_value = 0.0f;
   }
+
+  static void get_range_internal(const MDeformVert *dverts,
+                                 const int dvert_index,
+                                 const IndexRange range,
+                                 void *r_buffer)
+  {
+    float *weights = static_cast<float *>(r_buffer);
+    if (dverts == nullptr) {
+      std::fill_n(weights, range.size(), 0.0f);
+      return;
+    }
+    for (const int64_t i : IndexRange(range.size())) {
+      get_internal(dverts, dvert_index, range.start() + i, weights + i);
+    }
+  }
 };
 
 class VertexWeightReadAttribute final : public ReadAttribute {
@@ -197,6 +245,11 @@ class VertexWeightReadAttribute final : public ReadAttribute {
   {
     VertexWeightWriteAttribute::get_internal(dverts_, dvert_index_, index, r_value);
   }
+
+  void get_range_internal(const IndexRange range, void *r_buffer) const override
+  {
+    VertexWeightWriteAttribute::get_range_internal(dverts_, dvert_index_, range, r_buffer);
+  }
 };
 
 template<typename T> class ArrayWriteAttribute final : public WriteAttribute {
@@ -219,6 +272,17 @@ template<typename T> class ArrayWriteAttribute final : public WriteAttribute {
     data_[index] = *reinterpret_cast<const T *>(value);
   }
 
+  void get_range_internal(const IndexRange range, void *r_buffer) const override
+  {
+    uninitialized_copy_n(data_.data() + range.start(), range.size(), static_cast<T *>(r_buffer));
+  }
+
+  void set_range_internal(const IndexRange range, const void *buffer) override
+  {
+    initialized_copy_n(
+        static_cast<const T *>(buffer), range.size(), data_.data() + range.start());
+  }
+
   void initialize_span() override
   {
     array_buffer_ = data_.data();
@@ -246,6 +310,11 @@ template<typename T> class ArrayReadAttribute final : public ReadAttribute {
     new (r_value) T(data_[index]);
   }
 
+  void get_range_internal(const IndexRange range, void *r_buffer) const override
+  {
+    uninitialized_copy_n(data_.data() + range.start(), range.size(), static_cast<T *>(r_buffer));
+  }
+
   void initialize_span() const override
   {
     /* The data will not be modified, so this const_cast is fine. */
@@ -286,6 +355,22 @@ class DerivedArrayWriteAttribute final : public WriteAttribute {
     const ElemT &typed_value = *reinterpret_cast<const ElemT *>(value);
     set_function_(struct_value, typed_value);
   }
+
+  void get_range_internal(const IndexRange range, void *r_buffer) const override
+  {
+    ElemT *values = static_cast<ElemT *>(r_buffer);
+    for (const int64_t i : IndexRange(range.size())) {
+      new (values + i) ElemT(get_function_(data_[range.start() + i]));
+    }
+  }
+
+  void set_range_internal(const IndexRange range, const void *buffer) override
+  {
+    const ElemT *values = static_cast<const ElemT *>(buffer);
+    for (const int64_t i : IndexRange(range.size())) {
+      set_function_(data_[range.start() + i], values[i]);
+    }
+  }
 };
 
 template<typename StructT, typename ElemT, typename GetFuncT>
@@ -308,6 +393,14 @@ class DerivedArrayReadAttribute final : public ReadAttribute {
     const ElemT value = get_function_(struct_value);
     new (r_value) ElemT(value);
   }
+
+  void get_range_internal(const IndexRange range, void *r_buffer) const override
+  {
+    ElemT *values = static_cast<ElemT *>(r_buffer);
+    for (const int64_t i : IndexRange(range.size())) {
+      new (values + i) ElemT(get_function_(data_[range.start() + i]));
+    }
+  }
 };
 
 class ConstantReadAttribute final : public ReadAttribute {
@@ -336,12 +429,9 @@ class ConstantReadAttribute final : public ReadAttribute {
     this->cpp_type_.copy_to_uninitialized(value_, r_value);
   }
 
-  void initialize_span() const override
+  void get_range_internal(const IndexRange range, void *r_buffer) const override
   {
-    const int element_size = cpp_type_.size();
-    array_buffer_ = MEM_mallocN_aligned(size_ * element_size, cpp_type_.alignment(), __func__);
-    array_is_temporary_ = true;
-    cpp_type_.fill_uninitialized(value_, array_buffer_, size_);
+    this->cpp_type_.fill_uninitialized(value_, r_buffer, range.size());
   }
 };
 
@@ -375,6 +465,23 @@ class ConvertedReadAttribute final : public ReadAttribute {
     base_attribute_->get(index, buffer.ptr());
     conversions_.convert(from_type_, to_type_, buffer.ptr(), r_value);
   }
+
+  void get_range_internal(const IndexRange range, void *r_buffer) const override
+  {
+    /* Convert in chunks, so that the temporary buffer stays small and in cache. */
+    const int64_t chunk_size = std::min<int64_t>(range.size(), 1024);
+    void *from_buffer = MEM_mallocN_aligned(
+        chunk_size * from_type_.size(), from_type_.alignment(), __func__);
+    for (int64_t start = 0; start < range.size(); start += chunk_size) {
+      const int64_t size = std::min(chunk_size, range.size() - start);
+      base_attribute_->get_range(IndexRange(range.start() + start, size), from_buffer);
+      conversions_.convert_to_uninitialized_n(
+          fn::GSpan(from_type_, from_buffer, size),
+          fn::GMutableSpan(to_type_, POINTER_OFFSET(r_buffer, start * to_type_.size()), size));
+      from_type_.destruct_n(from_buffer, size);
+    }
+    MEM_freeN(from_buffer);
+  }
 };
 
 /** \} */
@@ -948,6 +1055,11 @@ WriteAttributePtr MeshComponent::attribute_try_get_for_write(const StringRef att
     if (mesh_->dvert == nullptr) {
       BKE_object_defgroup_data_create(&mesh_->id);
     }
+    else {
+      /* The weights might be shared with another mesh. */
+      CustomData_duplicate_referenced_layer(&mesh_->vdata, CD_MDEFORMVERT, mesh_->totvert);
+      update_mesh_pointers();
+    }
     return std::make_unique<blender::bke::VertexWeightWriteAttribute>(
         mesh_->dvert, mesh_->totvert, vertex_group_index);
   }
@@ -990,6 +1102,9 @@ bool MeshComponent::attribute_try_delete(const StringRef attribute_name)
 
   const int vertex_group_index = vertex_group_names_.lookup_default_as(attribute_name, -1);
   if (vertex_group_index != -1) {
+    /* The weights might be shared with another mesh. */
+    CustomData_duplicate_referenced_layer(&mesh_->vdata, CD_MDEFORMVERT, mesh_->totvert);
+    BKE_mesh_update_customdata_pointers(mesh_, false);
     for (MDeformVert &dvert : blender::MutableSpan(mesh_->dvert, mesh_->totvert)) {
       MDeformWeight *weight = BKE_defvert_find_index(&dvert, vertex_group_index);
       BKE_defvert_remove_group(&dvert, weight);
@@ -61,6 +61,8 @@
 
 #include "CLG_log.h"
 
+#include "atomic_ops.h"
+
 /* only for customdata_data_transfer_interp_normal_normals */
 #include "data_transfer_intern.h"
 
@@ -2063,6 +2065,78 @@ void CustomData_update_typemap(CustomData *data)
   }
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Layer Sharing
+ *
+ * Layers copied with #CD_SHARE point to the same data as their source. The data is owned by a
+ * reference counted #CustomDataLayerSharing, which is created lazily on the source layer the
+ * first time it is shared. Shared layers have #CD_FLAG_NOFREE set, so all code that already
+ * handles referenced layers leaves them alone, and they are copied on write by
+ * #CustomData_duplicate_referenced_layer. The last user frees the data.
+ * \{ */
+
+typedef struct CustomDataLayerSharing {
+  void *data;
+  int type;
+  int totelem;
+  int users;
+} CustomDataLayerSharing;
+
+/**
+ * Get the sharing of a layer, creating it when the layer owns its data. Returns null for layers
+ * which reference data owned by someone else, those can't be shared.
+ *
+ * The source of a copy is const and might be copied by multiple threads at the same time, the
+ * sharing is a run-time field that is set atomically.
+ */
+static CustomDataLayerSharing *customdata_layer_sharing_ensure(const CustomDataLayer *layer,
+                                                               const int totelem)
+{
+  if (layer->sharing) {
+    return layer->sharing;
+  }
+  if ((layer->flag & CD_FLAG_NOFREE) || layer->data == NULL) {
+    return NULL;
+  }
+
+  CustomDataLayerSharing *sharing = MEM_mallocN(sizeof(*sharing), __func__);
+  sharing->data = layer->data;
+  sharing->type = layer->type;
+  sharing->totelem = totelem;
+  sharing->users = 1;
+
+  CustomDataLayer *mutable_layer = (CustomDataLayer *)layer;
+  CustomDataLayerSharing *existing = atomic_cas_ptr(
+      (void **)&mutable_layer->sharing, NULL, sharing);
+  if (existing != NULL) {
+    MEM_freeN(sharing);
+    return existing;
+  }
+  atomic_fetch_and_or_int32(&mutable_layer->flag, CD_FLAG_NOFREE);
+  return sharing;
+}
+
+static void customdata_layer_sharing_add_user(CustomDataLayerSharing *sharing)
+{
+  atomic_add_and_fetch_int32(&sharing->users, 1);
+}
+
+static void customdata_layer_sharing_remove_user(CustomDataLayerSharing *sharing)
+{
+  if (atomic_sub_and_fetch_int32(&sharing->users, 1) != 0) {
+    return;
+  }
+
+  const LayerTypeInfo *typeInfo = layerType_getInfo(sharing->type);
+  if (typeInfo->free) {
+    typeInfo->free(sharing->data, sharing->totelem, typeInfo->size);
+  }
+  MEM_freeN(sharing->data);
+  MEM_freeN(sharing);
+}
+
+/** \} */
+
 /* currently only used in BLI_assert */
 #ifndef NDEBUG
 static bool customdata_typemap_is_valid(const CustomData *data)
@@ -2124,6 +2198,7 @@ bool CustomData_merge(const struct CustomData *source,
       case CD_ASSIGN:
       case CD_REFERENCE:
       case CD_DUPLICATE:
+      case CD_SHARE:
         data = layer->data;
         break;
       default:
@@ -2131,7 +2206,37 @@ bool CustomData_merge(const struct CustomData *source,
         break;
     }
 
-    if ((alloctype == CD_ASSIGN) && (flag & CD_FLAG_NOFREE)) {
+    /* Referencing or assigning already shared data has to go through the sharing as well, since
+     * the source layer does not own the data. When assigning, the user of the source layer is
+     * transferred. */
+    CustomDataLayerSharing *sharing = NULL;
+    if (alloctype == CD_SHARE) {
+      sharing = customdata_layer_sharing_ensure(layer, totelem);
+    }
+    else if (ELEM(alloctype, CD_REFERENCE, CD_ASSIGN)) {
+      sharing = layer->sharing;
+    }
+
+    if (sharing) {
+      newlayer = customData_add_layer__internal(
+          dest, type, CD_REFERENCE, data, totelem, layer->name);
+      if (newlayer) {
+        newlayer->sharing = sharing;
+        if (alloctype == CD_ASSIGN) {
+          /* The source keeps the data as a reference, freeing it must not remove the user. */
+          layer->sharing = NULL;
+        }
+        else {
+          customdata_layer_sharing_add_user(sharing);
+        }
+      }
+    }
+    else if (alloctype == CD_SHARE) {
+      /* Data owned by someone else can't be shared, fall back to a copy. */
+      newlayer = customData_add_layer__internal(
+          dest, type, CD_DUPLICATE, data, totelem, layer->name);
+    }
+    else if ((alloctype == CD_ASSIGN) && (flag & CD_FLAG_NOFREE)) {
       newlayer = customData_add_layer__internal(
           dest, type, CD_REFERENCE, data, totelem, layer->name);
     }
@@ -2188,7 +2293,11 @@ static void customData_free_layer__internal(CustomDataLayer *layer, int totelem)
 {
   const LayerTypeInfo *typeInfo;
 
-  if (!(layer->flag & CD_FLAG_NOFREE) && layer->data) {
+  if (layer->sharing) {
+    customdata_layer_sharing_remove_user(layer->sharing);
+    layer->sharing = NULL;
+  }
+  else if (!(layer->flag & CD_FLAG_NOFREE) && layer->data) {
     typeInfo = layerType_getInfo(layer->type);
 
     if (typeInfo->free) {
@@ -2563,6 +2672,7 @@ static CustomDataLayer *customData_add_layer__internal(CustomData *data,
   data->layers[index].type = type;
   data->layers[index].flag = flag;
   data->layers[index].data = newlayerdata;
+  data->layers[index].sharing = NULL;
 
   /* Set default name if none exists. Note we only call DATA_()  once
    * we know there is a default name, to avoid overhead of locale lookups
@@ -2744,6 +2854,13 @@ static void *customData_duplicate_referenced_layer_index(CustomData *data,
 
   CustomDataLayer *layer = &data->layers[layer_index];
 
+  if (layer->sharing && layer->sharing->users == 1) {
+    /* This layer is the last user of the shared data, take ownership without a copy. */
+    MEM_freeN(layer->sharing);
+    layer->sharing = NULL;
+    layer->flag &= ~CD_FLAG_NOFREE;
+  }
+
   if (layer->flag & CD_FLAG_NOFREE) {
     /* MEM_dupallocN won't work in case of complex layers, like e.g.
      * CD_MDEFORMVERT, which has pointers to allocated data...
@@ -2761,6 +2878,10 @@ static void *customData_duplicate_referenced_layer_index(CustomData *data,
       layer->data = MEM_dupallocN(layer->data);
     }
 
+    if (layer->sharing) {
+      customdata_layer_sharing_remove_user(layer->sharing);
+      layer->sharing = NULL;
+    }
     layer->flag &= ~CD_FLAG_NOFREE;
   }
 
@@ -2953,6 +3074,53 @@ void CustomData_copy_data(
   }
 }
 
+/**
+ * Like #CustomData_copy_data, but gathers the elements at \a source_indices into \a count
+ * consecutive elements starting at \a dest_index. Disjoint destination ranges can be filled
+ * from multiple threads.
+ */
+void CustomData_copy_data_indices(const CustomData *source,
+                                  CustomData *dest,
+                                  const int *source_indices,
+                                  int dest_index,
+                                  int count)
+{
+  int dest_i = 0;
+  for (int src_i = 0; src_i < source->totlayer; src_i++) {
+    while (dest_i < dest->totlayer && dest->layers[dest_i].type < source->layers[src_i].type) {
+      dest_i++;
+    }
+    if (dest_i >= dest->totlayer) {
+      return;
+    }
+    if (dest->layers[dest_i].type != source->layers[src_i].type) {
+      continue;
+    }
+
+    const LayerTypeInfo *typeInfo = layerType_getInfo(source->layers[src_i].type);
+    const char *src_data = source->layers[src_i].data;
+    char *dst_data = dest->layers[dest_i].data;
+    dest_i++;
+
+    if (!count || !src_data || !dst_data) {
+      continue;
+    }
+
+    const size_t size = (size_t)typeInfo->size;
+    dst_data += (size_t)dest_index * size;
+    if (typeInfo->copy) {
+      for (int i = 0; i < count; i++) {
+        typeInfo->copy(src_data + (size_t)source_indices[i] * size, dst_data + i * size, 1);
+      }
+    }
+    else {
+      for (int i = 0; i < count; i++) {
+        memcpy(dst_data + i * size, src_data + (size_t)source_indices[i] * size, size);
+      }
+    }
+  }
+}
+
 void CustomData_copy_layer_type_data(const CustomData *source,
                                      CustomData *destination,
                                      int type,
@@ -3243,6 +3411,17 @@ const char *CustomData_get_layer_name(const CustomData *data, int type, int n)
   return (layer_index == -1) ? NULL : data->layers[layer_index].name;
 }
 
+static void customData_set_layer_data__internal(CustomDataLayer *layer, void *ptr)
+{
+  /* The layer would own its data if it was not shared, so it takes ownership of the new data. */
+  if (layer->sharing && layer->data != ptr) {
+    customdata_layer_sharing_remove_user(layer->sharing);
+    layer->sharing = NULL;
+    layer->flag &= ~CD_FLAG_NOFREE;
+  }
+  layer->data = ptr;
+}
+
 void *CustomData_set_layer(const CustomData *data, int type, void *ptr)
 {
   /* get the layer index of the first layer of type */
@@ -3252,7 +3431,7 @@ void *CustomData_set_layer(const CustomData *data, int type, void *ptr)
     return NULL;
   }
 
-  data->layers[layer_index].data = ptr;
+  customData_set_layer_data__internal(&data->layers[layer_index], ptr);
 
   return ptr;
 }
@@ -3265,7 +3444,7 @@ void *CustomData_set_layer_n(const struct CustomData *data, int type, int n, voi
     return NULL;
   }
 
-  data->layers[layer_index].data = ptr;
+  customData_set_layer_data__internal(&data->layers[layer_index], ptr);
 
   return ptr;
 }
@@ -5174,6 +5353,7 @@ void CustomData_blend_read(BlendDataReader *reader, CustomData *data, int count)
     }
 
     layer->flag &= ~CD_FLAG_NOFREE;
+    layer->sharing = NULL;
 
     if (CustomData_verify_versions(data, i)) {
       BLO_read_data_address(reader, &layer->data);
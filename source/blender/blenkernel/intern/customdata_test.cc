@@ -0,0 +1,111 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 by Blender Foundation.
+ */
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BKE_customdata.h"
+
+#include "DNA_customdata_types.h"
+
+namespace blender::bke::tests {
+
+static const int TOTELEM = 4;
+
+static float *customdata_float_layer_add(CustomData *data)
+{
+  CustomData_reset(data);
+  float *values = (float *)CustomData_add_layer(
+      data, CD_PROP_FLOAT, CD_CALLOC, nullptr, TOTELEM);
+  for (int i = 0; i < TOTELEM; i++) {
+    values[i] = (float)i;
+  }
+  return values;
+}
+
+static float *customdata_float_layer_get(CustomData *data)
+{
+  return (float *)CustomData_get_layer(data, CD_PROP_FLOAT);
+}
+
+TEST(customdata_sharing, copy_on_write)
+{
+  const unsigned int blocks_in_use = MEM_get_memory_blocks_in_use();
+
+  CustomData a, b;
+  float *a_values = customdata_float_layer_add(&a);
+  CustomData_copy(&a, &b, CD_MASK_ALL, CD_SHARE, TOTELEM);
+  EXPECT_EQ(customdata_float_layer_get(&b), a_values);
+
+  /* Writing to a shared layer copies it first, the source is unchanged. */
+  float *b_values = (float *)CustomData_duplicate_referenced_layer(&b, CD_PROP_FLOAT, TOTELEM);
+  EXPECT_NE(b_values, a_values);
+  b_values[0] = 10.0f;
+  EXPECT_EQ(a_values[0], 0.0f);
+  EXPECT_EQ(b_values[1], 1.0f);
+
+  /* The source owns its data again and writes in place. */
+  EXPECT_EQ(CustomData_duplicate_referenced_layer(&a, CD_PROP_FLOAT, TOTELEM), a_values);
+
+  CustomData_free(&a, TOTELEM);
+  CustomData_free(&b, TOTELEM);
+  EXPECT_EQ(MEM_get_memory_blocks_in_use(), blocks_in_use);
+}
+
+TEST(customdata_sharing, free_source)
+{
+  const unsigned int blocks_in_use = MEM_get_memory_blocks_in_use();
+
+  CustomData a, b;
+  float *a_values = customdata_float_layer_add(&a);
+  CustomData_copy(&a, &b, CD_MASK_ALL, CD_SHARE, TOTELEM);
+
+  /* The data stays alive as long as one user is left. */
+  CustomData_free(&a, TOTELEM);
+  EXPECT_EQ(customdata_float_layer_get(&b), a_values);
+  EXPECT_EQ(customdata_float_layer_get(&b)[3], 3.0f);
+
+  /* The last user takes ownership without a copy. */
+  EXPECT_EQ(CustomData_duplicate_referenced_layer(&b, CD_PROP_FLOAT, TOTELEM), a_values);
+
+  CustomData_free(&b, TOTELEM);
+  EXPECT_EQ(MEM_get_memory_blocks_in_use(), blocks_in_use);
+}
+
+TEST(customdata_sharing, assign)
+{
+  const unsigned int blocks_in_use = MEM_get_memory_blocks_in_use();
+
+  CustomData a, b, c;
+  float *a_values = customdata_float_layer_add(&a);
+  CustomData_copy(&a, &b, CD_MASK_ALL, CD_SHARE, TOTELEM);
+
+  /* Assigning moves the user of b to c, freeing b afterwards must not release it again. */
+  CustomData_copy(&b, &c, CD_MASK_ALL, CD_ASSIGN, TOTELEM);
+  EXPECT_EQ(customdata_float_layer_get(&c), a_values);
+  CustomData_free(&b, TOTELEM);
+
+  CustomData_free(&a, TOTELEM);
+  EXPECT_EQ(customdata_float_layer_get(&c)[2], 2.0f);
+  EXPECT_EQ(CustomData_duplicate_referenced_layer(&c, CD_PROP_FLOAT, TOTELEM), a_values);
+
+  CustomData_free(&c, TOTELEM);
+  EXPECT_EQ(MEM_get_memory_blocks_in_use(), blocks_in_use);
+}
+
+}  // namespace blender::bke::tests
@@ -86,6 +86,15 @@ bool GeometryComponent::is_empty() const
   return false;
 }
 
+bool GeometryComponent::owns_direct_data() const
+{
+  return true;
+}
+
+void GeometryComponent::ensure_owns_direct_data()
+{
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -159,6 +168,23 @@ void GeometrySet::compute_boundbox_without_instances(float3 *r_min, float3 *r_ma
   }
 }
 
+/* Make sure that the geometry set does not reference data owned by someone else, so that it can
+ * be stored beyond the lifetime of its inputs. Shared components are copied before they are
+ * changed. */
+void GeometrySet::ensure_owns_direct_data()
+{
+  Vector<GeometryComponentType> component_types;
+  for (const GeometryComponentPtr &component_ptr : components_.values()) {
+    const GeometryComponent &component = *component_ptr.get();
+    if (!component.owns_direct_data()) {
+      component_types.append(component.type());
+    }
+  }
+  for (const GeometryComponentType component_type : component_types) {
+    this->get_component_for_write(component_type).ensure_owns_direct_data();
+  }
+}
+
 std::ostream &operator<<(std::ostream &stream, const GeometrySet &geometry_set)
 {
   stream << "<GeometrySet at " << &geometry_set << ", " << geometry_set.components_.size()
@@ -281,9 +307,15 @@ GeometryComponent *MeshComponent::copy() const
 {
   MeshComponent *new_component = new MeshComponent();
   if (mesh_ != nullptr) {
-    new_component->mesh_ = BKE_mesh_copy_for_eval(mesh_, false);
+    /* Owned meshes share their attribute layers with the copy, so that only the layers which are
+     * modified later on are copied. Read-only meshes are owned by someone else who might modify
+     * them directly, those are copied fully. */
+    new_component->mesh_ = (ownership_ == GeometryOwnershipType::Owned) ?
+                               BKE_mesh_copy_for_eval_shared(mesh_) :
+                               BKE_mesh_copy_for_eval(mesh_, false);
     new_component->ownership_ = GeometryOwnershipType::Owned;
   }
+  new_component->vertex_group_names_ = vertex_group_names_;
   return new_component;
 }
 
@@ -334,6 +366,11 @@ void MeshComponent::copy_vertex_group_names_from_object(const Object &object)
   }
 }
 
+const blender::Map<std::string, int> &MeshComponent::vertex_group_names() const
+{
+  return vertex_group_names_;
+}
+
 /* Get the mesh from this component. This method can be used by multiple threads at the same
  * time. Therefore, the returned mesh should not be modified. No ownership is transferred. */
 const Mesh *MeshComponent::get_for_read() const
@@ -342,7 +379,9 @@ const Mesh *MeshComponent::get_for_read() const
 }
 
 /* Get the mesh from this component. This method can only be used when the component is mutable,
- * i.e. it is not shared. The returned mesh can be modified. No ownership is transferred. */
+ * i.e. it is not shared. The returned mesh can be modified. No ownership is transferred.
+ * Its custom data layers might still be shared with other meshes, they have to be duplicated
+ * with #CustomData_duplicate_referenced_layer before they are modified. */
 Mesh *MeshComponent::get_for_write()
 {
   BLI_assert(this->is_mutable());
@@ -353,6 +392,20 @@ Mesh *MeshComponent::get_for_write()
   return mesh_;
 }
 
+bool MeshComponent::owns_direct_data() const
+{
+  return ownership_ == GeometryOwnershipType::Owned;
+}
+
+void MeshComponent::ensure_owns_direct_data()
+{
+  BLI_assert(this->is_mutable());
+  if (ownership_ != GeometryOwnershipType::Owned) {
+    mesh_ = BKE_mesh_copy_for_eval(mesh_, false);
+    ownership_ = GeometryOwnershipType::Owned;
+  }
+}
+
 bool MeshComponent::is_empty() const
 {
   return mesh_ == nullptr;
@@ -377,7 +430,10 @@ GeometryComponent *PointCloudComponent::copy() const
 {
   PointCloudComponent *new_component = new PointCloudComponent();
   if (pointcloud_ != nullptr) {
-    new_component->pointcloud_ = BKE_pointcloud_copy_for_eval(pointcloud_, false);
+    /* See #MeshComponent::copy. */
+    new_component->pointcloud_ = (ownership_ == GeometryOwnershipType::Owned) ?
+                                     BKE_pointcloud_copy_for_eval_shared(pointcloud_) :
+                                     BKE_pointcloud_copy_for_eval(pointcloud_, false);
     new_component->ownership_ = GeometryOwnershipType::Owned;
   }
   return new_component;
@@ -428,7 +484,7 @@ const PointCloud *PointCloudComponent::get_for_read() const
 
 /* Get the point cloud from this component. This method can only be used when the component is
  * mutable, i.e. it is not shared. The returned point cloud can be modified. No ownership is
- * transferred. */
+ * transferred. Like for meshes, custom data layers might still be shared. */
 PointCloud *PointCloudComponent::get_for_write()
 {
   BLI_assert(this->is_mutable());
@@ -439,6 +495,20 @@ PointCloud *PointCloudComponent::get_for_write()
   return pointcloud_;
 }
 
+bool PointCloudComponent::owns_direct_data() const
+{
+  return ownership_ == GeometryOwnershipType::Owned;
+}
+
+void PointCloudComponent::ensure_owns_direct_data()
+{
+  BLI_assert(this->is_mutable());
+  if (ownership_ != GeometryOwnershipType::Owned) {
+    pointcloud_ = BKE_pointcloud_copy_for_eval(pointcloud_, false);
+    ownership_ = GeometryOwnershipType::Owned;
+  }
+}
+
 bool PointCloudComponent::is_empty() const
 {
   return pointcloud_ == nullptr;
@@ -634,6 +634,7 @@ bool BKE_image_scale(Image *image, int width, int height)
   ibuf = BKE_image_acquire_ibuf(image, NULL, &lock);
 
   if (ibuf) {
+    ibuf = BKE_image_ibuf_ensure_writable(image, ibuf);
     IMB_scaleImBuf(ibuf, width, height);
     BKE_image_mark_dirty(image, ibuf);
   }
@@ -3451,6 +3452,24 @@ static void image_free_tile(Image *ima, ImageTile *tile)
   }
 }
 
+/* Make sure reloading decodes the files again, even when they look unchanged on disk. */
+static void image_remove_shared_buffers(Image *ima)
+{
+  if (ima->cache == NULL) {
+    return;
+  }
+
+  struct MovieCacheIter *iter = IMB_moviecacheIter_new(ima->cache);
+  while (!IMB_moviecacheIter_done(iter)) {
+    ImBuf *ibuf = IMB_moviecacheIter_getImBuf(iter);
+    if (ibuf) {
+      IMB_shared_cache_remove_ibuf(ibuf);
+    }
+    IMB_moviecacheIter_step(iter);
+  }
+  IMB_moviecacheIter_free(iter);
+}
+
 void BKE_image_signal(Main *bmain, Image *ima, ImageUser *iuser, int signal)
 {
   if (ima == NULL) {
@@ -3560,6 +3579,7 @@ void BKE_image_signal(Main *bmain, Image *ima, ImageUser *iuser, int signal)
         }
       }
       else {
+        image_remove_shared_buffers(ima);
         BKE_image_free_buffers(ima);
       }
 
@@ -4004,7 +4024,10 @@ static void image_create_multilayer(Image *ima, ImBuf *ibuf, int framenr)
     ima->rr = RE_MultilayerConvert(ibuf->userdata, colorspace, predivide, ibuf->x, ibuf->y);
   }
 
-  IMB_exr_close(ibuf->userdata);
+  /* Lazily loaded files stay open in the render result to read passes on first access. */
+  if (ima->rr == NULL || ima->rr->exrhandle != ibuf->userdata) {
+    IMB_exr_close(ibuf->userdata);
+  }
 
   ibuf->userdata = NULL;
   if (ima->rr != NULL) {
@@ -4092,11 +4115,11 @@ static ImBuf *load_sequence_single(
   iuser_t.view = view_id;
   BKE_image_user_file_path(&iuser_t, ima, name);
 
-  flag = IB_rect | IB_multilayer | IB_metadata;
+  flag = IB_rect | IB_multilayer | IB_multilayer_lazy | IB_metadata;
   flag |= imbuf_alpha_flags_for_image(ima);
 
   /* read ibuf */
-  ibuf = IMB_loadiffname(name, flag, ima->colorspace_settings.name);
+  ibuf = IMB_loadiffname_shared(name, flag, ima->colorspace_settings.name);
 
 #if 0
   if (ibuf) {
@@ -4217,7 +4240,7 @@ static ImBuf *image_load_sequence_multilayer(Image *ima, ImageUser *iuser, int e
   if (ima->rr) {
     RenderPass *rpass = BKE_image_multilayer_index(ima->rr, iuser);
 
-    if (rpass) {
+    if (rpass && RE_RenderPassEnsureLoaded(ima->rr, rpass)) {
       // printf("load from pass %s\n", rpass->name);
       /* since we free  render results, we copy the rect */
       ibuf = IMB_allocImBuf(ima->rr->rectx, ima->rr->recty, 32, 0);
@@ -4400,7 +4423,7 @@ static ImBuf *load_image_single(Image *ima,
   else {
     ImageUser iuser_t;
 
-    flag = IB_rect | IB_multilayer | IB_metadata;
+    flag = IB_rect | IB_multilayer | IB_multilayer_lazy | IB_metadata;
     flag |= imbuf_alpha_flags_for_image(ima);
 
     /* get the correct filepath */
@@ -4418,7 +4441,7 @@ static ImBuf *load_image_single(Image *ima,
     BKE_image_user_file_path(&iuser_t, ima, filepath);
 
     /* read ibuf */
-    ibuf = IMB_loadiffname(filepath, flag, ima->colorspace_settings.name);
+    ibuf = IMB_loadiffname_shared(filepath, flag, ima->colorspace_settings.name);
   }
 
   if (ibuf) {
@@ -4546,7 +4569,7 @@ static ImBuf *image_get_ibuf_multilayer(Image *ima, ImageUser *iuser)
   if (ima->rr) {
     RenderPass *rpass = BKE_image_multilayer_index(ima->rr, iuser);
 
-    if (rpass) {
+    if (rpass && RE_RenderPassEnsureLoaded(ima->rr, rpass)) {
       ibuf = IMB_allocImBuf(ima->rr->rectx, ima->rr->recty, 32, 0);
 
       image_init_after_load(ima, iuser, ibuf);
@@ -5639,9 +5662,66 @@ bool BKE_image_is_dirty(Image *image)
 
 void BKE_image_mark_dirty(Image *UNUSED(image), ImBuf *ibuf)
 {
+  /* Shared buffers must be replaced with #BKE_image_ibuf_ensure_writable before editing. */
+  BLI_assert((ibuf->userflags & IB_SHARED) == 0);
   ibuf->userflags |= IB_BITMAPDIRTY;
 }
 
+/**
+ * Make sure a buffer acquired from the image can be modified in place.
+ *
+ * Buffers loaded from files may be shared with other images and sequencer strips which load the
+ * same file. Those are replaced in the image cache by a private copy, which is returned and takes
+ * over the reference of the passed buffer. Must be called before the first modification by every
+ * code which edits pixels in place, and the returned buffer used from then on.
+ */
+ImBuf *BKE_image_ibuf_ensure_writable(Image *ima, ImBuf *ibuf)
+{
+  if (ibuf == NULL || (ibuf->userflags & IB_SHARED) == 0) {
+    return ibuf;
+  }
+
+  BLI_mutex_lock(image_mutex);
+
+  ImBuf *ibuf_copy = NULL;
+  if (ima->cache != NULL) {
+    struct MovieCacheIter *iter = IMB_moviecacheIter_new(ima->cache);
+    int index = -1;
+
+    while (!IMB_moviecacheIter_done(iter)) {
+      if (IMB_moviecacheIter_getImBuf(iter) == ibuf) {
+        const ImageCacheKey *key = IMB_moviecacheIter_getUserKey(iter);
+        index = key->index;
+        break;
+      }
+      IMB_moviecacheIter_step(iter);
+    }
+    IMB_moviecacheIter_free(iter);
+
+    if (index != -1) {
+      ibuf_copy = IMB_dupImBuf(ibuf);
+      IMB_metadata_copy(ibuf_copy, ibuf);
+      /* The cache holds one reference, the caller the other. */
+      imagecache_put(ima, index, ibuf_copy);
+    }
+  }
+
+  if (ibuf_copy == NULL) {
+    /* Not in the cache, only the caller sees the copy. */
+    ibuf_copy = IMB_dupImBuf(ibuf);
+    IMB_metadata_copy(ibuf_copy, ibuf);
+  }
+  else {
+    IMB_refImBuf(ibuf_copy);
+  }
+
+  BLI_mutex_unlock(image_mutex);
+
+  IMB_freeImBuf(ibuf);
+
+  return ibuf_copy;
+}
+
 bool BKE_image_buffer_format_writable(ImBuf *ibuf)
 {
   ImageFormatData im_format;
@@ -0,0 +1,126 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 by Blender Foundation.
+ */
+#include "testing/testing.h"
+
+#include "BKE_appdir.h"
+#include "BKE_idtype.h"
+#include "BKE_image.h"
+#include "BKE_main.h"
+
+#include "BLI_fileops.h"
+#include "BLI_path_util.h"
+
+#include "DNA_image_types.h"
+
+#include "IMB_imbuf.h"
+#include "IMB_imbuf_types.h"
+
+#include "CLG_log.h"
+
+namespace blender::bke::tests {
+
+class ImageSharedBufferTest : public testing::Test {
+ protected:
+  Main *bmain = nullptr;
+  char filepath[FILE_MAX];
+
+  static void SetUpTestCase()
+  {
+    CLG_init();
+    BKE_idtype_init();
+    BKE_appdir_init();
+    BKE_tempdir_init(nullptr);
+    IMB_init();
+    BKE_images_init();
+  }
+
+  static void TearDownTestCase()
+  {
+    BKE_images_exit();
+    IMB_exit();
+    BKE_tempdir_session_purge();
+    CLG_exit();
+  }
+
+  void SetUp() override
+  {
+    BLI_join_dirfile(filepath, sizeof(filepath), BKE_tempdir_session(), "image_shared_test.png");
+
+    /* A small file with every pixel set to the same color. */
+    ImBuf *ibuf = IMB_allocImBuf(4, 4, 32, IB_rect);
+    const float color[4] = {0.25f, 0.5f, 0.75f, 1.0f};
+    IMB_rectfill(ibuf, color);
+    ibuf->ftype = IMB_FTYPE_PNG;
+    ASSERT_TRUE(IMB_saveiff(ibuf, filepath, IB_rect));
+    IMB_freeImBuf(ibuf);
+
+    bmain = BKE_main_new();
+  }
+
+  void TearDown() override
+  {
+    BKE_main_free(bmain);
+    BLI_delete(filepath, false, false);
+  }
+};
+
+TEST_F(ImageSharedBufferTest, edits_stay_private)
+{
+  Image *ima_a = BKE_image_load(bmain, filepath);
+  Image *ima_b = BKE_image_load(bmain, filepath);
+  ASSERT_NE(ima_a, nullptr);
+  ASSERT_NE(ima_b, nullptr);
+
+  ImBuf *ibuf_a = BKE_image_acquire_ibuf(ima_a, nullptr, nullptr);
+  ImBuf *ibuf_b = BKE_image_acquire_ibuf(ima_b, nullptr, nullptr);
+  ASSERT_NE(ibuf_a, nullptr);
+  ASSERT_NE(ibuf_b, nullptr);
+
+  /* Both images decode the file once. */
+  EXPECT_EQ(ibuf_a, ibuf_b);
+  EXPECT_TRUE(ibuf_a->userflags & IB_SHARED);
+  const unsigned int original = ibuf_b->rect[0];
+
+  ibuf_a = BKE_image_ibuf_ensure_writable(ima_a, ibuf_a);
+  EXPECT_NE(ibuf_a, ibuf_b);
+  EXPECT_FALSE(ibuf_a->userflags & IB_SHARED);
+  EXPECT_EQ(ibuf_a->rect[0], original);
+
+  ibuf_a->rect[0] = ~original;
+  BKE_image_mark_dirty(ima_a, ibuf_a);
+
+  BKE_image_release_ibuf(ima_a, ibuf_a, nullptr);
+  BKE_image_release_ibuf(ima_b, ibuf_b, nullptr);
+
+  /* The edited copy replaced the shared buffer in the cache of the first image only. */
+  ibuf_a = BKE_image_acquire_ibuf(ima_a, nullptr, nullptr);
+  ibuf_b = BKE_image_acquire_ibuf(ima_b, nullptr, nullptr);
+  EXPECT_NE(ibuf_a, ibuf_b);
+  EXPECT_EQ(ibuf_a->rect[0], ~original);
+  EXPECT_EQ(ibuf_b->rect[0], original);
+  EXPECT_TRUE(BKE_image_is_dirty(ima_a));
+  EXPECT_FALSE(BKE_image_is_dirty(ima_b));
+
+  /* Writable buffers are returned as they are. */
+  EXPECT_EQ(BKE_image_ibuf_ensure_writable(ima_a, ibuf_a), ibuf_a);
+
+  BKE_image_release_ibuf(ima_a, ibuf_a, nullptr);
+  BKE_image_release_ibuf(ima_b, ibuf_b, nullptr);
+}
+
+}  // namespace blender::bke::tests
@@ -125,7 +125,9 @@ static void mesh_copy_data(Main *bmain, ID *id_dst, const ID *id_src, const int
 
   mesh_dst->mat = MEM_dupallocN(mesh_src->mat);
 
-  const eCDAllocType alloc_type = (flag & LIB_ID_COPY_CD_REFERENCE) ? CD_REFERENCE : CD_DUPLICATE;
+  const eCDAllocType alloc_type = (flag & LIB_ID_COPY_CD_REFERENCE) ?
+                                      CD_REFERENCE :
+                                      (flag & LIB_ID_COPY_CD_SHARE) ? CD_SHARE : CD_DUPLICATE;
   CustomData_copy(&mesh_src->vdata, &mesh_dst->vdata, mask.vmask, alloc_type, mesh_dst->totvert);
   CustomData_copy(&mesh_src->edata, &mesh_dst->edata, mask.emask, alloc_type, mesh_dst->totedge);
   CustomData_copy(&mesh_src->ldata, &mesh_dst->ldata, mask.lmask, alloc_type, mesh_dst->totloop);
@@ -974,6 +976,18 @@ Mesh *BKE_mesh_copy_for_eval(struct Mesh *source, bool reference)
   return result;
 }
 
+/**
+ * Copy a mesh that shares its custom data layers with the source. Layers have to be duplicated
+ * with #CustomData_duplicate_referenced_layer before they are modified, like referenced layers.
+ * Unlike referenced layers, the copy stays valid after the source is freed.
+ */
+Mesh *BKE_mesh_copy_for_eval_shared(const Mesh *source)
+{
+  const int flags = LIB_ID_COPY_LOCALIZE | LIB_ID_COPY_CD_SHARE;
+  Mesh *result = (Mesh *)BKE_id_copy_ex(NULL, &source->id, NULL, flags);
+  return result;
+}
+
 BMesh *BKE_mesh_to_bmesh_ex(const Mesh *me,
                             const struct BMeshCreateParams *create_params,
                             const struct BMeshFromMeshParams *convert_params)
@@ -106,6 +106,11 @@ typedef struct MultiresReshapeContext {
   /* Indexed by base face index, returns first ptex face index corresponding
    * to that base face. */
   int *face_ptex_offset;
+
+  /* Indexed by grid index, denotes grids which are to be converted to tangent displacement.
+   * NULL means all grids are converted. Used to only reshape grids which were modified since the
+   * previous reshape from SubdivCCG. */
+  bool *grid_needs_reshape;
 } MultiresReshapeContext;
 
 /**
@@ -267,8 +272,12 @@ bool multires_reshape_assign_final_coords_from_vertcos(
  *
  * NOTE: Displacement grids to be at least at a reshape level.
  *
+ * When reshaping at the top level, grids which did not change since the previous reshape from
+ * the same SubdivCCG are skipped and marked in `grid_needs_reshape`, so that the following
+ * conversion to tangent displacement skips them as well.
+ *
  * Return truth if all coordinates have been updated. */
-bool multires_reshape_assign_final_coords_from_ccg(const MultiresReshapeContext *reshape_context,
+bool multires_reshape_assign_final_coords_from_ccg(MultiresReshapeContext *reshape_context,
                                                    struct SubdivCCG *subdiv_ccg);
 
 /* --------------------------------------------------------------------
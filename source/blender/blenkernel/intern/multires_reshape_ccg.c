@@ -25,48 +25,121 @@
 
 #include <string.h>
 
+#include "MEM_guardedalloc.h"
+
+#include "BLI_hash_mm2a.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "BKE_ccg.h"
 #include "BKE_subdiv_ccg.h"
 
-bool multires_reshape_assign_final_coords_from_ccg(const MultiresReshapeContext *reshape_context,
-                                                   struct SubdivCCG *subdiv_ccg)
-{
+typedef struct AssignFinalCoordsFromCCGData {
+  const MultiresReshapeContext *reshape_context;
+  SubdivCCG *subdiv_ccg;
   CCGKey reshape_level_key;
-  BKE_subdiv_ccg_key(&reshape_level_key, subdiv_ccg, reshape_context->reshape.level);
+  /* Hashes of grids at the previous reshape, NULL when all grids are to be reshaped. */
+  const uint64_t *prev_grid_hashes;
+  uint64_t *grid_hashes;
+} AssignFinalCoordsFromCCGData;
+
+static uint64_t ccg_grid_hash(const CCGKey *key, const CCGElem *grid)
+{
+  const unsigned char *data = (const unsigned char *)grid;
+  const size_t size = (size_t)key->grid_area * key->elem_size;
+  return ((uint64_t)BLI_hash_mm2(data, size, 0) << 32) | BLI_hash_mm2(data, size, 1);
+}
+
+static void assign_final_coords_from_ccg_task(void *__restrict userdata_v,
+                                              const int grid_index,
+                                              const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  AssignFinalCoordsFromCCGData *data = userdata_v;
+  const MultiresReshapeContext *reshape_context = data->reshape_context;
+  const CCGKey *reshape_level_key = &data->reshape_level_key;
+  CCGElem *ccg_grid = data->subdiv_ccg->grids[grid_index];
+
+  if (data->grid_hashes != NULL) {
+    const uint64_t grid_hash = ccg_grid_hash(reshape_level_key, ccg_grid);
+    data->grid_hashes[grid_index] = grid_hash;
+    if (data->prev_grid_hashes != NULL && data->prev_grid_hashes[grid_index] == grid_hash) {
+      /* Displacement of this grid is still up to date from the previous reshape. */
+      reshape_context->grid_needs_reshape[grid_index] = false;
+      return;
+    }
+    reshape_context->grid_needs_reshape[grid_index] = true;
+  }
 
   const int reshape_grid_size = reshape_context->reshape.grid_size;
   const float reshape_grid_size_1_inv = 1.0f / (((float)reshape_grid_size) - 1.0f);
 
-  int num_grids = subdiv_ccg->num_grids;
-  for (int grid_index = 0; grid_index < num_grids; ++grid_index) {
-    CCGElem *ccg_grid = subdiv_ccg->grids[grid_index];
-    for (int y = 0; y < reshape_grid_size; ++y) {
-      const float v = (float)y * reshape_grid_size_1_inv;
-      for (int x = 0; x < reshape_grid_size; ++x) {
-        const float u = (float)x * reshape_grid_size_1_inv;
-
-        GridCoord grid_coord;
-        grid_coord.grid_index = grid_index;
-        grid_coord.u = u;
-        grid_coord.v = v;
-
-        ReshapeGridElement grid_element = multires_reshape_grid_element_for_grid_coord(
-            reshape_context, &grid_coord);
-
-        BLI_assert(grid_element.displacement != NULL);
-        memcpy(grid_element.displacement,
-               CCG_grid_elem_co(&reshape_level_key, ccg_grid, x, y),
-               sizeof(float[3]));
-
-        if (reshape_level_key.has_mask) {
-          BLI_assert(grid_element.mask != NULL);
-          *grid_element.mask = *CCG_grid_elem_mask(&reshape_level_key, ccg_grid, x, y);
-        }
+  for (int y = 0; y < reshape_grid_size; ++y) {
+    const float v = (float)y * reshape_grid_size_1_inv;
+    for (int x = 0; x < reshape_grid_size; ++x) {
+      const float u = (float)x * reshape_grid_size_1_inv;
+
+      GridCoord grid_coord;
+      grid_coord.grid_index = grid_index;
+      grid_coord.u = u;
+      grid_coord.v = v;
+
+      ReshapeGridElement grid_element = multires_reshape_grid_element_for_grid_coord(
+          reshape_context, &grid_coord);
+
+      BLI_assert(grid_element.displacement != NULL);
+      memcpy(grid_element.displacement,
+             CCG_grid_elem_co(reshape_level_key, ccg_grid, x, y),
+             sizeof(float[3]));
+
+      if (reshape_level_key->has_mask) {
+        BLI_assert(grid_element.mask != NULL);
+        *grid_element.mask = *CCG_grid_elem_mask(reshape_level_key, ccg_grid, x, y);
       }
     }
   }
+}
+
+/* Grids which did not change since the previous reshape can be skipped when the whole grid is
+ * reshaped at the top level: there is no propagation to higher levels which would need all the
+ * grids, and the grid elements are stored contiguously so they can be hashed directly. */
+static bool can_reshape_modified_grids_only(const MultiresReshapeContext *reshape_context,
+                                            const SubdivCCG *subdiv_ccg)
+{
+  return reshape_context->reshape.level == reshape_context->top.level &&
+         reshape_context->reshape.level == subdiv_ccg->level &&
+         reshape_context->num_grids == subdiv_ccg->num_grids;
+}
+
+bool multires_reshape_assign_final_coords_from_ccg(MultiresReshapeContext *reshape_context,
+                                                   struct SubdivCCG *subdiv_ccg)
+{
+  AssignFinalCoordsFromCCGData data = {
+      .reshape_context = reshape_context,
+      .subdiv_ccg = subdiv_ccg,
+  };
+  BKE_subdiv_ccg_key(&data.reshape_level_key, subdiv_ccg, reshape_context->reshape.level);
+
+  const int num_grids = subdiv_ccg->num_grids;
+  if (can_reshape_modified_grids_only(reshape_context, subdiv_ccg)) {
+    data.prev_grid_hashes = subdiv_ccg->dirty.reshape_grid_hashes;
+    data.grid_hashes = MEM_malloc_arrayN(num_grids, sizeof(uint64_t), "reshape grid hashes");
+    reshape_context->grid_needs_reshape = MEM_malloc_arrayN(
+        num_grids, sizeof(bool), "reshape grid needs reshape");
+  }
+  else {
+    MEM_SAFE_FREE(subdiv_ccg->dirty.reshape_grid_hashes);
+  }
+
+  TaskParallelSettings parallel_range_settings;
+  BLI_parallel_range_settings_defaults(&parallel_range_settings);
+  parallel_range_settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(
+      0, num_grids, &data, assign_final_coords_from_ccg_task, &parallel_range_settings);
+
+  if (data.grid_hashes != NULL) {
+    MEM_SAFE_FREE(subdiv_ccg->dirty.reshape_grid_hashes);
+    subdiv_ccg->dirty.reshape_grid_hashes = data.grid_hashes;
+  }
 
   return true;
 }
@@ -324,6 +324,7 @@ void multires_reshape_context_free(MultiresReshapeContext *reshape_context)
   MEM_SAFE_FREE(reshape_context->face_start_grid_index);
   MEM_SAFE_FREE(reshape_context->ptex_start_grid_index);
   MEM_SAFE_FREE(reshape_context->grid_to_face_index);
+  MEM_SAFE_FREE(reshape_context->grid_needs_reshape);
 }
 
 /** \} */
@@ -663,6 +664,10 @@ static void foreach_grid_face_coordinate_task(void *__restrict userdata_v,
   const int num_corners = mpoly[face_index].totloop;
   int grid_index = reshape_context->face_start_grid_index[face_index];
   for (int corner = 0; corner < num_corners; ++corner, ++grid_index) {
+    if (reshape_context->grid_needs_reshape != NULL &&
+        !reshape_context->grid_needs_reshape[grid_index]) {
+      continue;
+    }
     for (int y = 0; y < grid_size; ++y) {
       const float v = (float)y * grid_size_1_inv;
       for (int x = 0; x < grid_size; ++x) {
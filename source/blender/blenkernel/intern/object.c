@@ -1561,6 +1561,8 @@ void BKE_object_free_derived_caches(Object *ob)
 
   object_update_from_subsurf_ccg(ob);
 
+  ob->runtime.is_batch_cache_deform_only = false;
+
   if (ob->runtime.data_eval != NULL) {
     if (ob->runtime.is_data_eval_owned) {
       ID *data_eval = ob->runtime.data_eval;
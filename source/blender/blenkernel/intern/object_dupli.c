@@ -155,13 +155,15 @@ static void copy_dupli_context(
  *
  * \param mat: is transform of the object relative to current context (including #Object.obmat).
  */
+static void dupli_object_init(
+    const DupliContext *ctx, DupliObject *dob, Object *ob, const float mat[4][4], int index);
+
 static DupliObject *make_dupli(const DupliContext *ctx,
                                Object *ob,
                                const float mat[4][4],
                                int index)
 {
   DupliObject *dob;
-  int i;
 
   /* Add a #DupliObject instance to the result container. */
   if (ctx->duplilist) {
@@ -172,6 +174,18 @@ static DupliObject *make_dupli(const DupliContext *ctx,
     return NULL;
   }
 
+  dupli_object_init(ctx, dob, ob, mat, index);
+  return dob;
+}
+
+/**
+ * Fill in a zero initialized #DupliObject.
+ */
+static void dupli_object_init(
+    const DupliContext *ctx, DupliObject *dob, Object *ob, const float mat[4][4], int index)
+{
+  int i;
+
   dob->ob = ob;
   mul_m4_m4m4(dob->mat, (float(*)[4])ctx->space_mat, mat);
   dob->type = ctx->gen->type;
@@ -212,8 +226,6 @@ static DupliObject *make_dupli(const DupliContext *ctx,
   if (ctx->object != ob) {
     dob->random_id ^= BLI_hash_int(BLI_hash_string(ctx->object->id.name + 2));
   }
-
-  return dob;
 }
 
 /**
@@ -811,6 +823,21 @@ static const DupliGenerator gen_dupli_verts_pointcloud = {
 /** \name Instances Geometry Component Implementation
  * \{ */
 
+static void instances_component_matrix(const DupliContext *ctx,
+                                       const float position[3],
+                                       const float rotation[3],
+                                       const float scale[3],
+                                       float r_matrix[4][4])
+{
+  float scale_matrix[4][4];
+  size_to_mat4(scale_matrix, scale);
+  float rotation_matrix[4][4];
+  eul_to_mat4(rotation_matrix, rotation);
+  mul_m4_m4m4(r_matrix, rotation_matrix, scale_matrix);
+  copy_v3_v3(r_matrix[3], position);
+  mul_m4_m4_pre(r_matrix, ctx->object->obmat);
+}
+
 static void make_duplis_instances_component(const DupliContext *ctx)
 {
   float(*positions)[3];
@@ -825,14 +852,8 @@ static void make_duplis_instances_component(const DupliContext *ctx)
     if (object == NULL) {
       continue;
     }
-    float scale_matrix[4][4];
-    size_to_mat4(scale_matrix, scales[i]);
-    float rotation_matrix[4][4];
-    eul_to_mat4(rotation_matrix, rotations[i]);
     float matrix[4][4];
-    mul_m4_m4m4(matrix, rotation_matrix, scale_matrix);
-    copy_v3_v3(matrix[3], positions[i]);
-    mul_m4_m4_pre(matrix, ctx->object->obmat);
+    instances_component_matrix(ctx, positions[i], rotations[i], scales[i], matrix);
 
     make_dupli(ctx, object, matrix, i);
     make_recursive_duplis(ctx, object, matrix, i);
@@ -1584,3 +1605,121 @@ void free_object_duplilist(ListBase *lb)
 }
 
 /** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Dupli-Stream
+ *
+ * Instances of geometry sets can be iterated without building a dupli-list. The dupli objects
+ * are filled in batches into a buffer owned by the stream, instead of allocating one per
+ * instance. Objects which instance something themselves need the recursion of the dupli-list.
+ * \{ */
+
+#define DUPLI_STREAM_BATCH_SIZE 256
+
+typedef struct DupliStream {
+  DupliContext ctx;
+
+  float (*positions)[3];
+  float (*rotations)[3];
+  float (*scales)[3];
+  Object **objects;
+  int amount;
+  /** Next instance to add to the batch. */
+  int instance_next;
+
+  DupliObject batch[DUPLI_STREAM_BATCH_SIZE];
+  int batch_len;
+  int batch_next;
+} DupliStream;
+
+static bool dupli_stream_object_is_leaf(const Object *ob)
+{
+  return (ob->transflag & OB_DUPLI) == 0 && ob->runtime.geometry_set_eval == NULL;
+}
+
+/**
+ * Start streaming the instances of \a ob.
+ *
+ * \return NULL when the instances can't be streamed, #object_duplilist has to be used then.
+ */
+DupliStream *object_dupli_stream_begin(Depsgraph *depsgraph, Scene *sce, Object *ob)
+{
+  DupliContext ctx;
+  init_context(&ctx, depsgraph, sce, ob, NULL);
+  if (ctx.gen != &gen_dupli_instances_component) {
+    return NULL;
+  }
+
+  float(*positions)[3];
+  float(*rotations)[3];
+  float(*scales)[3];
+  Object **objects;
+  const int amount = BKE_geometry_set_instances(
+      ob->runtime.geometry_set_eval, &positions, &rotations, &scales, &objects);
+
+  const Object *last_checked = NULL;
+  for (int i = 0; i < amount; i++) {
+    Object *object = objects[i];
+    if (object == NULL || object == last_checked) {
+      continue;
+    }
+    if (!dupli_stream_object_is_leaf(object)) {
+      return NULL;
+    }
+    last_checked = object;
+  }
+
+  DupliStream *stream = MEM_mallocN(sizeof(DupliStream), __func__);
+  stream->ctx = ctx;
+  stream->positions = positions;
+  stream->rotations = rotations;
+  stream->scales = scales;
+  stream->objects = objects;
+  stream->amount = amount;
+  stream->instance_next = 0;
+  stream->batch_len = 0;
+  stream->batch_next = 0;
+  return stream;
+}
+
+static void dupli_stream_fill_batch(DupliStream *stream)
+{
+  stream->batch_len = 0;
+  stream->batch_next = 0;
+  while (stream->batch_len < DUPLI_STREAM_BATCH_SIZE && stream->instance_next < stream->amount) {
+    const int i = stream->instance_next++;
+    Object *object = stream->objects[i];
+    if (object == NULL) {
+      continue;
+    }
+    float matrix[4][4];
+    instances_component_matrix(
+        &stream->ctx, stream->positions[i], stream->rotations[i], stream->scales[i], matrix);
+
+    DupliObject *dob = &stream->batch[stream->batch_len++];
+    memset(dob, 0, sizeof(*dob));
+    dupli_object_init(&stream->ctx, dob, object, matrix, i);
+  }
+}
+
+/**
+ * \return The next dupli object, or NULL when all instances have been streamed.
+ * The returned object is only valid until the next call.
+ */
+DupliObject *object_dupli_stream_next(DupliStream *stream)
+{
+  if (stream->batch_next == stream->batch_len) {
+    dupli_stream_fill_batch(stream);
+    if (stream->batch_len == 0) {
+      return NULL;
+    }
+  }
+  return &stream->batch[stream->batch_next++];
+}
+
+void object_dupli_stream_end(DupliStream *stream)
+{
+  MEM_freeN(stream);
+}
+
+/** \} */
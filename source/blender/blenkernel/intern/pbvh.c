@@ -173,7 +173,8 @@ static bool grid_materials_match(const DMFlagMat *f1, const DMFlagMat *f2)
 
 /* Adapted from BLI_kdopbvh.c */
 /* Returns the index of the first element on the right of the partition */
-static int partition_indices(int *prim_indices, int lo, int hi, int axis, float mid, BBC *prim_bbc)
+static int partition_indices(
+    int *prim_indices, int lo, int hi, int axis, float mid, const BBC *prim_bbc)
 {
   int i = lo, j = hi;
   for (;;) {
@@ -252,16 +253,19 @@ void pbvh_grow_nodes(PBVH *pbvh, int totnode)
 
 /* Add a vertex to the map, with a positive value for unique vertices and
  * a negative value for additional vertices */
-static int map_insert_vert(
-    PBVH *pbvh, GHash *map, unsigned int *face_verts, unsigned int *uniq_verts, int vertex)
+static int map_insert_vert(PBVH *pbvh,
+                           GHash *map,
+                           unsigned int *face_verts,
+                           unsigned int *uniq_verts,
+                           int vertex,
+                           int leaf_index)
 {
   void *key, **value_p;
 
   key = POINTER_FROM_INT(vertex);
   if (!BLI_ghash_ensure_p(map, key, &value_p)) {
     int value_i;
-    if (BLI_BITMAP_TEST(pbvh->vert_bitmap, vertex) == 0) {
-      BLI_BITMAP_ENABLE(pbvh->vert_bitmap, vertex);
+    if (pbvh->vert_owner[vertex] == leaf_index) {
       value_i = *uniq_verts;
       (*uniq_verts)++;
     }
@@ -276,8 +280,9 @@ static int map_insert_vert(
   return POINTER_AS_INT(*value_p);
 }
 
-/* Find vertices used by the faces in this node and update the draw buffers */
-static void build_mesh_leaf_node(PBVH *pbvh, PBVHNode *node)
+/* Find vertices used by the faces in this node and update the draw buffers.
+ * Vertices are unique to the node when it is their owner, see #PBVH.vert_owner. */
+static void build_mesh_leaf_node(PBVH *pbvh, PBVHNode *node, int leaf_index)
 {
   bool has_visible = false;
 
@@ -298,8 +303,12 @@ static void build_mesh_leaf_node(PBVH *pbvh, PBVHNode *node)
   for (int i = 0; i < totface; i++) {
     const MLoopTri *lt = &pbvh->looptri[node->prim_indices[i]];
     for (int j = 0; j < 3; j++) {
-      face_vert_indices[i][j] = map_insert_vert(
-          pbvh, map, &node->face_verts, &node->uniq_verts, pbvh->mloop[lt->tri[j]].v);
+      face_vert_indices[i][j] = map_insert_vert(pbvh,
+                                                map,
+                                                &node->face_verts,
+                                                &node->uniq_verts,
+                                                pbvh->mloop[lt->tri[j]].v,
+                                                leaf_index);
     }
 
     if (has_visible == false) {
@@ -343,15 +352,6 @@ static void build_mesh_leaf_node(PBVH *pbvh, PBVHNode *node)
   BLI_ghash_free(map, NULL, NULL);
 }
 
-static void update_vb(PBVH *pbvh, PBVHNode *node, BBC *prim_bbc, int offset, int count)
-{
-  BB_reset(&node->vb);
-  for (int i = offset + count - 1; i >= offset; i--) {
-    BB_expand_with_bb(&node->vb, (BB *)(&prim_bbc[pbvh->prim_indices[i]]));
-  }
-  node->orig_vb = node->vb;
-}
-
 /* Returns the number of visible quads in the nodes' grids. */
 int BKE_pbvh_count_grid_quads(BLI_bitmap **grid_hidden,
                               const int *grid_indices,
@@ -413,24 +413,6 @@ static void build_grid_leaf_node(PBVH *pbvh, PBVHNode *node)
   BKE_pbvh_node_mark_rebuild_draw(node);
 }
 
-static void build_leaf(PBVH *pbvh, int node_index, BBC *prim_bbc, int offset, int count)
-{
-  pbvh->nodes[node_index].flag |= PBVH_Leaf;
-
-  pbvh->nodes[node_index].prim_indices = pbvh->prim_indices + offset;
-  pbvh->nodes[node_index].totprim = count;
-
-  /* Still need vb for searches */
-  update_vb(pbvh, &pbvh->nodes[node_index], prim_bbc, offset, count);
-
-  if (pbvh->looptri) {
-    build_mesh_leaf_node(pbvh, pbvh->nodes + node_index);
-  }
-  else {
-    build_grid_leaf_node(pbvh, pbvh->nodes + node_index);
-  }
-}
-
 /* Return zero if all primitives in the node can be drawn with the
  * same material (including flat/smooth shading), non-zero otherwise */
 static bool leaf_needs_material_split(PBVH *pbvh, int offset, int count)
@@ -465,56 +447,361 @@ static bool leaf_needs_material_split(PBVH *pbvh, int offset, int count)
   return false;
 }
 
-/* Recursively build a node in the tree
- *
- * vb is the voxel box around all of the primitives contained in
- * this node.
- *
- * cb is the bounding box around all the centroids of the primitives
- * contained in this node
+/* -------------------------------------------------------------------- */
+/** \name Parallel Build
  *
- * offset and start indicate a range in the array of primitive indices
- */
+ * The hierarchy is built into a temporary tree first, subtrees are built by separate tasks.
+ * Nodes are split with a binned surface area heuristic along the widest axis of the primitive
+ * centroids, or by material once they are below the leaf limit. Bounds, bins and the partition
+ * of large nodes are computed in parallel as well. The tree is then laid out in
+ * #PBVH.nodes in the same depth first order as a recursive build, and leaves are built in
+ * parallel.
+ * \{ */
+
+#define PBVH_SAH_BINS 16
+/* Nodes with fewer primitives than this many leaves are processed on a single thread. */
+#define PBVH_BUILD_PARALLEL_LEAVES 10
+/* Subtrees with fewer primitives than this many leaves are built by the task of their parent. */
+#define PBVH_BUILD_TASK_LEAVES 2
+
+typedef struct PBVHBuildNode {
+  struct PBVHBuildNode *children[2];
+  /* Range in #PBVH.prim_indices. */
+  int offset, count;
+  /* Bounds of the primitives. */
+  BB vb;
+  bool is_leaf;
+} PBVHBuildNode;
+
+typedef struct PBVHBuildData {
+  PBVH *pbvh;
+  const BBC *prim_bbc;
+  TaskPool *pool;
+} PBVHBuildData;
+
+static float BB_half_area(const BB *bb)
+{
+  float dim[3];
+  sub_v3_v3v3(dim, bb->bmax, bb->bmin);
+  if (dim[0] < 0.0f || dim[1] < 0.0f || dim[2] < 0.0f) {
+    return 0.0f;
+  }
+  return dim[0] * dim[1] + dim[1] * dim[2] + dim[2] * dim[0];
+}
+
+typedef struct PBVHBuildBoundsData {
+  const PBVH *pbvh;
+  const BBC *prim_bbc;
+  int offset;
+} PBVHBuildBoundsData;
+
+typedef struct PBVHBuildBoundsTLS {
+  BB vb;
+  BB cb;
+} PBVHBuildBoundsTLS;
+
+static void build_bounds_cb(void *__restrict userdata,
+                            const int i,
+                            const TaskParallelTLS *__restrict tls)
+{
+  const PBVHBuildBoundsData *data = userdata;
+  PBVHBuildBoundsTLS *bounds = tls->userdata_chunk;
+  const BBC *bbc = &data->prim_bbc[data->pbvh->prim_indices[data->offset + i]];
+
+  BB_expand_with_bb(&bounds->vb, (BB *)bbc);
+  BB_expand(&bounds->cb, bbc->bcentroid);
+}
+
+static void build_bounds_reduce(const void *__restrict UNUSED(userdata),
+                                void *__restrict chunk_join,
+                                void *__restrict chunk)
+{
+  PBVHBuildBoundsTLS *join = chunk_join;
+  PBVHBuildBoundsTLS *bounds = chunk;
+
+  BB_expand_with_bb(&join->vb, &bounds->vb);
+  BB_expand_with_bb(&join->cb, &bounds->cb);
+}
+
+/* Compute the bounds of the primitives and of their centroids. */
+static void build_bounds(
+    const PBVH *pbvh, const BBC *prim_bbc, int offset, int count, BB *r_vb, BB *r_cb)
+{
+  PBVHBuildBoundsData data = {
+      .pbvh = pbvh,
+      .prim_bbc = prim_bbc,
+      .offset = offset,
+  };
+  PBVHBuildBoundsTLS bounds;
+  BB_reset(&bounds.vb);
+  BB_reset(&bounds.cb);
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = count > pbvh->leaf_limit * PBVH_BUILD_PARALLEL_LEAVES;
+  settings.userdata_chunk = &bounds;
+  settings.userdata_chunk_size = sizeof(bounds);
+  settings.func_reduce = build_bounds_reduce;
+  BLI_task_parallel_range(0, count, &data, build_bounds_cb, &settings);
+
+  *r_vb = bounds.vb;
+  *r_cb = bounds.cb;
+}
+
+typedef struct PBVHBuildBinsData {
+  const PBVH *pbvh;
+  const BBC *prim_bbc;
+  int offset;
+  int axis;
+  float bmin;
+  float scale;
+} PBVHBuildBinsData;
+
+typedef struct PBVHBuildBins {
+  BB bounds[PBVH_SAH_BINS];
+  int count[PBVH_SAH_BINS];
+} PBVHBuildBins;
+
+BLI_INLINE int build_bin_index(const PBVHBuildBinsData *data, const float centroid)
+{
+  const int bin = (int)((centroid - data->bmin) * data->scale);
+  return clamp_i(bin, 0, PBVH_SAH_BINS - 1);
+}
+
+static void build_bins_cb(void *__restrict userdata,
+                          const int i,
+                          const TaskParallelTLS *__restrict tls)
+{
+  const PBVHBuildBinsData *data = userdata;
+  PBVHBuildBins *bins = tls->userdata_chunk;
+  const BBC *bbc = &data->prim_bbc[data->pbvh->prim_indices[data->offset + i]];
+  const int bin = build_bin_index(data, bbc->bcentroid[data->axis]);
+
+  BB_expand_with_bb(&bins->bounds[bin], (BB *)bbc);
+  bins->count[bin]++;
+}
 
-static void build_sub(PBVH *pbvh, int node_index, BB *cb, BBC *prim_bbc, int offset, int count)
+static void build_bins_reduce(const void *__restrict UNUSED(userdata),
+                              void *__restrict chunk_join,
+                              void *__restrict chunk)
 {
+  PBVHBuildBins *join = chunk_join;
+  PBVHBuildBins *bins = chunk;
+
+  for (int i = 0; i < PBVH_SAH_BINS; i++) {
+    BB_expand_with_bb(&join->bounds[i], &bins->bounds[i]);
+    join->count[i] += bins->count[i];
+  }
+}
+
+/* Find the split position along the axis with the lowest surface area heuristic cost, evaluated
+ * at the bin boundaries. Falls back to the middle of the centroid bounds. */
+static float build_sah_split(
+    const PBVH *pbvh, const BBC *prim_bbc, const BB *cb, int axis, int offset, int count)
+{
+  const float mid = (cb->bmax[axis] + cb->bmin[axis]) * 0.5f;
+  const float extent = cb->bmax[axis] - cb->bmin[axis];
+  if (!(extent > 0.0f)) {
+    return mid;
+  }
+
+  PBVHBuildBinsData data = {
+      .pbvh = pbvh,
+      .prim_bbc = prim_bbc,
+      .offset = offset,
+      .axis = axis,
+      .bmin = cb->bmin[axis],
+      .scale = (float)PBVH_SAH_BINS / extent,
+  };
+  PBVHBuildBins bins;
+  for (int i = 0; i < PBVH_SAH_BINS; i++) {
+    BB_reset(&bins.bounds[i]);
+    bins.count[i] = 0;
+  }
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = count > pbvh->leaf_limit * PBVH_BUILD_PARALLEL_LEAVES;
+  settings.userdata_chunk = &bins;
+  settings.userdata_chunk_size = sizeof(bins);
+  settings.func_reduce = build_bins_reduce;
+  BLI_task_parallel_range(0, count, &data, build_bins_cb, &settings);
+
+  /* Sweep from the right to accumulate the cost of the right side of each boundary. */
+  float right_cost[PBVH_SAH_BINS];
+  BB right_bb;
+  int right_count = 0;
+  BB_reset(&right_bb);
+  for (int i = PBVH_SAH_BINS - 1; i > 0; i--) {
+    BB_expand_with_bb(&right_bb, &bins.bounds[i]);
+    right_count += bins.count[i];
+    right_cost[i] = (right_count != 0) ? BB_half_area(&right_bb) * (float)right_count : -1.0f;
+  }
+
+  int best_bin = -1;
+  float best_cost = FLT_MAX;
+  BB left_bb;
+  int left_count = 0;
+  BB_reset(&left_bb);
+  for (int i = 0; i < PBVH_SAH_BINS - 1; i++) {
+    BB_expand_with_bb(&left_bb, &bins.bounds[i]);
+    left_count += bins.count[i];
+    if (left_count == 0 || right_cost[i + 1] < 0.0f) {
+      continue;
+    }
+    const float cost = BB_half_area(&left_bb) * (float)left_count + right_cost[i + 1];
+    if (cost < best_cost) {
+      best_cost = cost;
+      best_bin = i;
+    }
+  }
+
+  if (best_bin == -1) {
+    return mid;
+  }
+  /* Keep the split inside the centroid bounds, so both sides of the partition are bounded. */
+  const float split = data.bmin + (float)(best_bin + 1) / data.scale;
+  return clamp_f(split, cb->bmin[axis], cb->bmax[axis]);
+}
+
+/* Primitives per chunk of the parallel partition. Fixed, so the result does not depend on the
+ * number of threads. */
+#define PBVH_PARTITION_CHUNK 4096
+
+typedef struct PBVHPartitionData {
+  const int *src;
+  int *dst;
+  const BBC *prim_bbc;
+  int count;
+  int axis;
+  float mid;
+  /* Primitives left of the split per chunk, then the number of those before each chunk. */
+  int *chunk_left;
+  int totleft;
+} PBVHPartitionData;
+
+static void partition_count_cb(void *__restrict userdata,
+                               const int chunk,
+                               const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  PBVHPartitionData *data = userdata;
+  const int start = chunk * PBVH_PARTITION_CHUNK;
+  const int end = min_ii(start + PBVH_PARTITION_CHUNK, data->count);
+  int totleft = 0;
+
+  for (int i = start; i < end; i++) {
+    if (data->prim_bbc[data->src[i]].bcentroid[data->axis] < data->mid) {
+      totleft++;
+    }
+  }
+  data->chunk_left[chunk] = totleft;
+}
+
+static void partition_scatter_cb(void *__restrict userdata,
+                                 const int chunk,
+                                 const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  PBVHPartitionData *data = userdata;
+  const int start = chunk * PBVH_PARTITION_CHUNK;
+  const int end = min_ii(start + PBVH_PARTITION_CHUNK, data->count);
+  int left = data->chunk_left[chunk];
+  int right = data->totleft + (start - data->chunk_left[chunk]);
+
+  for (int i = start; i < end; i++) {
+    const int prim = data->src[i];
+    if (data->prim_bbc[prim].bcentroid[data->axis] < data->mid) {
+      data->dst[left++] = prim;
+    }
+    else {
+      data->dst[right++] = prim;
+    }
+  }
+}
+
+/* Stable partition of large nodes: count the primitives left of the split per chunk, then
+ * scatter every chunk to its offsets. Falls back to #partition_indices when the strict
+ * comparison leaves one side empty, since that one puts primitives on the split on both sides.
+ * Returns the index of the first element on the right of the partition. */
+static int partition_indices_parallel(
+    int *prim_indices, int lo, int hi, int axis, float mid, const BBC *prim_bbc)
+{
+  const int count = hi - lo + 1;
+  const int totchunk = (count + PBVH_PARTITION_CHUNK - 1) / PBVH_PARTITION_CHUNK;
+
+  int *src = MEM_mallocN(sizeof(int) * (size_t)count, __func__);
+  memcpy(src, prim_indices + lo, sizeof(int) * (size_t)count);
+
+  PBVHPartitionData data = {
+      .src = src,
+      .dst = prim_indices + lo,
+      .prim_bbc = prim_bbc,
+      .count = count,
+      .axis = axis,
+      .mid = mid,
+      .chunk_left = MEM_mallocN(sizeof(int) * (size_t)totchunk, __func__),
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  BLI_task_parallel_range(0, totchunk, &data, partition_count_cb, &settings);
+
+  for (int chunk = 0; chunk < totchunk; chunk++) {
+    const int totleft = data.chunk_left[chunk];
+    data.chunk_left[chunk] = data.totleft;
+    data.totleft += totleft;
+  }
+
   int end;
-  BB cb_backing;
+  if (ELEM(data.totleft, 0, count)) {
+    end = partition_indices(prim_indices, lo, hi, axis, mid, prim_bbc);
+  }
+  else {
+    BLI_task_parallel_range(0, totchunk, &data, partition_scatter_cb, &settings);
+    end = lo + data.totleft;
+  }
+
+  MEM_freeN(data.chunk_left);
+  MEM_freeN(src);
+
+  return end;
+}
+
+static void build_sub_task(TaskPool *__restrict pool, void *taskdata);
+
+/* Recursively build a node of the temporary tree. */
+static void build_sub(PBVHBuildData *data, PBVHBuildNode *node)
+{
+  PBVH *pbvh = data->pbvh;
+  const int offset = node->offset;
+  const int count = node->count;
+  BB cb;
+
+  build_bounds(pbvh, data->prim_bbc, offset, count, &node->vb, &cb);
 
   /* Decide whether this is a leaf or not */
   const bool below_leaf_limit = count <= pbvh->leaf_limit;
   if (below_leaf_limit) {
     if (!leaf_needs_material_split(pbvh, offset, count)) {
-      build_leaf(pbvh, node_index, prim_bbc, offset, count);
+      node->is_leaf = true;
       return;
     }
   }
 
-  /* Add two child nodes */
-  pbvh->nodes[node_index].children_offset = pbvh->totnode;
-  pbvh_grow_nodes(pbvh, pbvh->totnode + 2);
-
-  /* Update parent node bounding box */
-  update_vb(pbvh, &pbvh->nodes[node_index], prim_bbc, offset, count);
-
+  int end;
   if (!below_leaf_limit) {
     /* Find axis with widest range of primitive centroids */
-    if (!cb) {
-      cb = &cb_backing;
-      BB_reset(cb);
-      for (int i = offset + count - 1; i >= offset; i--) {
-        BB_expand(cb, prim_bbc[pbvh->prim_indices[i]].bcentroid);
-      }
-    }
-    const int axis = BB_widest_axis(cb);
+    const int axis = BB_widest_axis(&cb);
+    const float split = build_sah_split(pbvh, data->prim_bbc, &cb, axis, offset, count);
 
     /* Partition primitives along that axis */
-    end = partition_indices(pbvh->prim_indices,
-                            offset,
-                            offset + count - 1,
-                            axis,
-                            (cb->bmax[axis] + cb->bmin[axis]) * 0.5f,
-                            prim_bbc);
+    if (count > pbvh->leaf_limit * PBVH_BUILD_PARALLEL_LEAVES) {
+      end = partition_indices_parallel(
+          pbvh->prim_indices, offset, offset + count - 1, axis, split, data->prim_bbc);
+    }
+    else {
+      end = partition_indices(
+          pbvh->prim_indices, offset, offset + count - 1, axis, split, data->prim_bbc);
+    }
   }
   else {
     /* Partition primitives by material */
@@ -522,16 +809,121 @@ static void build_sub(PBVH *pbvh, int node_index, BB *cb, BBC *prim_bbc, int off
   }
 
   /* Build children */
-  build_sub(pbvh, pbvh->nodes[node_index].children_offset, NULL, prim_bbc, offset, end - offset);
-  build_sub(pbvh,
-            pbvh->nodes[node_index].children_offset + 1,
-            NULL,
-            prim_bbc,
-            end,
-            offset + count - end);
+  for (int i = 0; i < 2; i++) {
+    PBVHBuildNode *child = MEM_callocN(sizeof(PBVHBuildNode), __func__);
+    child->offset = (i == 0) ? offset : end;
+    child->count = (i == 0) ? end - offset : offset + count - end;
+    node->children[i] = child;
+  }
+
+  const int task_prims = pbvh->leaf_limit * PBVH_BUILD_TASK_LEAVES;
+  if (data->pool && node->children[0]->count > task_prims &&
+      node->children[1]->count > task_prims) {
+    BLI_task_pool_push(data->pool, build_sub_task, node->children[0], false, NULL);
+  }
+  else {
+    build_sub(data, node->children[0]);
+  }
+  build_sub(data, node->children[1]);
+}
+
+static void build_sub_task(TaskPool *__restrict pool, void *taskdata)
+{
+  PBVHBuildData *data = BLI_task_pool_user_data(pool);
+  build_sub(data, taskdata);
+}
+
+static void build_node_free(PBVHBuildNode *node)
+{
+  if (node->children[0]) {
+    build_node_free(node->children[0]);
+    build_node_free(node->children[1]);
+  }
+  MEM_freeN(node);
+}
+
+/* Copy the temporary tree to #PBVH.nodes, children are allocated in the same order as the
+ * recursive build did. Leaves are gathered in depth first order. */
+static void build_layout(PBVH *pbvh,
+                         const PBVHBuildNode *bnode,
+                         int node_index,
+                         int *leaves,
+                         int *r_totleaf)
+{
+  if (bnode->is_leaf) {
+    PBVHNode *node = &pbvh->nodes[node_index];
+    node->flag |= PBVH_Leaf;
+    node->prim_indices = pbvh->prim_indices + bnode->offset;
+    node->totprim = bnode->count;
+    /* Still need vb for searches */
+    node->vb = bnode->vb;
+    node->orig_vb = bnode->vb;
+
+    leaves[(*r_totleaf)++] = node_index;
+    return;
+  }
+
+  /* Add two child nodes */
+  const int children_offset = pbvh->totnode;
+  pbvh_grow_nodes(pbvh, pbvh->totnode + 2);
+
+  PBVHNode *node = &pbvh->nodes[node_index];
+  node->children_offset = children_offset;
+  node->vb = bnode->vb;
+  node->orig_vb = bnode->vb;
+
+  build_layout(pbvh, bnode->children[0], children_offset, leaves, r_totleaf);
+  build_layout(pbvh, bnode->children[1], children_offset + 1, leaves, r_totleaf);
+}
+
+typedef struct PBVHBuildLeavesData {
+  PBVH *pbvh;
+  const int *leaves;
+} PBVHBuildLeavesData;
+
+/* Each vertex is owned by the first leaf using it in depth first order, which gives the same
+ * ownership as building leaves one after the other. */
+static void build_vert_owner_cb(void *__restrict userdata,
+                                const int leaf_index,
+                                const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  PBVHBuildLeavesData *data = userdata;
+  PBVH *pbvh = data->pbvh;
+  const PBVHNode *node = &pbvh->nodes[data->leaves[leaf_index]];
+
+  for (int i = 0; i < node->totprim; i++) {
+    const MLoopTri *lt = &pbvh->looptri[node->prim_indices[i]];
+    for (int j = 0; j < 3; j++) {
+      int *owner = &pbvh->vert_owner[pbvh->mloop[lt->tri[j]].v];
+      int owner_prev = *owner;
+      while (leaf_index < owner_prev) {
+        const int owner_cas = atomic_cas_int32(owner, owner_prev, leaf_index);
+        if (owner_cas == owner_prev) {
+          break;
+        }
+        owner_prev = owner_cas;
+      }
+    }
+  }
+}
+
+static void build_leaf_cb(void *__restrict userdata,
+                          const int leaf_index,
+                          const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  PBVHBuildLeavesData *data = userdata;
+  PBVH *pbvh = data->pbvh;
+  PBVHNode *node = &pbvh->nodes[data->leaves[leaf_index]];
+
+  if (pbvh->looptri) {
+    build_mesh_leaf_node(pbvh, node, leaf_index);
+  }
+  else {
+    build_grid_leaf_node(pbvh, node);
+  }
 }
 
-static void pbvh_build(PBVH *pbvh, BB *cb, BBC *prim_bbc, int totprim)
+static void pbvh_build(PBVH *pbvh, const BBC *prim_bbc, int totprim)
 {
   if (totprim != pbvh->totprim) {
     pbvh->totprim = totprim;
@@ -552,8 +944,86 @@ static void pbvh_build(PBVH *pbvh, BB *cb, BBC *prim_bbc, int totprim)
     }
   }
 
+  PBVHBuildData data = {
+      .pbvh = pbvh,
+      .prim_bbc = prim_bbc,
+      .pool = NULL,
+  };
+  PBVHBuildNode *root = MEM_callocN(sizeof(PBVHBuildNode), __func__);
+  root->offset = 0;
+  root->count = totprim;
+
+  if (totprim > pbvh->leaf_limit * PBVH_BUILD_TASK_LEAVES) {
+    data.pool = BLI_task_pool_create(&data, TASK_PRIORITY_HIGH);
+    build_sub(&data, root);
+    BLI_task_pool_work_and_wait(data.pool);
+    BLI_task_pool_free(data.pool);
+  }
+  else {
+    build_sub(&data, root);
+  }
+
+  /* There are at most as many leaves as primitives. */
+  int *leaves = MEM_mallocN(sizeof(int) * totprim, __func__);
+  int totleaf = 0;
   pbvh->totnode = 1;
-  build_sub(pbvh, 0, cb, prim_bbc, 0, totprim);
+  build_layout(pbvh, root, 0, leaves, &totleaf);
+  build_node_free(root);
+
+  PBVHBuildLeavesData leaves_data = {
+      .pbvh = pbvh,
+      .leaves = leaves,
+  };
+  TaskParallelSettings settings;
+  BKE_pbvh_parallel_range_settings(&settings, true, totleaf);
+
+  if (pbvh->looptri) {
+    copy_vn_i(pbvh->vert_owner, pbvh->totvert, INT_MAX);
+    BLI_task_parallel_range(0, totleaf, &leaves_data, build_vert_owner_cb, &settings);
+  }
+  BLI_task_parallel_range(0, totleaf, &leaves_data, build_leaf_cb, &settings);
+
+  MEM_freeN(leaves);
+}
+
+/** \} */
+
+typedef struct PBVHPrimBoundsData {
+  const PBVH *pbvh;
+  BBC *prim_bbc;
+} PBVHPrimBoundsData;
+
+static void pbvh_faces_prim_bounds_cb(void *__restrict userdata,
+                                      const int i,
+                                      const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const PBVHPrimBoundsData *data = userdata;
+  const PBVH *pbvh = data->pbvh;
+  const MLoopTri *lt = &pbvh->looptri[i];
+  BBC *bbc = &data->prim_bbc[i];
+
+  BB_reset((BB *)bbc);
+  for (int j = 0; j < 3; j++) {
+    BB_expand((BB *)bbc, pbvh->verts[pbvh->mloop[lt->tri[j]].v].co);
+  }
+  BBC_update_centroid(bbc);
+}
+
+static void pbvh_grids_prim_bounds_cb(void *__restrict userdata,
+                                      const int i,
+                                      const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const PBVHPrimBoundsData *data = userdata;
+  const PBVH *pbvh = data->pbvh;
+  const CCGKey *key = &pbvh->gridkey;
+  CCGElem *grid = pbvh->grids[i];
+  BBC *bbc = &data->prim_bbc[i];
+
+  BB_reset((BB *)bbc);
+  for (int j = 0; j < key->grid_area; j++) {
+    BB_expand((BB *)bbc, CCG_elem_offset_co(key, grid, j));
+  }
+  BBC_update_centroid(bbc);
 }
 
 /**
@@ -574,16 +1044,13 @@ void BKE_pbvh_build_mesh(PBVH *pbvh,
                          const MLoopTri *looptri,
                          int looptri_num)
 {
-  BBC *prim_bbc = NULL;
-  BB cb;
-
   pbvh->mesh = mesh;
   pbvh->type = PBVH_FACES;
   pbvh->mpoly = mpoly;
   pbvh->mloop = mloop;
   pbvh->looptri = looptri;
   pbvh->verts = verts;
-  pbvh->vert_bitmap = BLI_BITMAP_NEW(totvert, "bvh->vert_bitmap");
+  pbvh->vert_owner = MEM_mallocN(sizeof(int) * totvert, "bvh->vert_owner");
   pbvh->totvert = totvert;
   pbvh->leaf_limit = LEAF_LIMIT;
   pbvh->vdata = vdata;
@@ -593,33 +1060,24 @@ void BKE_pbvh_build_mesh(PBVH *pbvh,
   pbvh->face_sets_color_seed = mesh->face_sets_color_seed;
   pbvh->face_sets_color_default = mesh->face_sets_color_default;
 
-  BB_reset(&cb);
-
   /* For each face, store the AABB and the AABB centroid */
-  prim_bbc = MEM_mallocN(sizeof(BBC) * looptri_num, "prim_bbc");
-
-  for (int i = 0; i < looptri_num; i++) {
-    const MLoopTri *lt = &looptri[i];
-    const int sides = 3;
-    BBC *bbc = prim_bbc + i;
-
-    BB_reset((BB *)bbc);
+  BBC *prim_bbc = MEM_mallocN(sizeof(BBC) * looptri_num, "prim_bbc");
 
-    for (int j = 0; j < sides; j++) {
-      BB_expand((BB *)bbc, verts[pbvh->mloop[lt->tri[j]].v].co);
-    }
-
-    BBC_update_centroid(bbc);
-
-    BB_expand(&cb, bbc->bcentroid);
-  }
+  PBVHPrimBoundsData data = {
+      .pbvh = pbvh,
+      .prim_bbc = prim_bbc,
+  };
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = looptri_num > pbvh->leaf_limit;
+  BLI_task_parallel_range(0, looptri_num, &data, pbvh_faces_prim_bounds_cb, &settings);
 
   if (looptri_num) {
-    pbvh_build(pbvh, &cb, prim_bbc, looptri_num);
+    pbvh_build(pbvh, prim_bbc, looptri_num);
   }
 
   MEM_freeN(prim_bbc);
-  MEM_freeN(pbvh->vert_bitmap);
+  MEM_SAFE_FREE(pbvh->vert_owner);
 }
 
 /* Do a full rebuild with on Grids data structure */
@@ -642,29 +1100,20 @@ void BKE_pbvh_build_grids(PBVH *pbvh,
   pbvh->grid_hidden = grid_hidden;
   pbvh->leaf_limit = max_ii(LEAF_LIMIT / (gridsize * gridsize), 1);
 
-  BB cb;
-  BB_reset(&cb);
-
   /* For each grid, store the AABB and the AABB centroid */
   BBC *prim_bbc = MEM_mallocN(sizeof(BBC) * totgrid, "prim_bbc");
 
-  for (int i = 0; i < totgrid; i++) {
-    CCGElem *grid = grids[i];
-    BBC *bbc = prim_bbc + i;
-
-    BB_reset((BB *)bbc);
-
-    for (int j = 0; j < gridsize * gridsize; j++) {
-      BB_expand((BB *)bbc, CCG_elem_offset_co(key, grid, j));
-    }
-
-    BBC_update_centroid(bbc);
-
-    BB_expand(&cb, bbc->bcentroid);
-  }
+  PBVHPrimBoundsData data = {
+      .pbvh = pbvh,
+      .prim_bbc = prim_bbc,
+  };
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = totgrid > pbvh->leaf_limit;
+  BLI_task_parallel_range(0, totgrid, &data, pbvh_grids_prim_bounds_cb, &settings);
 
   if (totgrid) {
-    pbvh_build(pbvh, &cb, prim_bbc, totgrid);
+    pbvh_build(pbvh, prim_bbc, totgrid);
   }
 
   MEM_freeN(prim_bbc);
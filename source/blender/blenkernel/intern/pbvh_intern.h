@@ -151,8 +151,9 @@ struct PBVH {
   BLI_bitmap **grid_hidden;
 
   /* Only used during BVH build and update,
-   * don't need to remain valid after */
-  BLI_bitmap *vert_bitmap;
+   * don't need to remain valid after.
+   * Depth first index of the first leaf using each vertex, which owns the vertex. */
+  int *vert_owner;
 
 #ifdef PERFCNTRS
   int perf_modified;
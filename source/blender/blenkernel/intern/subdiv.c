@@ -195,6 +195,7 @@ void BKE_subdiv_free(Subdiv *subdiv)
     openSubdiv_deleteTopologyRefiner(subdiv->topology_refiner);
   }
   BKE_subdiv_displacement_detach(subdiv);
+  MEM_SAFE_FREE(subdiv->limit_stencils.patch_coords);
   if (subdiv->cache_.face_ptex_offset != NULL) {
     MEM_freeN(subdiv->cache_.face_ptex_offset);
   }
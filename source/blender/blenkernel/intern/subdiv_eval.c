@@ -27,7 +27,9 @@
 #include "DNA_meshdata_types.h"
 
 #include "BLI_bitmap.h"
+#include "BLI_math_base.h"
 #include "BLI_math_vector.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "BKE_customdata.h"
@@ -35,6 +37,7 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "opensubdiv_capi_type.h"
 #include "opensubdiv_evaluator_capi.h"
 #include "opensubdiv_topology_refiner_capi.h"
 
@@ -274,6 +277,132 @@ void BKE_subdiv_eval_final_point(
   }
 }
 
+/* ========================== Batched point queries ========================= */
+
+void BKE_subdiv_eval_limit_points(Subdiv *subdiv,
+                                  const OpenSubdiv_PatchCoord *patch_coords,
+                                  const int num_patch_coords,
+                                  float (*r_P)[3],
+                                  float (*r_dPdu)[3],
+                                  float (*r_dPdv)[3])
+{
+  subdiv->evaluator->evaluatePatchesLimit(subdiv->evaluator,
+                                          patch_coords,
+                                          num_patch_coords,
+                                          &r_P[0][0],
+                                          (r_dPdu != NULL) ? &r_dPdu[0][0] : NULL,
+                                          (r_dPdv != NULL) ? &r_dPdv[0][0] : NULL);
+  if (r_dPdu == NULL || r_dPdv == NULL) {
+    return;
+  }
+  /* Points with degenerate derivatives are nudged inside of their face, same as single point
+   * queries. */
+  for (int i = 0; i < num_patch_coords; i++) {
+    if ((is_zero_v3(r_dPdu[i]) || is_zero_v3(r_dPdv[i])) || equals_v3v3(r_dPdu[i], r_dPdv[i])) {
+      const OpenSubdiv_PatchCoord *patch_coord = &patch_coords[i];
+      BKE_subdiv_eval_limit_point_and_derivatives(subdiv,
+                                                  patch_coord->ptex_face,
+                                                  patch_coord->u,
+                                                  patch_coord->v,
+                                                  r_P[i],
+                                                  r_dPdu[i],
+                                                  r_dPdv[i]);
+    }
+  }
+}
+
+/* ============================= Limit stencils ============================= */
+
+/* Number of stencils evaluated by a single call to the evaluator. */
+#define LIMIT_STENCILS_CHUNK_SIZE 1024
+
+typedef struct LimitStencilsData {
+  Subdiv *subdiv;
+  float (*P)[3];
+  float (*dPdu)[3];
+  float (*dPdv)[3];
+} LimitStencilsData;
+
+void BKE_subdiv_eval_limit_stencils_create(Subdiv *subdiv,
+                                           const OpenSubdiv_PatchCoord *patch_coords,
+                                           const int num_patch_coords,
+                                           const int tag)
+{
+  BLI_assert(subdiv->evaluator != NULL);
+  BKE_subdiv_stats_begin(&subdiv->stats, SUBDIV_STATS_EVALUATOR_LIMIT_STENCILS);
+  MEM_SAFE_FREE(subdiv->limit_stencils.patch_coords);
+  subdiv->limit_stencils.patch_coords = MEM_malloc_arrayN(
+      num_patch_coords, sizeof(*patch_coords), "subdiv limit stencils coords");
+  memcpy(subdiv->limit_stencils.patch_coords,
+         patch_coords,
+         sizeof(*patch_coords) * (size_t)num_patch_coords);
+  subdiv->limit_stencils.num_patch_coords = num_patch_coords;
+  subdiv->limit_stencils.tag = tag;
+  subdiv->evaluator->createLimitStencils(subdiv->evaluator, patch_coords, num_patch_coords);
+  BKE_subdiv_stats_end(&subdiv->stats, SUBDIV_STATS_EVALUATOR_LIMIT_STENCILS);
+}
+
+bool BKE_subdiv_eval_has_limit_stencils(const Subdiv *subdiv,
+                                        const int num_patch_coords,
+                                        const int tag)
+{
+  return subdiv->evaluator != NULL && subdiv->limit_stencils.patch_coords != NULL &&
+         subdiv->limit_stencils.num_patch_coords == num_patch_coords &&
+         subdiv->limit_stencils.tag == tag;
+}
+
+static void limit_stencils_eval_chunk(void *__restrict userdata,
+                                      const int chunk_index,
+                                      const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  LimitStencilsData *data = userdata;
+  Subdiv *subdiv = data->subdiv;
+  const int start = chunk_index * LIMIT_STENCILS_CHUNK_SIZE;
+  const int num = min_ii(LIMIT_STENCILS_CHUNK_SIZE,
+                         subdiv->limit_stencils.num_patch_coords - start);
+  subdiv->evaluator->evaluateLimitStencils(subdiv->evaluator,
+                                           start,
+                                           num,
+                                           data->P[start],
+                                           data->dPdu[start],
+                                           data->dPdv[start]);
+  /* Points with degenerate derivatives are nudged inside of their face, same as single point
+   * queries. */
+  for (int i = start; i < start + num; i++) {
+    if ((is_zero_v3(data->dPdu[i]) || is_zero_v3(data->dPdv[i])) ||
+        equals_v3v3(data->dPdu[i], data->dPdv[i])) {
+      const OpenSubdiv_PatchCoord *patch_coord = &subdiv->limit_stencils.patch_coords[i];
+      BKE_subdiv_eval_limit_point_and_derivatives(subdiv,
+                                                  patch_coord->ptex_face,
+                                                  patch_coord->u,
+                                                  patch_coord->v,
+                                                  data->P[i],
+                                                  data->dPdu[i],
+                                                  data->dPdv[i]);
+    }
+  }
+}
+
+void BKE_subdiv_eval_limit_stencils(Subdiv *subdiv,
+                                    float (*r_P)[3],
+                                    float (*r_dPdu)[3],
+                                    float (*r_dPdv)[3])
+{
+  const int num_patch_coords = subdiv->limit_stencils.num_patch_coords;
+  const int num_chunks = (num_patch_coords + LIMIT_STENCILS_CHUNK_SIZE - 1) /
+                         LIMIT_STENCILS_CHUNK_SIZE;
+  LimitStencilsData data = {
+      .subdiv = subdiv,
+      .P = r_P,
+      .dPdu = r_dPdu,
+      .dPdv = r_dPdv,
+  };
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0, num_chunks, &data, limit_stencils_eval_chunk, &settings);
+}
+
 /* ===================  Patch queries at given resolution =================== */
 
 /* Move buffer forward by a given number of bytes. */
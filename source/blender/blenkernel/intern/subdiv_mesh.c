@@ -41,6 +41,8 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "opensubdiv_capi_type.h"
+
 /* -------------------------------------------------------------------- */
 /** \name Subdivision Context
  * \{ */
@@ -76,6 +78,12 @@ typedef struct SubdivMeshContext {
    * when it's not possible is when displacement is used. */
   bool can_evaluate_normals;
   bool have_displacement;
+  /* Limit surface points and derivatives of all subdivided vertices, evaluated up-front.
+   * NULL when vertices are evaluated one by one, for example with displacement. */
+  float (*limit_P)[3];
+  float (*limit_dPdu)[3];
+  float (*limit_dPdv)[3];
+  int limit_num_vertices;
 } SubdivMeshContext;
 
 static void subdiv_mesh_ctx_cache_uv_layers(SubdivMeshContext *ctx)
@@ -117,6 +125,9 @@ static void subdiv_mesh_context_free(SubdivMeshContext *ctx)
 {
   MEM_SAFE_FREE(ctx->accumulated_normals);
   MEM_SAFE_FREE(ctx->accumulated_counters);
+  MEM_SAFE_FREE(ctx->limit_P);
+  MEM_SAFE_FREE(ctx->limit_dPdu);
+  MEM_SAFE_FREE(ctx->limit_dPdv);
 }
 
 /** \} */
@@ -454,14 +465,23 @@ static void subdiv_mesh_tls_free(void *tls_v)
 /** \name Evaluation helper functions
  * \{ */
 
-static void eval_final_point_and_vertex_normal(Subdiv *subdiv,
+static void eval_final_point_and_vertex_normal(const SubdivMeshContext *ctx,
                                                const int ptex_face_index,
                                                const float u,
                                                const float v,
+                                               const int subdiv_vertex_index,
                                                float r_P[3],
                                                short r_N[3])
 {
-  if (subdiv->displacement_evaluator == NULL) {
+  Subdiv *subdiv = ctx->subdiv;
+  if (ctx->limit_P != NULL) {
+    float N[3];
+    copy_v3_v3(r_P, ctx->limit_P[subdiv_vertex_index]);
+    cross_v3_v3v3(N, ctx->limit_dPdu[subdiv_vertex_index], ctx->limit_dPdv[subdiv_vertex_index]);
+    normalize_v3(N);
+    normal_float_to_short_v3(r_N, N);
+  }
+  else if (subdiv->displacement_evaluator == NULL) {
     BKE_subdiv_eval_limit_point_and_short_normal(subdiv, ptex_face_index, u, v, r_P, r_N);
   }
   else {
@@ -469,6 +489,21 @@ static void eval_final_point_and_vertex_normal(Subdiv *subdiv,
   }
 }
 
+static void eval_limit_point(const SubdivMeshContext *ctx,
+                             const int ptex_face_index,
+                             const float u,
+                             const float v,
+                             const int subdiv_vertex_index,
+                             float r_P[3])
+{
+  if (ctx->limit_P != NULL) {
+    copy_v3_v3(r_P, ctx->limit_P[subdiv_vertex_index]);
+  }
+  else {
+    BKE_subdiv_eval_limit_point(ctx->subdiv, ptex_face_index, u, v, r_P);
+  }
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -506,6 +541,160 @@ static void subdiv_accumulate_vertex_normal_and_displacement(SubdivMeshContext *
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Limit surface evaluation
+ *
+ * Limit surface of all subdivided vertices is evaluated up-front: coordinates of the vertices are
+ * gathered and evaluated in a single batch, which avoids per-vertex evaluator overhead and lets the
+ * evaluator use multiple threads.
+ *
+ * Deforming meshes evaluate the limit surface at the same coordinates on every update. When the
+ * same layout is subdivided for the second time the evaluator creates limit stencils for the
+ * gathered coordinates. From then on gathering is skipped and vertices are evaluated as weighted
+ * sums of the refined control points.
+ * \{ */
+
+typedef struct LimitStencilsGatherContext {
+  OpenSubdiv_PatchCoord *patch_coords;
+  int num_vertices;
+} LimitStencilsGatherContext;
+
+static bool limit_stencils_gather_topology_info(const SubdivForeachContext *foreach_context,
+                                                const int num_vertices,
+                                                const int UNUSED(num_edges),
+                                                const int UNUSED(num_loops),
+                                                const int UNUSED(num_polygons))
+{
+  LimitStencilsGatherContext *gather_context = foreach_context->user_data;
+  /* Loose vertices are not visited and keep a valid dummy coordinate. */
+  gather_context->patch_coords = MEM_calloc_arrayN(
+      num_vertices, sizeof(*gather_context->patch_coords), "subdiv limit stencils coords");
+  gather_context->num_vertices = num_vertices;
+  return true;
+}
+
+static void limit_stencils_gather_coord(const SubdivForeachContext *foreach_context,
+                                        const int ptex_face_index,
+                                        const float u,
+                                        const float v,
+                                        const int subdiv_vertex_index)
+{
+  LimitStencilsGatherContext *gather_context = foreach_context->user_data;
+  OpenSubdiv_PatchCoord *patch_coord = &gather_context->patch_coords[subdiv_vertex_index];
+  patch_coord->ptex_face = ptex_face_index;
+  patch_coord->u = u;
+  patch_coord->v = v;
+}
+
+static void limit_stencils_gather_vertex_corner(const SubdivForeachContext *foreach_context,
+                                                void *UNUSED(tls),
+                                                const int ptex_face_index,
+                                                const float u,
+                                                const float v,
+                                                const int UNUSED(coarse_vertex_index),
+                                                const int UNUSED(coarse_poly_index),
+                                                const int UNUSED(coarse_corner),
+                                                const int subdiv_vertex_index)
+{
+  limit_stencils_gather_coord(foreach_context, ptex_face_index, u, v, subdiv_vertex_index);
+}
+
+static void limit_stencils_gather_vertex_edge(const SubdivForeachContext *foreach_context,
+                                              void *UNUSED(tls),
+                                              const int ptex_face_index,
+                                              const float u,
+                                              const float v,
+                                              const int UNUSED(coarse_edge_index),
+                                              const int UNUSED(coarse_poly_index),
+                                              const int UNUSED(coarse_corner),
+                                              const int subdiv_vertex_index)
+{
+  limit_stencils_gather_coord(foreach_context, ptex_face_index, u, v, subdiv_vertex_index);
+}
+
+static void limit_stencils_gather_vertex_inner(const SubdivForeachContext *foreach_context,
+                                               void *UNUSED(tls),
+                                               const int ptex_face_index,
+                                               const float u,
+                                               const float v,
+                                               const int UNUSED(coarse_poly_index),
+                                               const int UNUSED(coarse_corner),
+                                               const int subdiv_vertex_index)
+{
+  limit_stencils_gather_coord(foreach_context, ptex_face_index, u, v, subdiv_vertex_index);
+}
+
+static bool subdiv_mesh_can_evaluate_limit(const SubdivMeshContext *ctx)
+{
+  return !ctx->have_displacement && ctx->subdiv->evaluator != NULL &&
+         ctx->coarse_mesh->totpoly != 0;
+}
+
+static void subdiv_mesh_limit_alloc(SubdivMeshContext *ctx, const int num_vertices)
+{
+  ctx->limit_P = MEM_malloc_arrayN(num_vertices, sizeof(*ctx->limit_P), "subdiv limit P");
+  ctx->limit_dPdu = MEM_malloc_arrayN(num_vertices, sizeof(*ctx->limit_dPdu), "subdiv limit dPdu");
+  ctx->limit_dPdv = MEM_malloc_arrayN(num_vertices, sizeof(*ctx->limit_dPdv), "subdiv limit dPdv");
+  ctx->limit_num_vertices = num_vertices;
+}
+
+static void subdiv_mesh_limit_evaluate(SubdivMeshContext *ctx)
+{
+  Subdiv *subdiv = ctx->subdiv;
+  const int tag = ctx->settings->resolution;
+  if (!subdiv_mesh_can_evaluate_limit(ctx)) {
+    return;
+  }
+  if (subdiv->limit_stencils.patch_coords != NULL && subdiv->limit_stencils.tag == tag) {
+    subdiv_mesh_limit_alloc(ctx, subdiv->limit_stencils.num_patch_coords);
+    BKE_subdiv_eval_limit_stencils(subdiv, ctx->limit_P, ctx->limit_dPdu, ctx->limit_dPdv);
+    return;
+  }
+  LimitStencilsGatherContext gather_context = {NULL};
+  SubdivForeachContext foreach_context = {NULL};
+  foreach_context.topology_info = limit_stencils_gather_topology_info;
+  foreach_context.vertex_corner = limit_stencils_gather_vertex_corner;
+  foreach_context.vertex_edge = limit_stencils_gather_vertex_edge;
+  foreach_context.vertex_inner = limit_stencils_gather_vertex_inner;
+  foreach_context.user_data = &gather_context;
+  BKE_subdiv_foreach_subdiv_geometry(subdiv, &foreach_context, ctx->settings, ctx->coarse_mesh);
+  if (gather_context.patch_coords == NULL) {
+    return;
+  }
+  const int num_vertices = gather_context.num_vertices;
+  subdiv_mesh_limit_alloc(ctx, num_vertices);
+  if (subdiv->limit_stencils.requested_tag == tag) {
+    BKE_subdiv_eval_limit_stencils_create(subdiv, gather_context.patch_coords, num_vertices, tag);
+    BKE_subdiv_eval_limit_stencils(subdiv, ctx->limit_P, ctx->limit_dPdu, ctx->limit_dPdv);
+  }
+  else {
+    subdiv->limit_stencils.requested_tag = tag;
+    BKE_subdiv_eval_limit_points(subdiv,
+                                 gather_context.patch_coords,
+                                 num_vertices,
+                                 ctx->limit_P,
+                                 ctx->limit_dPdu,
+                                 ctx->limit_dPdv);
+  }
+  MEM_freeN(gather_context.patch_coords);
+}
+
+/* Stencils are matched by resolution only, loose geometry might have changed the layout since
+ * they were created. Fall back to per-vertex evaluation then, stencils are created again on the
+ * next request. */
+static void subdiv_mesh_limit_verify(SubdivMeshContext *ctx, const int num_vertices)
+{
+  if (ctx->limit_P == NULL || ctx->limit_num_vertices == num_vertices) {
+    return;
+  }
+  MEM_SAFE_FREE(ctx->limit_P);
+  MEM_SAFE_FREE(ctx->limit_dPdu);
+  MEM_SAFE_FREE(ctx->limit_dPdv);
+  MEM_SAFE_FREE(ctx->subdiv->limit_stencils.patch_coords);
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Callbacks
  * \{ */
@@ -526,6 +715,7 @@ static bool subdiv_mesh_topology_info(const SubdivForeachContext *foreach_contex
       subdiv_context->coarse_mesh, num_vertices, num_edges, 0, num_loops, num_polygons, mask);
   subdiv_mesh_ctx_cache_custom_data_layers(subdiv_context);
   subdiv_mesh_prepare_accumulator(subdiv_context, num_vertices);
+  subdiv_mesh_limit_verify(subdiv_context, num_vertices);
   return true;
 }
 
@@ -585,7 +775,7 @@ static void evaluate_vertex_and_apply_displacement_copy(const SubdivMeshContext
   }
   /* Copy custom data and evaluate position. */
   subdiv_vertex_data_copy(ctx, coarse_vert, subdiv_vert);
-  BKE_subdiv_eval_limit_point(ctx->subdiv, ptex_face_index, u, v, subdiv_vert->co);
+  eval_limit_point(ctx, ptex_face_index, u, v, subdiv_vertex_index, subdiv_vert->co);
   /* Apply displacement. */
   add_v3_v3(subdiv_vert->co, D);
   /* Copy normal from accumulated storage. */
@@ -618,7 +808,7 @@ static void evaluate_vertex_and_apply_displacement_interpolate(
   }
   /* Interpolate custom data and evaluate position. */
   subdiv_vertex_data_interpolate(ctx, subdiv_vert, vertex_interpolation, u, v);
-  BKE_subdiv_eval_limit_point(ctx->subdiv, ptex_face_index, u, v, subdiv_vert->co);
+  eval_limit_point(ctx, ptex_face_index, u, v, subdiv_vertex_index, subdiv_vert->co);
   /* Apply displacement. */
   add_v3_v3(subdiv_vert->co, D);
   /* Copy normal from accumulated storage. */
@@ -783,7 +973,6 @@ static void subdiv_mesh_vertex_inner(const SubdivForeachContext *foreach_context
 {
   SubdivMeshContext *ctx = foreach_context->user_data;
   SubdivMeshTLS *tls = tls_v;
-  Subdiv *subdiv = ctx->subdiv;
   const Mesh *coarse_mesh = ctx->coarse_mesh;
   const MPoly *coarse_mpoly = coarse_mesh->mpoly;
   const MPoly *coarse_poly = &coarse_mpoly[coarse_poly_index];
@@ -793,7 +982,7 @@ static void subdiv_mesh_vertex_inner(const SubdivForeachContext *foreach_context
   subdiv_mesh_ensure_vertex_interpolation(ctx, tls, coarse_poly, coarse_corner);
   subdiv_vertex_data_interpolate(ctx, subdiv_vert, &tls->vertex_interpolation, u, v);
   eval_final_point_and_vertex_normal(
-      subdiv, ptex_face_index, u, v, subdiv_vert->co, subdiv_vert->no);
+      ctx, ptex_face_index, u, v, subdiv_vertex_index, subdiv_vert->co, subdiv_vert->no);
   subdiv_mesh_tag_center_vertex(coarse_poly, subdiv_vert, u, v);
 }
 
@@ -1218,6 +1407,7 @@ Mesh *BKE_subdiv_to_mesh(Subdiv *subdiv,
   subdiv_context.have_displacement = (subdiv->displacement_evaluator != NULL);
   subdiv_context.can_evaluate_normals = !subdiv_context.have_displacement &&
                                         subdiv_context.subdiv->settings.is_adaptive;
+  subdiv_mesh_limit_evaluate(&subdiv_context);
   /* Multi-threaded traversal/evaluation. */
   BKE_subdiv_stats_begin(&subdiv->stats, SUBDIV_STATS_SUBDIV_TO_MESH_GEOMETRY);
   SubdivForeachContext foreach_context;
@@ -73,6 +73,7 @@ void BKE_subdiv_stats_print(const SubdivStats *stats)
   STATS_PRINT_TIME(stats, subdiv_to_ccg_time, "Subdivision to CCG time");
   STATS_PRINT_TIME(stats, subdiv_to_ccg_elements_time, "    Elements time");
   STATS_PRINT_TIME(stats, topology_compare_time, "Topology comparison time");
+  STATS_PRINT_TIME(stats, evaluator_limit_stencils_time, "Evaluator limit stencils time");
 
 #undef STATS_PRINT_TIME
 }
@@ -357,6 +357,13 @@ IMesh trimesh_nary_intersect(const IMesh &tm_in,
                              bool use_self,
                              IMeshArena *arena);
 
+/**
+ * Orientation of the exact coordinates of d with respect to the plane through a, b and c, like
+ * #orient3d. Double arithmetic with error bounds is tried first, the exact coordinates are only
+ * used when the answer is too close to call.
+ */
+int orient3d_filtered(const Vert *a, const Vert *b, const Vert *c, const Vert *d);
+
 /** This has the side effect of populating verts in the #IMesh. */
 void write_obj_mesh(IMesh &m, const std::string &objname);
 
@@ -1185,11 +1185,6 @@ static double supremum_dot_cross(const double3 &a, const double3 &b)
   return double3::dot(c, c);
 }
 
-/* The index of dot when inputs are plane_coords with index 1 is much higher.
- * Plane coords have index 6.
- */
-constexpr int index_dot_plane_coords = 15;
-
 /**
  * Used with supremum to get error bound. See Burnikel et al paper.
  * index_plane_coord is the index of a plane coordinate calculated
@@ -1203,34 +1198,80 @@ constexpr int index_dot_plane_coords = 15;
 constexpr int index_dot_cross = 11;
 
 /**
- * Return the approximate side of point p on a plane with normal plane_no and point plane_p.
- * The answer will be 1 if p is definitely above the plane, -1 if it is definitely below.
- * If the answer is 0, we are unsure about which side of the plane (or if it is on the plane).
- * In exact arithmetic, the answer is just `sgn(dot(p - plane_p, plane_no))`.
- *
- * The plane_no input is constructed, so has a higher index.
+ * index_orient3d is the index of the determinant calculated in #filter_orient3d:
+ * differences of input coords have index 2, their products 5, the cross product terms 6,
+ * the products with the remaining differences 9, and the sum of three of those 11.
  */
-constexpr int index_plane_side = 3 + 2 * index_dot_plane_coords;
+constexpr int index_orient3d = 11;
 
-static int filter_plane_side(const double3 &p,
-                             const double3 &plane_p,
-                             const double3 &plane_no,
-                             const double3 &abs_p,
-                             const double3 &abs_plane_p,
-                             const double3 &abs_plane_no)
-{
-  double d = double3::dot(p - plane_p, plane_no);
-  if (d == 0.0) {
+/**
+ * Return the approximate orientation of d with respect to the plane through a, b and c,
+ * with the same sign convention as #orient3d. The inputs are the double approximations of the
+ * exact vertex coordinates. The answer is 1 or -1 if the exact orientation is definitely
+ * positive or negative, and 0 if we are unsure (including when d is on the plane).
+ */
+static int filter_orient3d(const double3 &a, const double3 &b, const double3 &c, const double3 &d)
+{
+  const double3 ad = a - d;
+  const double3 bd = b - d;
+  const double3 cd = c - d;
+  const double det = ad.z * (bd.x * cd.y - cd.x * bd.y) + bd.z * (cd.x * ad.y - ad.x * cd.y) +
+                     cd.z * (ad.x * bd.y - bd.x * ad.y);
+  if (det == 0.0) {
     return 0;
   }
-  double supremum = double3::dot(abs_p + abs_plane_p, abs_plane_no);
-  double err_bound = supremum * index_plane_side * DBL_EPSILON;
-  if (fabs(d) > err_bound) {
-    return d > 0 ? 1 : -1;
+  const double3 abs_d = double3::abs(d);
+  const double3 sup_ad = double3::abs(a) + abs_d;
+  const double3 sup_bd = double3::abs(b) + abs_d;
+  const double3 sup_cd = double3::abs(c) + abs_d;
+  const double supremum = sup_ad.z * (sup_bd.x * sup_cd.y + sup_cd.x * sup_bd.y) +
+                          sup_bd.z * (sup_cd.x * sup_ad.y + sup_ad.x * sup_cd.y) +
+                          sup_cd.z * (sup_ad.x * sup_bd.y + sup_bd.x * sup_ad.y);
+  const double err_bound = supremum * index_orient3d * DBL_EPSILON;
+  if (fabs(det) > err_bound) {
+    return det > 0 ? 1 : -1;
   }
   return 0;
 }
 
+int orient3d_filtered(const Vert *a, const Vert *b, const Vert *c, const Vert *d)
+{
+  const int orient = filter_orient3d(a->co, b->co, c->co, d->co);
+  if (orient != 0) {
+    return orient;
+  }
+  return orient3d(a->co_exact, b->co_exact, c->co_exact, d->co_exact);
+}
+
+/**
+ * Return true if one triangle is definitely strictly on one side of the plane of the other,
+ * so the triangles don't intersect. Only uses double arithmetic, a false return value means
+ * that exact arithmetic is needed to decide.
+ *
+ * The sign of `dot(p1 - r2, n2)` with `n2 = cross(p2 - r2, q2 - r2)` (the normal as calculated
+ * by #Face::populate_plane) is the orientation of p1 with respect to p2, q2, r2.
+ */
+static bool tri_tri_filter_disjoint(const Face &tri1, const Face &tri2)
+{
+  const double3 &p1 = tri1[0]->co;
+  const double3 &q1 = tri1[1]->co;
+  const double3 &r1 = tri1[2]->co;
+  const double3 &p2 = tri2[0]->co;
+  const double3 &q2 = tri2[1]->co;
+  const double3 &r2 = tri2[2]->co;
+
+  const int sp1 = filter_orient3d(p1, p2, q2, r2);
+  const int sq1 = filter_orient3d(q1, p2, q2, r2);
+  const int sr1 = filter_orient3d(r1, p2, q2, r2);
+  if ((sp1 > 0 && sq1 > 0 && sr1 > 0) || (sp1 < 0 && sq1 < 0 && sr1 < 0)) {
+    return true;
+  }
+  const int sp2 = filter_orient3d(p2, p1, q1, r1);
+  const int sq2 = filter_orient3d(q2, p1, q1, r1);
+  const int sr2 = filter_orient3d(r2, p1, q1, r1);
+  return (sp2 > 0 && sq2 > 0 && sr2 > 0) || (sp2 < 0 && sq2 < 0 && sr2 < 0);
+}
+
 /*
  * interesect_tri_tri and helper functions.
  * This code uses the algorithm of Guigue and Devillers, as described
@@ -1471,51 +1512,25 @@ static ITT_value intersect_tri_tri(const IMesh &tm, int t1, int t2)
 
   /* Try first getting signs with double arithmetic, with error bounds.
    * If the signs calculated in this section are not 0, they are the same
-   * as what they would be using exact arithmetic. */
+   * as what they would be using exact arithmetic, and save the exact dot products below.
+   * The pair was not decided by #tri_tri_filter_disjoint, which did the same tests,
+   * so these signs can't show all vertices of one triangle on one side of the other. */
   const double3 &d_p1 = vp1->co;
   const double3 &d_q1 = vq1->co;
   const double3 &d_r1 = vr1->co;
   const double3 &d_p2 = vp2->co;
   const double3 &d_q2 = vq2->co;
   const double3 &d_r2 = vr2->co;
-  const double3 &d_n2 = tri2.plane->norm;
 
-  const double3 &abs_d_p1 = double3::abs(d_p1);
-  const double3 &abs_d_q1 = double3::abs(d_q1);
-  const double3 &abs_d_r1 = double3::abs(d_r1);
-  const double3 &abs_d_r2 = double3::abs(d_r2);
-  const double3 &abs_d_n2 = double3::abs(d_n2);
+  int sp1 = filter_orient3d(d_p1, d_p2, d_q2, d_r2);
+  int sq1 = filter_orient3d(d_q1, d_p2, d_q2, d_r2);
+  int sr1 = filter_orient3d(d_r1, d_p2, d_q2, d_r2);
+  BLI_assert(!((sp1 > 0 && sq1 > 0 && sr1 > 0) || (sp1 < 0 && sq1 < 0 && sr1 < 0)));
 
-  int sp1 = filter_plane_side(d_p1, d_r2, d_n2, abs_d_p1, abs_d_r2, abs_d_n2);
-  int sq1 = filter_plane_side(d_q1, d_r2, d_n2, abs_d_q1, abs_d_r2, abs_d_n2);
-  int sr1 = filter_plane_side(d_r1, d_r2, d_n2, abs_d_r1, abs_d_r2, abs_d_n2);
-  if ((sp1 > 0 && sq1 > 0 && sr1 > 0) || (sp1 < 0 && sq1 < 0 && sr1 < 0)) {
-#  ifdef PERFDEBUG
-    incperfcount(2); /* Tri tri intersects decided by filter plane tests. */
-#  endif
-    if (dbg_level > 0) {
-      std::cout << "no intersection, all t1's verts above or below t2\n";
-    }
-    return ITT_value(INONE);
-  }
-
-  const double3 &d_n1 = tri1.plane->norm;
-  const double3 &abs_d_p2 = double3::abs(d_p2);
-  const double3 &abs_d_q2 = double3::abs(d_q2);
-  const double3 &abs_d_n1 = double3::abs(d_n1);
-
-  int sp2 = filter_plane_side(d_p2, d_r1, d_n1, abs_d_p2, abs_d_r1, abs_d_n1);
-  int sq2 = filter_plane_side(d_q2, d_r1, d_n1, abs_d_q2, abs_d_r1, abs_d_n1);
-  int sr2 = filter_plane_side(d_r2, d_r1, d_n1, abs_d_r2, abs_d_r1, abs_d_n1);
-  if ((sp2 > 0 && sq2 > 0 && sr2 > 0) || (sp2 < 0 && sq2 < 0 && sr2 < 0)) {
-#  ifdef PERFDEBUG
-    incperfcount(2); /* Tri tri intersects decided by filter plane tests. */
-#  endif
-    if (dbg_level > 0) {
-      std::cout << "no intersection, all t2's verts above or below t1\n";
-    }
-    return ITT_value(INONE);
-  }
+  int sp2 = filter_orient3d(d_p2, d_p1, d_q1, d_r1);
+  int sq2 = filter_orient3d(d_q2, d_p1, d_q1, d_r1);
+  int sr2 = filter_orient3d(d_r2, d_p1, d_q1, d_r1);
+  BLI_assert(!((sp2 > 0 && sq2 > 0 && sr2 > 0) || (sp2 < 0 && sq2 < 0 && sr2 < 0)));
 
   const mpq3 &p1 = vp1->co_exact;
   const mpq3 &q1 = vq1->co_exact;
@@ -2138,6 +2153,10 @@ struct OverlapIttsData {
   Map<std::pair<int, int>, ITT_value> &itt_map;
   const IMesh &tm;
   IMeshArena *arena;
+  /* Pairs that don't intersect according to #tri_tri_filter_disjoint. */
+  Array<bool> pair_is_disjoint;
+  /* Triangles that need an exact plane because they are in a pair the filter can't decide. */
+  Array<bool> tri_needs_plane;
 
   OverlapIttsData(Map<std::pair<int, int>, ITT_value> &itt_map, const IMesh &tm, IMeshArena *arena)
       : itt_map(itt_map), tm(tm), arena(arena)
@@ -2177,6 +2196,26 @@ static void calc_overlap_itts_range_func(void *__restrict userdata,
   data->itt_map.add_overwrite(tri_pair, itt);
 }
 
+static void filter_overlap_itts_range_func(void *__restrict userdata,
+                                           const int iter,
+                                           const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  OverlapIttsData *data = static_cast<OverlapIttsData *>(userdata);
+  std::pair<int, int> tri_pair = data->intersect_pairs[iter];
+  data->pair_is_disjoint[iter] = tri_tri_filter_disjoint(*data->tm.face(tri_pair.first),
+                                                         *data->tm.face(tri_pair.second));
+}
+
+static void populate_exact_plane_range_func(void *__restrict userdata,
+                                            const int iter,
+                                            const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  OverlapIttsData *data = static_cast<OverlapIttsData *>(userdata);
+  if (data->tri_needs_plane[iter]) {
+    data->tm.face(iter)->populate_plane(true);
+  }
+}
+
 /**
  * Fill in itt_map with the vector of ITT_values that result from intersecting the triangles in ov.
  * Use a canonical order for triangles: (a,b) where  a < b.
@@ -2197,11 +2236,38 @@ static void calc_overlap_itts(Map<std::pair<int, int>, ITT_value> &itt_map,
       data.intersect_pairs.append(key);
     }
   }
-  int tot_intersect_pairs = data.intersect_pairs.size();
   TaskParallelSettings settings;
   BLI_parallel_range_settings_defaults(&settings);
   settings.min_iter_per_thread = 1000;
   settings.use_threading = intersect_use_threading;
+
+  /* Most overlapping pairs don't intersect, and that can usually be decided with double
+   * arithmetic. Only the remaining pairs need exact planes and the exact intersection test,
+   * which keeps the expensive rational arithmetic to the near-degenerate cases. The dummy
+   * #INONE values in `itt_map` are already the answer for the disjoint pairs. */
+  const int tot_candidate_pairs = data.intersect_pairs.size();
+  data.pair_is_disjoint = Array<bool>(tot_candidate_pairs);
+  BLI_task_parallel_range(0, tot_candidate_pairs, &data, filter_overlap_itts_range_func, &settings);
+
+  data.tri_needs_plane = Array<bool>(tm.face_size(), false);
+  Vector<std::pair<int, int>> undecided_pairs;
+  for (int i : data.intersect_pairs.index_range()) {
+    if (!data.pair_is_disjoint[i]) {
+      const std::pair<int, int> &tri_pair = data.intersect_pairs[i];
+      data.tri_needs_plane[tri_pair.first] = true;
+      data.tri_needs_plane[tri_pair.second] = true;
+      undecided_pairs.append(tri_pair);
+    }
+  }
+#  ifdef PERFDEBUG
+  bumpperfcount(2, tot_candidate_pairs - undecided_pairs.size());
+#  endif
+  data.intersect_pairs = std::move(undecided_pairs);
+
+  /* Every triangle only writes its own plane, so this can be done in parallel. */
+  BLI_task_parallel_range(0, tm.face_size(), &data, populate_exact_plane_range_func, &settings);
+
+  int tot_intersect_pairs = data.intersect_pairs.size();
   BLI_task_parallel_range(0, tot_intersect_pairs, &data, calc_overlap_itts_range_func, &settings);
 }
 
@@ -2253,7 +2319,10 @@ static void calc_subdivided_tri_range_func(void *__restrict userdata,
               << " len=" << otr.len << "\n";
   }
   constexpr int inline_capacity = 100;
-  Vector<ITT_value, inline_capacity> itts(otr.len);
+  /* Only the pairs that really intersect, the triangle is kept as it is if there are none.
+   * Triangles whose overlaps were all decided by #tri_tri_filter_disjoint have no exact plane. */
+  Vector<ITT_value, inline_capacity> itts;
+  itts.reserve(otr.len);
   for (int j = otr.overlap_start; j < otr.overlap_start + otr.len; ++j) {
     int t_other = data->overlap[j].indexB;
     std::pair<int, int> key = canon_int_pair(t, t_other);
@@ -2672,15 +2741,7 @@ IMesh trimesh_nary_intersect(const IMesh &tm_in,
   double overlap_time = PIL_check_seconds_timer();
   std::cout << "intersect overlaps calculated, time = " << overlap_time - bb_calc_time << "\n";
 #  endif
-  for (int t : tm_clean->face_index_range()) {
-    if (tri_ov.first_overlap_index(t) != -1) {
-      tm_clean->face(t)->populate_plane(true);
-    }
-  }
-#  ifdef PERFDEBUG
-  double plane_populate = PIL_check_seconds_timer();
-  std::cout << "planes populated, time = " << plane_populate - overlap_time << "\n";
-#  endif
+  /* Exact planes are populated by #calc_overlap_itts, only for the triangles that need them. */
   /* itt_map((a,b)) will hold the intersection value resulting from intersecting
    * triangles with indices a and b, where a < b. */
   Map<std::pair<int, int>, ITT_value> itt_map;
@@ -2688,7 +2749,7 @@ IMesh trimesh_nary_intersect(const IMesh &tm_in,
   calc_overlap_itts(itt_map, *tm_clean, tri_ov, arena);
 #  ifdef PERFDEBUG
   double itt_time = PIL_check_seconds_timer();
-  std::cout << "itts found, time = " << itt_time - plane_populate << "\n";
+  std::cout << "itts found, time = " << itt_time - overlap_time << "\n";
 #  endif
   CoplanarClusterInfo clinfo = find_clusters(*tm_clean, tri_bb, itt_map);
   if (dbg_level > 1) {
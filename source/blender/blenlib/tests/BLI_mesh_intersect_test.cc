@@ -9,6 +9,7 @@
 #include "PIL_time.h"
 
 #include "BLI_array.hh"
+#include "BLI_math_boolean.hh"
 #include "BLI_math_mpq.hh"
 #include "BLI_mesh_intersect.hh"
 #include "BLI_mpq3.hh"
@@ -734,6 +735,73 @@ TEST(mesh_intersect, RectCross)
     write_obj_mesh(out, "test_rectcross");
   }
 }
+
+/* Points on the plane z = x/3 + y/7 and points 1e-30 above or below it, which have the same
+ * double approximations. Only exact arithmetic can tell them apart. */
+TEST(mesh_intersect, Orient3dFilteredNearDegenerate)
+{
+  IMeshArena arena;
+  const mpq_class eps("1/1000000000000000000000000000000");
+  const Vert *a = arena.add_or_find_vert(mpq3(0, 0, 0), 0);
+  const Vert *b = arena.add_or_find_vert(mpq3(1, 0, mpq_class(1, 3)), 1);
+  const Vert *c = arena.add_or_find_vert(mpq3(0, 1, mpq_class(1, 7)), 2);
+  const mpq_class z(92, 1155);
+  const Vert *d_on = arena.add_or_find_vert(mpq3(mpq_class(1, 5), mpq_class(1, 11), z), 3);
+  const Vert *d_above = arena.add_or_find_vert(
+      mpq3(mpq_class(1, 5), mpq_class(1, 11), z + eps), 4);
+  const Vert *d_below = arena.add_or_find_vert(
+      mpq3(mpq_class(1, 5), mpq_class(1, 11), z - eps), 5);
+
+  EXPECT_EQ(d_above->co, d_on->co);
+  EXPECT_EQ(d_below->co, d_on->co);
+
+  EXPECT_EQ(orient3d_filtered(a, b, c, d_on), 0);
+  const int orient_above = orient3d_filtered(a, b, c, d_above);
+  const int orient_below = orient3d_filtered(a, b, c, d_below);
+  EXPECT_NE(orient_above, 0);
+  EXPECT_EQ(orient_below, -orient_above);
+  EXPECT_EQ(orient_above, orient3d(a->co_exact, b->co_exact, c->co_exact, d_above->co_exact));
+}
+
+/* The second triangle lies inside the first one on the plane z = x/3 + y/7, or 1e-30 above
+ * it. The double filters can't tell the two apart, so both pairs take the exact path of
+ * #intersect_tri_tri. */
+TEST(mesh_intersect, NearCoplanarTriTri)
+{
+  const char *spec_coplanar = R"(6 2
+  0 0 0
+  1 0 1/3
+  0 1 1/7
+  1/5 1/11 92/1155
+  1/2 1/5 41/210
+  1/7 1/2 5/42
+  0 1 2
+  3 4 5
+  )";
+
+  IMeshBuilder mb_coplanar(spec_coplanar);
+  IMesh out_coplanar = trimesh_self_intersect(mb_coplanar.imesh, &mb_coplanar.arena);
+  out_coplanar.populate_vert();
+  EXPECT_EQ(out_coplanar.vert_size(), 6);
+  EXPECT_GT(out_coplanar.face_size(), 2);
+
+  const char *spec_offset = R"(6 2
+  0 0 0
+  1 0 1/3
+  0 1 1/7
+  1/5 1/11 18400000000000000000000000000231/231000000000000000000000000000000
+  1/2 1/5 4100000000000000000000000000021/21000000000000000000000000000000
+  1/7 1/2 2500000000000000000000000000021/21000000000000000000000000000000
+  0 1 2
+  3 4 5
+  )";
+
+  IMeshBuilder mb_offset(spec_offset);
+  IMesh out_offset = trimesh_self_intersect(mb_offset.imesh, &mb_offset.arena);
+  out_offset.populate_vert();
+  EXPECT_EQ(out_offset.vert_size(), 6);
+  EXPECT_EQ(out_offset.face_size(), 2);
+}
 #  endif
 
 #  if DO_PERF_TESTS
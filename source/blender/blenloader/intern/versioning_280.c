@@ -3434,7 +3434,7 @@ void blo_do_versions_280(FileData *fd, Library *UNUSED(lib), Main *bmain)
             }
             case SPACE_NODE: {
               SpaceNode *snode = (SpaceNode *)sl;
-              snode->flag &= ~(SNODE_FLAG_UNUSED_6 | SNODE_FLAG_UNUSED_10 | SNODE_FLAG_UNUSED_11);
+              snode->flag &= ~(SNODE_SHOW_NODE_STATS | SNODE_FLAG_UNUSED_10 | SNODE_FLAG_UNUSED_11);
               break;
             }
             case SPACE_PROPERTIES: {
@@ -161,6 +161,8 @@ typedef struct DEGObjectIterData {
   struct Object *dupli_parent;
   /* List of duplicated objects. */
   struct ListBase *dupli_list;
+  /* Stream of duplicated objects, used instead of the list when possible. */
+  struct DupliStream *dupli_stream;
   /* Next duplicated object to step into. */
   struct DupliObject *dupli_object_next;
   /* Corresponds to current object: current iterator object is evaluated from
@@ -188,23 +188,58 @@ void deg_iterator_duplis_init(DEGObjectIterData *data, Object *object)
   if ((data->flag & DEG_ITER_OBJECT_FLAG_DUPLI) &&
       ((object->transflag & OB_DUPLI) || object->runtime.geometry_set_eval != nullptr)) {
     data->dupli_parent = object;
-    data->dupli_list = object_duplilist(data->graph, data->scene, object);
-    data->dupli_object_next = (DupliObject *)data->dupli_list->first;
+    /* Instances of geometry sets are streamed without allocating every dupli object. */
+    data->dupli_stream = object_dupli_stream_begin(data->graph, data->scene, object);
+    if (data->dupli_stream == nullptr) {
+      data->dupli_list = object_duplilist(data->graph, data->scene, object);
+      data->dupli_object_next = (DupliObject *)data->dupli_list->first;
+    }
+  }
+}
+
+DupliObject *deg_iterator_duplis_next(DEGObjectIterData *data)
+{
+  if (data->dupli_stream != nullptr) {
+    return object_dupli_stream_next(data->dupli_stream);
+  }
+  DupliObject *dob = data->dupli_object_next;
+  if (dob != nullptr) {
+    data->dupli_object_next = dob->next;
+  }
+  return dob;
+}
+
+void deg_iterator_duplis_free(DEGObjectIterData *data)
+{
+  if (data->dupli_stream != nullptr) {
+    object_dupli_stream_end(data->dupli_stream);
+  }
+  if (data->dupli_list != nullptr) {
+    free_object_duplilist(data->dupli_list);
   }
+  data->dupli_parent = nullptr;
+  data->dupli_list = nullptr;
+  data->dupli_stream = nullptr;
+  data->dupli_object_next = nullptr;
+  data->dupli_object_current = nullptr;
 }
 
 /* Returns false when iterator is exhausted. */
 bool deg_iterator_duplis_step(DEGObjectIterData *data)
 {
-  if (data->dupli_list == nullptr) {
+  if (data->dupli_list == nullptr && data->dupli_stream == nullptr) {
     return false;
   }
 
-  while (data->dupli_object_next != nullptr) {
-    DupliObject *dob = data->dupli_object_next;
-    Object *obd = dob->ob;
+  while (true) {
+    /* Free properties of the current object before a streamed batch may overwrite it. */
+    verify_id_properties_freed(data);
 
-    data->dupli_object_next = data->dupli_object_next->next;
+    DupliObject *dob = deg_iterator_duplis_next(data);
+    if (dob == nullptr) {
+      break;
+    }
+    Object *obd = dob->ob;
 
     if (dob->no_draw) {
       continue;
@@ -216,8 +251,6 @@ bool deg_iterator_duplis_step(DEGObjectIterData *data)
       continue;
     }
 
-    verify_id_properties_freed(data);
-
     data->dupli_object_current = dob;
 
     /* Temporary object to evaluate. */
@@ -252,12 +285,7 @@ bool deg_iterator_duplis_step(DEGObjectIterData *data)
     return true;
   }
 
-  verify_id_properties_freed(data);
-  free_object_duplilist(data->dupli_list);
-  data->dupli_parent = nullptr;
-  data->dupli_list = nullptr;
-  data->dupli_object_next = nullptr;
-  data->dupli_object_current = nullptr;
+  deg_iterator_duplis_free(data);
   deg_invalidate_iterator_work_data(data);
   return false;
 }
@@ -334,15 +362,17 @@ void DEG_iterator_objects_begin(BLI_Iterator *iter, DEGObjectIterData *data)
 
   iter->data = data;
 
+  data->dupli_parent = nullptr;
+  data->dupli_list = nullptr;
+  data->dupli_stream = nullptr;
+  data->dupli_object_next = nullptr;
+  data->dupli_object_current = nullptr;
+
   if (num_id_nodes == 0) {
     iter->valid = false;
     return;
   }
 
-  data->dupli_parent = nullptr;
-  data->dupli_list = nullptr;
-  data->dupli_object_next = nullptr;
-  data->dupli_object_current = nullptr;
   data->scene = DEG_get_evaluated_scene(depsgraph);
   data->id_node_index = 0;
   data->num_id_nodes = num_id_nodes;
@@ -622,6 +622,47 @@ static void mesh_batch_cache_discard_uvedit_select(MeshBatchCache *cache)
   cache->batch_ready &= ~MBC_EDITUV;
 }
 
+/* Discard everything depending on vertex positions, keeping the index buffers and the vertex
+ * buffers which only depend on topology, UVs or selection. */
+static void mesh_batch_cache_discard_deform(MeshBatchCache *cache)
+{
+  FOREACH_MESH_BUFFER_CACHE (cache, mbufcache) {
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.pos_nor);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.lnor);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.edge_fac);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.tan);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.stretch_area);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.stretch_angle);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.mesh_analysis);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.fdots_pos);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.fdots_nor);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.skin_roots);
+  }
+
+  /* Nearly all batches use `pos_nor`, only the UV editor batches are kept. */
+  GPUBatch **batch = (GPUBatch **)&cache->batch;
+  for (int i = 0; i < sizeof(cache->batch) / sizeof(void *); i++) {
+    if (ELEM(&batch[i],
+             &cache->batch.edituv_faces,
+             &cache->batch.edituv_edges,
+             &cache->batch.edituv_verts,
+             &cache->batch.edituv_fdots,
+             &cache->batch.wire_loops_uvs)) {
+      continue;
+    }
+    GPU_BATCH_DISCARD_SAFE(batch[i]);
+  }
+  GPU_BATCH_DISCARD_SAFE(cache->batch.edituv_faces_stretch_area);
+  GPU_BATCH_DISCARD_SAFE(cache->batch.edituv_faces_stretch_angle);
+  mesh_batch_cache_discard_surface_batches(cache);
+
+  cache->tot_area = 0.0f;
+  cache->tot_uv_area = 0.0f;
+
+  cache->batch_ready &= (MBC_EDITUV_FACES | MBC_EDITUV_EDGES | MBC_EDITUV_VERTS |
+                         MBC_EDITUV_FACEDOTS | MBC_WIRE_LOOPS_UVS);
+}
+
 void DRW_mesh_batch_cache_dirty_tag(Mesh *me, eMeshBatchDirtyMode mode)
 {
   MeshBatchCache *cache = me->runtime.batch_cache;
@@ -667,6 +708,9 @@ void DRW_mesh_batch_cache_dirty_tag(Mesh *me, eMeshBatchDirtyMode mode)
     case BKE_MESH_BATCH_DIRTY_ALL:
       cache->is_dirty = true;
       break;
+    case BKE_MESH_BATCH_DIRTY_DEFORM:
+      mesh_batch_cache_discard_deform(cache);
+      break;
     case BKE_MESH_BATCH_DIRTY_SHADING:
       mesh_batch_cache_discard_shaded_tri(cache);
       mesh_batch_cache_discard_uvedit(cache);
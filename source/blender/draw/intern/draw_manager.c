@@ -733,20 +733,23 @@ static void drw_duplidata_load(DupliObject *dupli)
 
   void **value;
   if (!BLI_ghash_ensure_p(DST.dupli_ghash, DST.dupli_origin, &value)) {
-    *value = MEM_callocN(sizeof(void *) * DST.enabled_engine_count, __func__);
+    DRWDupliData *dupli_data = MEM_callocN(
+        sizeof(DRWDupliData) + sizeof(void *) * DST.enabled_engine_count, __func__);
+    dupli_data->handle_reserve = 1;
+    *value = dupli_data;
 
     /* TODO: Meh a bit out of place but this is nice as it is
      * only done once per "original" object. */
     drw_batch_cache_validate(DST.dupli_origin);
   }
-  DST.dupli_datas = *(void ***)value;
+  DST.dupli_data = *(DRWDupliData **)value;
 }
 
 static void duplidata_value_free(void *val)
 {
-  void **dupli_datas = val;
+  DRWDupliData *dupli_data = val;
   for (int i = 0; i < DST.enabled_engine_count; i++) {
-    MEM_SAFE_FREE(dupli_datas[i]);
+    MEM_SAFE_FREE(dupli_data->engine_datas[i]);
   }
   MEM_freeN(val);
 }
@@ -759,6 +762,8 @@ static void drw_duplidata_free(void)
                    duplidata_value_free);
     DST.dupli_ghash = NULL;
   }
+  DST.dupli_origin = NULL;
+  DST.dupli_data = NULL;
 }
 
 /* Return NULL if not a dupli or a pointer of pointer to the engine data */
@@ -770,7 +775,7 @@ void **DRW_duplidata_get(void *vedata)
   /* XXX Search engine index by using vedata array */
   for (int i = 0; i < DST.enabled_engine_count; i++) {
     if (DST.vedata_array[i] == vedata) {
-      return &DST.dupli_datas[i];
+      return &DST.dupli_data->engine_datas[i];
     }
   }
   return NULL;
@@ -163,6 +163,22 @@ BLI_INLINE void *DRW_memblock_elem_from_handle(struct BLI_memblock *memblock,
   return BLI_memblock_elem_get(memblock, chunk, elem);
 }
 
+/**
+ * Data shared by all dupli instances of an original object while populating the cache.
+ */
+typedef struct DRWDupliData {
+  /**
+   * Resource handles reserved for the next instances. Instances of the same object get
+   * consecutive resource ids so their draw calls are merged into instanced draws.
+   */
+  DRWResourceHandle handle_next;
+  uint handle_len;
+  /** Number of handles reserved when running out, grows with the instance count. */
+  uint handle_reserve;
+  /** One for each enabled engine, see #DRW_duplidata_get. */
+  void *engine_datas[0];
+} DRWDupliData;
+
 typedef struct DRWObjectMatrix {
   float model[4][4];
   float modelinverse[4][4];
@@ -506,8 +522,8 @@ typedef struct DRWManager {
   struct GHash *dupli_ghash;
   /** TODO(fclem): try to remove usage of this. */
   DRWInstanceData *object_instance_data[MAX_INSTANCE_DATA_SIZE];
-  /* Array of dupli_data (one for each enabled engine) to handle duplis. */
-  void **dupli_datas;
+  /* Data of the current dupli origin object. */
+  struct DRWDupliData *dupli_data;
 
   /* Rendering state */
   GPUShader *shader;
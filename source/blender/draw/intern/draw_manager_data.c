@@ -555,17 +555,64 @@ static void drw_call_culling_init(DRWCullingState *cull, Object *ob)
   cull->user_data = NULL;
 }
 
+/**
+ * Reserve consecutive resource handles for the instances of the current dupli origin.
+ *
+ * Dupli instances are iterated interleaved with the instances of other objects (collection
+ * instances iterate all their objects per instance). Reserving handles per origin object gives
+ * each object's instances consecutive resource ids, so their draw calls using the same batch are
+ * merged into instanced draws by #draw_call_batching_do. Reservations grow geometrically and
+ * never cross a resource chunk, unused handles are bypassed by culling and never referenced.
+ */
+static DRWResourceHandle *drw_resource_handle_dupli_next(DRWDupliData *dupli_data)
+{
+  if (dupli_data->handle_len == 0) {
+    const int elem_id = DRW_handle_id_get(&DST.resource_handle);
+    const int len = min_ii(dupli_data->handle_reserve, DRW_RESOURCE_CHUNK_LEN - elem_id);
+
+    dupli_data->handle_next = DST.resource_handle;
+    dupli_data->handle_len = len;
+    dupli_data->handle_reserve = min_ii(dupli_data->handle_reserve * 2, DRW_RESOURCE_CHUNK_LEN);
+
+    for (int i = 0; i < len; i++) {
+      DRWCullingState *culling = BLI_memblock_alloc(DST.vmempool->cullstates);
+      DRWObjectMatrix *ob_mats = BLI_memblock_alloc(DST.vmempool->obmats);
+      DRWObjectInfos *ob_infos = BLI_memblock_alloc(DST.vmempool->obinfos);
+      UNUSED_VARS(ob_mats, ob_infos);
+      culling->bsphere.radius = -1.0f;
+      culling->user_data = NULL;
+      DRW_handle_increment(&DST.resource_handle);
+    }
+  }
+  return &dupli_data->handle_next;
+}
+
 static DRWResourceHandle drw_resource_handle_new(float (*obmat)[4], Object *ob)
 {
-  DRWCullingState *culling = BLI_memblock_alloc(DST.vmempool->cullstates);
-  DRWObjectMatrix *ob_mats = BLI_memblock_alloc(DST.vmempool->obmats);
-  /* FIXME Meh, not always needed but can be accessed after creation.
-   * Also it needs to have the same resource handle. */
-  DRWObjectInfos *ob_infos = BLI_memblock_alloc(DST.vmempool->obinfos);
-  UNUSED_VARS(ob_infos);
+  DRWResourceHandle handle;
+  DRWCullingState *culling;
+  DRWObjectMatrix *ob_mats;
 
-  DRWResourceHandle handle = DST.resource_handle;
-  DRW_handle_increment(&DST.resource_handle);
+  if (ob && DST.dupli_source && DST.dupli_data) {
+    DRWResourceHandle *handle_next = drw_resource_handle_dupli_next(DST.dupli_data);
+    handle = *handle_next;
+    DRW_handle_increment(handle_next);
+    DST.dupli_data->handle_len--;
+
+    culling = DRW_memblock_elem_from_handle(DST.vmempool->cullstates, &handle);
+    ob_mats = DRW_memblock_elem_from_handle(DST.vmempool->obmats, &handle);
+  }
+  else {
+    culling = BLI_memblock_alloc(DST.vmempool->cullstates);
+    ob_mats = BLI_memblock_alloc(DST.vmempool->obmats);
+    /* FIXME Meh, not always needed but can be accessed after creation.
+     * Also it needs to have the same resource handle. */
+    DRWObjectInfos *ob_infos = BLI_memblock_alloc(DST.vmempool->obinfos);
+    UNUSED_VARS(ob_infos);
+
+    handle = DST.resource_handle;
+    DRW_handle_increment(&DST.resource_handle);
+  }
 
   if (ob && (ob->transflag & OB_NEG_SCALE)) {
     DRW_handle_negative_scale_enable(&handle);
@@ -583,7 +630,12 @@ uint32_t DRW_object_resource_id_get(Object *UNUSED(ob))
   DRWResourceHandle handle = DST.ob_handle;
   if (handle == 0) {
     /* Handle not yet allocated. Return next handle. */
-    handle = DST.resource_handle;
+    if (DST.dupli_source && DST.dupli_data) {
+      handle = *drw_resource_handle_dupli_next(DST.dupli_data);
+    }
+    else {
+      handle = DST.resource_handle;
+    }
   }
   return handle & ~(1u << 31);
 }
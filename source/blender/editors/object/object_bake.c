@@ -288,6 +288,7 @@ static void clear_single_image(Image *image, ClearFlag flag)
 
   if ((image->id.tag & LIB_TAG_DOIT) == 0) {
     ImBuf *ibuf = BKE_image_acquire_ibuf(image, NULL, NULL);
+    ibuf = BKE_image_ibuf_ensure_writable(image, ibuf);
 
     if (flag == CLEAR_TANGENT_NORMAL) {
       IMB_rectfill(ibuf, (ibuf->planes == R_IMF_PLANES_RGBA) ? nor_alpha : nor_solid);
@@ -191,6 +191,8 @@ static bool write_internal_bake_pixels(Image *image,
     return false;
   }
 
+  ibuf = BKE_image_ibuf_ensure_writable(image, ibuf);
+
   if (margin > 0 || !is_clear) {
     mask_buffer = MEM_callocN(sizeof(char) * num_pixels, "Bake Mask");
     RE_bake_mask_fill(pixel_array, num_pixels, mask_buffer);
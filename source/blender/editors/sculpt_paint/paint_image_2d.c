@@ -933,6 +933,7 @@ static bool paint_2d_ensure_tile_canvas(ImagePaintState *s, int i)
   s->tiles[i].iuser.ok = true;
 
   ImBuf *ibuf = BKE_image_acquire_ibuf(s->image, &s->tiles[i].iuser, NULL);
+  ibuf = BKE_image_ibuf_ensure_writable(s->image, ibuf);
   if (ibuf != NULL) {
     if (ibuf->channels != 4) {
       s->tiles[i].state = PAINT2D_TILE_MISSING;
@@ -1525,7 +1526,7 @@ static int paint_2d_canvas_set(ImagePaintState *s)
       return 0;
     }
 
-    s->clonecanvas = ibuf;
+    s->clonecanvas = BKE_image_ibuf_ensure_writable(ima, ibuf);
 
     /* temporarily add float rect for cloning */
     if (s->tiles[0].canvas->rect_float && !s->clonecanvas->rect_float) {
@@ -1703,6 +1704,7 @@ void *paint_2d_new_stroke(bContext *C, wmOperator *op, int mode)
   zero_v2(s->tiles[0].uv_origin);
 
   ImBuf *ibuf = BKE_image_acquire_ibuf(s->image, &s->tiles[0].iuser, NULL);
+  ibuf = BKE_image_ibuf_ensure_writable(s->image, ibuf);
   if (ibuf == NULL) {
     MEM_freeN(s->tiles);
     MEM_freeN(s);
@@ -1921,6 +1923,7 @@ void paint_2d_bucket_fill(const bContext *C,
   }
 
   ibuf = BKE_image_acquire_ibuf(ima, iuser, NULL);
+  ibuf = BKE_image_ibuf_ensure_writable(ima, ibuf);
   if (!ibuf) {
     return;
   }
@@ -2133,6 +2136,7 @@ void paint_2d_gradient_fill(
   }
 
   ibuf = BKE_image_acquire_ibuf(ima, iuser, NULL);
+  ibuf = BKE_image_ibuf_ensure_writable(ima, ibuf);
   if (ibuf == NULL) {
     return;
   }
@@ -4251,6 +4251,7 @@ static void project_paint_build_proj_ima(ProjPaintState *ps,
       projIma->ibuf = BKE_image_acquire_ibuf(projIma->ima, &projIma->iuser, NULL);
       BLI_assert(projIma->ibuf != NULL);
     }
+    projIma->ibuf = BKE_image_ibuf_ensure_writable(projIma->ima, projIma->ibuf);
     size = sizeof(void **) * ED_IMAGE_UNDO_TILE_NUMBER(projIma->ibuf->x) *
            ED_IMAGE_UNDO_TILE_NUMBER(projIma->ibuf->y);
     projIma->partRedrawRect = BLI_memarena_alloc(
@@ -6072,6 +6073,8 @@ static int texture_paint_camera_project_exec(bContext *C, wmOperator *op)
 
   ps.reproject_image = image;
   ps.reproject_ibuf = BKE_image_acquire_ibuf(image, NULL, NULL);
+  /* Missing byte or float buffers are added temporarily. */
+  ps.reproject_ibuf = BKE_image_ibuf_ensure_writable(image, ps.reproject_ibuf);
 
   if ((ps.reproject_ibuf == NULL) ||
       ((ps.reproject_ibuf->rect || ps.reproject_ibuf->rect_float) == false)) {
@@ -579,6 +579,16 @@ typedef struct SculptUndoNode {
   float (*col)[4];
   float *mask;
   int totvert;
+  /* Length of the per vertex arrays, includes vertices not owned by the PBVH node. */
+  int allvert;
+
+  /* Per vertex arrays of undo steps which are not active are packed into a single compressed
+   * buffer, see sculpt_undo.c. The buffer is NULL while it is spilled to disk, then the offset
+   * points into the spill file of the undo step. */
+  void *packed;
+  size_t packed_size;
+  size_t packed_offset;
+  int packed_flag;
 
   /* non-multires */
   int maxvert; /* to verify if totvert it still the same */
@@ -26,9 +26,11 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_fileops.h"
 #include "BLI_ghash.h"
 #include "BLI_listbase.h"
 #include "BLI_math.h"
+#include "BLI_path_util.h"
 #include "BLI_string.h"
 #include "BLI_task.h"
 #include "BLI_threads.h"
@@ -40,6 +42,7 @@
 #include "DNA_scene_types.h"
 #include "DNA_screen_types.h"
 
+#include "BKE_appdir.h"
 #include "BKE_ccg.h"
 #include "BKE_context.h"
 #include "BKE_customdata.h"
@@ -70,6 +73,15 @@
 #include "bmesh.h"
 #include "sculpt_intern.h"
 
+#ifdef WITH_LZO
+#  ifdef WITH_SYSTEM_LZO
+#    include <lzo/lzo1x.h>
+#  else
+#    include "minilzo.h"
+#  endif
+#  define LZO_OUT_LEN(size) ((size) + (size) / 16 + 64 + 3)
+#endif
+
 /* Implementation of undo system for objects in sculpt mode.
  *
  * Each undo step in sculpt mode consists of list of nodes, each node contains:
@@ -107,15 +119,28 @@
  * does modifications on it.
  *
  * End of dynamic topology and symmetrize in this mode are handled in a special
- * manner as well. */
+ * manner as well.
+ *
+ * Only the active step is read while sculpting, the per vertex arrays of all other steps are
+ * packed into compressed buffers and unpacked again for undo and redo. Steps far down the stack
+ * move these buffers into a temporary file. */
 
 typedef struct UndoSculpt {
   ListBase nodes;
 
   size_t undo_size;
+
+  /* Per vertex arrays of the nodes are packed. */
+  bool is_packed;
+  /* Packed buffers of the nodes are stored in this file instead of in memory. */
+  char *spill_filepath;
+  /* Step was spilled by #sculpt_undosys_stack_pack, or had nothing to spill.
+   * Cleared when the step is unpacked. */
+  bool is_spill_visited;
 } UndoSculpt;
 
 static UndoSculpt *sculpt_undo_get_nodes(void);
+static UndoSculpt *sculpt_undosys_step_get_nodes(UndoStep *us_p);
 
 static void update_cb(PBVHNode *node, void *rebuild)
 {
@@ -857,6 +882,12 @@ static void sculpt_undo_free_list(ListBase *lb)
     if (unode->mask) {
       MEM_freeN(unode->mask);
     }
+    if (unode->col) {
+      MEM_freeN(unode->col);
+    }
+    if (unode->packed) {
+      MEM_freeN(unode->packed);
+    }
 
     if (unode->bm_entry) {
       BM_log_entry_drop(unode->bm_entry);
@@ -985,6 +1016,7 @@ static SculptUndoNode *sculpt_undo_alloc_node(Object *ob, PBVHNode *node, Sculpt
     BKE_pbvh_node_get_grids(ss->pbvh, node, &grids, &totgrid, &maxgrid, &gridsize, NULL);
 
     unode->totvert = totvert;
+    unode->allvert = allvert;
   }
   else {
     maxgrid = 0;
@@ -1381,6 +1413,392 @@ void SCULPT_undo_push_end_ex(const bool use_nested_undo)
   }
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Packed Undo Nodes
+ *
+ * The per vertex arrays of a node are packed into one buffer. Every 32 bit component is XOR-ed
+ * with the same component of the previous vertex, which clears the sign, exponent and high
+ * mantissa bits shared by nearby vertices, and the result is split into byte planes before LZO
+ * compression. Packing is lossless, restoring swaps the stored values into the mesh so they have
+ * to round trip exactly.
+ * \{ */
+
+/* Sculpt steps this far down the stack spill their packed buffers to disk. */
+#define SCULPT_UNDO_SPILL_DEPTH 16
+
+enum {
+  SCULPT_UNDO_PACKED_CO = (1 << 0),
+  SCULPT_UNDO_PACKED_ORIG_CO = (1 << 1),
+  SCULPT_UNDO_PACKED_COL = (1 << 2),
+  SCULPT_UNDO_PACKED_MASK = (1 << 3),
+  SCULPT_UNDO_PACKED_INDEX = (1 << 4),
+  SCULPT_UNDO_PACKED_LZO = (1 << 5),
+};
+
+#define SCULPT_UNDO_PACKED_ARRAYS_NUM 5
+
+typedef struct SculptUndoPackedArray {
+  void **data;
+  const char *name;
+  int flag;
+  /* Number of 32 bit components per vertex. */
+  int stride;
+} SculptUndoPackedArray;
+
+static void sculpt_undo_packed_arrays_get(SculptUndoNode *unode,
+                                          SculptUndoPackedArray r_arrays[])
+{
+  BLI_STATIC_ASSERT(sizeof(float) == sizeof(uint32_t) && sizeof(int) == sizeof(uint32_t),
+                    "Packing expects 32 bit components");
+
+  const SculptUndoPackedArray arrays[SCULPT_UNDO_PACKED_ARRAYS_NUM] = {
+      {(void **)&unode->co, "SculptUndoNode.co", SCULPT_UNDO_PACKED_CO, 3},
+      {(void **)&unode->orig_co, "undoSculpt orig_cos", SCULPT_UNDO_PACKED_ORIG_CO, 3},
+      {(void **)&unode->col, "SculptUndoNode.col", SCULPT_UNDO_PACKED_COL, 4},
+      {(void **)&unode->mask, "SculptUndoNode.mask", SCULPT_UNDO_PACKED_MASK, 1},
+      {(void **)&unode->index, "SculptUndoNode.index", SCULPT_UNDO_PACKED_INDEX, 1},
+  };
+  memcpy(r_arrays, arrays, sizeof(arrays));
+}
+
+static bool sculpt_undo_node_can_pack(const SculptUndoNode *unode)
+{
+  return ELEM(unode->type, SCULPT_UNDO_COORDS, SCULPT_UNDO_MASK, SCULPT_UNDO_COLOR) &&
+         (unode->allvert > 0) && (unode->no == NULL);
+}
+
+static size_t sculpt_undo_packed_words_num(const SculptUndoNode *unode,
+                                           const SculptUndoPackedArray arrays[],
+                                           const int flag)
+{
+  size_t words_num = 0;
+  for (int i = 0; i < SCULPT_UNDO_PACKED_ARRAYS_NUM; i++) {
+    if (flag & arrays[i].flag) {
+      words_num += (size_t)arrays[i].stride * (size_t)unode->allvert;
+    }
+  }
+  return words_num;
+}
+
+static void sculpt_undo_node_pack(SculptUndoNode *unode)
+{
+  if (unode->packed_flag != 0 || !sculpt_undo_node_can_pack(unode)) {
+    return;
+  }
+
+  SculptUndoPackedArray arrays[SCULPT_UNDO_PACKED_ARRAYS_NUM];
+  sculpt_undo_packed_arrays_get(unode, arrays);
+
+  int flag = 0;
+  for (int i = 0; i < SCULPT_UNDO_PACKED_ARRAYS_NUM; i++) {
+    if (*arrays[i].data) {
+      flag |= arrays[i].flag;
+    }
+  }
+  if (flag == 0) {
+    return;
+  }
+
+  const size_t words_num = sculpt_undo_packed_words_num(unode, arrays, flag);
+  const size_t size = words_num * sizeof(uint32_t);
+  uchar *planes = MEM_mallocN(size, "SculptUndoNode.packed");
+
+  size_t word = 0;
+  for (int i = 0; i < SCULPT_UNDO_PACKED_ARRAYS_NUM; i++) {
+    if ((flag & arrays[i].flag) == 0) {
+      continue;
+    }
+    const uint32_t *src = *arrays[i].data;
+    const size_t stride = (size_t)arrays[i].stride;
+    const size_t len = stride * (size_t)unode->allvert;
+    for (size_t j = 0; j < len; j++, word++) {
+      const uint32_t value = (j < stride) ? src[j] : (src[j] ^ src[j - stride]);
+      planes[word] = (uchar)value;
+      planes[words_num + word] = (uchar)(value >> 8);
+      planes[words_num * 2 + word] = (uchar)(value >> 16);
+      planes[words_num * 3 + word] = (uchar)(value >> 24);
+    }
+    MEM_freeN(*arrays[i].data);
+    *arrays[i].data = NULL;
+  }
+
+  unode->packed = planes;
+  unode->packed_size = size;
+
+#ifdef WITH_LZO
+  lzo_uint out_len = LZO_OUT_LEN(size);
+  uchar *out = MEM_mallocN(out_len, "SculptUndoNode.packed");
+  void *wrkmem = MEM_mallocN(LZO1X_MEM_COMPRESS, __func__);
+  if ((lzo1x_1_compress(planes, (lzo_uint)size, out, &out_len, wrkmem) == LZO_E_OK) &&
+      (out_len < size)) {
+    MEM_freeN(planes);
+    unode->packed = MEM_reallocN(out, out_len);
+    unode->packed_size = out_len;
+    flag |= SCULPT_UNDO_PACKED_LZO;
+  }
+  else {
+    MEM_freeN(out);
+  }
+  MEM_freeN(wrkmem);
+#endif
+
+  unode->packed_flag = flag;
+}
+
+static void sculpt_undo_node_unpack(SculptUndoNode *unode)
+{
+  if (unode->packed_flag == 0) {
+    return;
+  }
+  BLI_assert(unode->packed != NULL);
+
+  SculptUndoPackedArray arrays[SCULPT_UNDO_PACKED_ARRAYS_NUM];
+  sculpt_undo_packed_arrays_get(unode, arrays);
+
+  const int flag = unode->packed_flag;
+  const size_t words_num = sculpt_undo_packed_words_num(unode, arrays, flag);
+  const uchar *planes = unode->packed;
+
+#ifdef WITH_LZO
+  if (flag & SCULPT_UNDO_PACKED_LZO) {
+    lzo_uint out_len = words_num * sizeof(uint32_t);
+    uchar *out = MEM_mallocN(out_len, __func__);
+    const int r = lzo1x_decompress_safe(
+        unode->packed, (lzo_uint)unode->packed_size, out, &out_len, NULL);
+    BLI_assert((r == LZO_E_OK) && (out_len == words_num * sizeof(uint32_t)));
+    UNUSED_VARS_NDEBUG(r);
+    planes = out;
+  }
+#else
+  BLI_assert((flag & SCULPT_UNDO_PACKED_LZO) == 0);
+#endif
+
+  size_t word = 0;
+  for (int i = 0; i < SCULPT_UNDO_PACKED_ARRAYS_NUM; i++) {
+    if ((flag & arrays[i].flag) == 0) {
+      continue;
+    }
+    const size_t stride = (size_t)arrays[i].stride;
+    const size_t len = stride * (size_t)unode->allvert;
+    uint32_t *dst = MEM_mallocN(sizeof(uint32_t) * len, arrays[i].name);
+    for (size_t j = 0; j < len; j++, word++) {
+      const uint32_t value = (uint32_t)planes[word] | ((uint32_t)planes[words_num + word] << 8) |
+                             ((uint32_t)planes[words_num * 2 + word] << 16) |
+                             ((uint32_t)planes[words_num * 3 + word] << 24);
+      dst[j] = (j < stride) ? value : (value ^ dst[j - stride]);
+    }
+    *arrays[i].data = dst;
+  }
+
+  if (planes != unode->packed) {
+    MEM_freeN((void *)planes);
+  }
+  MEM_freeN(unode->packed);
+  unode->packed = NULL;
+  unode->packed_size = 0;
+  unode->packed_flag = 0;
+}
+
+static void sculpt_undo_pack_task_cb(void *__restrict userdata,
+                                     const int n,
+                                     const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  SculptUndoNode **unodes = userdata;
+  sculpt_undo_node_pack(unodes[n]);
+}
+
+static void sculpt_undo_unpack_task_cb(void *__restrict userdata,
+                                       const int n,
+                                       const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  SculptUndoNode **unodes = userdata;
+  sculpt_undo_node_unpack(unodes[n]);
+}
+
+static void sculpt_undo_nodes_foreach_parallel(UndoSculpt *usculpt, TaskParallelRangeFunc func)
+{
+  const int totnode = BLI_listbase_count(&usculpt->nodes);
+  if (totnode == 0) {
+    return;
+  }
+
+  SculptUndoNode **unodes = MEM_mallocN(sizeof(*unodes) * totnode, __func__);
+  int i = 0;
+  LISTBASE_FOREACH (SculptUndoNode *, unode, &usculpt->nodes) {
+    unodes[i++] = unode;
+  }
+
+  TaskParallelSettings settings;
+  BKE_pbvh_parallel_range_settings(&settings, true, totnode);
+  BLI_task_parallel_range(0, totnode, unodes, func, &settings);
+
+  MEM_freeN(unodes);
+}
+
+/* Write the packed buffers of all nodes into a file and free them. */
+static void sculpt_undo_step_spill(UndoSculpt *usculpt)
+{
+  if (!usculpt->is_packed || usculpt->spill_filepath) {
+    return;
+  }
+
+  bool has_packed = false;
+  LISTBASE_FOREACH (SculptUndoNode *, unode, &usculpt->nodes) {
+    if (unode->packed != NULL) {
+      has_packed = true;
+      break;
+    }
+  }
+  if (!has_packed) {
+    return;
+  }
+
+  char filename[64], filepath[FILE_MAX];
+  BLI_snprintf(filename, sizeof(filename), "sculpt_undo_%p.bin", (void *)usculpt);
+  BLI_join_dirfile(filepath, sizeof(filepath), BKE_tempdir_session(), filename);
+
+  FILE *file = BLI_fopen(filepath, "wb");
+  if (file == NULL) {
+    return;
+  }
+
+  bool ok = true;
+  size_t offset = 0;
+  LISTBASE_FOREACH (SculptUndoNode *, unode, &usculpt->nodes) {
+    if (unode->packed == NULL) {
+      continue;
+    }
+    if (fwrite(unode->packed, 1, unode->packed_size, file) != unode->packed_size) {
+      ok = false;
+      break;
+    }
+    unode->packed_offset = offset;
+    offset += unode->packed_size;
+  }
+  fclose(file);
+
+  if (!ok) {
+    BLI_delete(filepath, false, false);
+    return;
+  }
+
+  LISTBASE_FOREACH (SculptUndoNode *, unode, &usculpt->nodes) {
+    MEM_SAFE_FREE(unode->packed);
+  }
+  usculpt->spill_filepath = BLI_strdup(filepath);
+}
+
+/* Read back packed buffers written by #sculpt_undo_step_spill. */
+static void sculpt_undo_step_load(UndoSculpt *usculpt)
+{
+  if (usculpt->spill_filepath == NULL) {
+    return;
+  }
+
+  FILE *file = BLI_fopen(usculpt->spill_filepath, "rb");
+
+  LISTBASE_FOREACH (SculptUndoNode *, unode, &usculpt->nodes) {
+    if (unode->packed_flag == 0 || unode->packed != NULL) {
+      continue;
+    }
+    unode->packed = MEM_mallocN(unode->packed_size, "SculptUndoNode.packed");
+    if (file == NULL || BLI_fseek(file, (int64_t)unode->packed_offset, SEEK_SET) != 0 ||
+        fread(unode->packed, 1, unode->packed_size, file) != unode->packed_size) {
+      /* The data is lost, drop the arrays and clear the name so restoring skips the node. */
+      MEM_SAFE_FREE(unode->packed);
+      unode->packed_size = 0;
+      unode->packed_flag = 0;
+      unode->idname[0] = '\0';
+    }
+  }
+
+  if (file) {
+    fclose(file);
+  }
+  BLI_delete(usculpt->spill_filepath, false, false);
+  MEM_freeN(usculpt->spill_filepath);
+  usculpt->spill_filepath = NULL;
+}
+
+static void sculpt_undo_step_free_spill(UndoSculpt *usculpt)
+{
+  if (usculpt->spill_filepath) {
+    BLI_delete(usculpt->spill_filepath, false, false);
+    MEM_freeN(usculpt->spill_filepath);
+    usculpt->spill_filepath = NULL;
+  }
+}
+
+/* Memory used by the step, packed buffers in a spill file are not counted. */
+static void sculpt_undosys_step_update_size(UndoStep *us_p, UndoSculpt *usculpt)
+{
+  if (!usculpt->is_packed) {
+    us_p->data_size = usculpt->undo_size;
+    return;
+  }
+
+  size_t data_size = 0;
+  LISTBASE_FOREACH (SculptUndoNode *, unode, &usculpt->nodes) {
+    if (unode->packed) {
+      data_size += unode->packed_size;
+    }
+  }
+  us_p->data_size = data_size;
+}
+
+static void sculpt_undosys_step_pack(UndoStep *us_p, UndoSculpt *usculpt)
+{
+  if (usculpt->is_packed) {
+    return;
+  }
+  sculpt_undo_nodes_foreach_parallel(usculpt, sculpt_undo_pack_task_cb);
+  usculpt->is_packed = true;
+  sculpt_undosys_step_update_size(us_p, usculpt);
+}
+
+static void sculpt_undosys_step_unpack(UndoStep *us_p, UndoSculpt *usculpt)
+{
+  if (!usculpt->is_packed) {
+    return;
+  }
+  sculpt_undo_step_load(usculpt);
+  sculpt_undo_nodes_foreach_parallel(usculpt, sculpt_undo_unpack_task_cb);
+  usculpt->is_packed = false;
+  usculpt->is_spill_visited = false;
+  sculpt_undosys_step_update_size(us_p, usculpt);
+}
+
+/* Pack all sculpt steps before the given one and spill the ones far down the stack.
+ *
+ * Only undo and redo unpack steps, and they move through the stack one step at a time from the
+ * active step. So all steps below the first visited one deep enough to spill were handled by
+ * earlier pushes already, and the walk stops there. */
+static void sculpt_undosys_stack_pack(UndoStep *us_p)
+{
+  int depth = 0;
+  for (UndoStep *us_iter = us_p->prev; us_iter; us_iter = us_iter->prev) {
+    if (us_iter->type != BKE_UNDOSYS_TYPE_SCULPT) {
+      continue;
+    }
+    UndoSculpt *usculpt = sculpt_undosys_step_get_nodes(us_iter);
+
+    if (++depth < SCULPT_UNDO_SPILL_DEPTH) {
+      sculpt_undosys_step_pack(us_iter, usculpt);
+      continue;
+    }
+    if (usculpt->is_spill_visited) {
+      break;
+    }
+
+    sculpt_undosys_step_pack(us_iter, usculpt);
+    sculpt_undo_step_spill(usculpt);
+    sculpt_undosys_step_update_size(us_iter, usculpt);
+    usculpt->is_spill_visited = true;
+  }
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Implements ED Undo System
  * \{ */
@@ -1413,6 +1831,9 @@ static bool sculpt_undosys_step_encode(struct bContext *UNUSED(C),
   }
   us->step.is_applied = true;
 
+  /* This step becomes the active one, older steps are only needed for undo. */
+  sculpt_undosys_stack_pack(us_p);
+
   if (!BLI_listbase_is_empty(&us->data.nodes)) {
     bmain->is_memfile_undo_flush_needed = true;
   }
@@ -1425,16 +1846,23 @@ static void sculpt_undosys_step_decode_undo_impl(struct bContext *C,
                                                  SculptUndoStep *us)
 {
   BLI_assert(us->step.is_applied == true);
+  sculpt_undosys_step_unpack(&us->step, &us->data);
   sculpt_undo_restore_list(C, depsgraph, &us->data.nodes);
+  sculpt_undosys_step_pack(&us->step, &us->data);
   us->step.is_applied = false;
 }
 
 static void sculpt_undosys_step_decode_redo_impl(struct bContext *C,
                                                  Depsgraph *depsgraph,
-                                                 SculptUndoStep *us)
+                                                 SculptUndoStep *us,
+                                                 const bool is_active)
 {
   BLI_assert(us->step.is_applied == false);
+  sculpt_undosys_step_unpack(&us->step, &us->data);
   sculpt_undo_restore_list(C, depsgraph, &us->data.nodes);
+  if (!is_active) {
+    sculpt_undosys_step_pack(&us->step, &us->data);
+  }
   us->step.is_applied = true;
 }
 
@@ -1467,7 +1895,7 @@ static void sculpt_undosys_step_decode_redo(struct bContext *C,
     us_iter = (SculptUndoStep *)us_iter->step.prev;
   }
   while (us_iter && (us_iter->step.is_applied == false)) {
-    sculpt_undosys_step_decode_redo_impl(C, depsgraph, us_iter);
+    sculpt_undosys_step_decode_redo_impl(C, depsgraph, us_iter, us_iter == us);
     if (us_iter == us) {
       break;
     }
@@ -1522,11 +1950,15 @@ static void sculpt_undosys_step_decode(
   else {
     sculpt_undosys_step_decode_redo(C, depsgraph, us);
   }
+
+  /* The active step is read directly when sculpting. */
+  sculpt_undosys_step_unpack(&us->step, &us->data);
 }
 
 static void sculpt_undosys_step_free(UndoStep *us_p)
 {
   SculptUndoStep *us = (SculptUndoStep *)us_p;
+  sculpt_undo_step_free_spill(&us->data);
   sculpt_undo_free_list(&us->data.nodes);
 }
 
@@ -2686,6 +2686,8 @@ static int image_invert_exec(bContext *C, wmOperator *op)
     return OPERATOR_CANCELLED;
   }
 
+  ibuf = BKE_image_ibuf_ensure_writable(ima, ibuf);
+
   ED_image_undo_push_begin_with_image(op->type->name, ima, ibuf, &sima->iuser);
 
   if (is_paint) {
@@ -2815,6 +2817,8 @@ static int image_scale_exec(bContext *C, wmOperator *op)
     return OPERATOR_CANCELLED;
   }
 
+  ibuf = BKE_image_ibuf_ensure_writable(ima, ibuf);
+
   if (is_paint) {
     ED_imapaint_clear_partial_redraw();
   }
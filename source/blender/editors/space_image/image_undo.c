@@ -268,6 +268,7 @@ static void ptile_restore_runtime_list(ListBase *paint_tiles)
   LISTBASE_FOREACH (PaintTile *, ptile, paint_tiles) {
     Image *image = ptile->image;
     ImBuf *ibuf = BKE_image_acquire_ibuf(image, &ptile->iuser, NULL);
+    ibuf = BKE_image_ibuf_ensure_writable(image, ibuf);
     const bool has_float = (ibuf->rect_float != NULL);
 
     if (has_float) {
@@ -550,6 +551,8 @@ static void uhandle_restore_list(ListBase *undo_handles, bool use_init)
       CLOG_ERROR(&LOG, "Unable to get buffer for image '%s'", image->id.name + 2);
       continue;
     }
+    /* The image may have been reloaded since, and share its buffer with other images again. */
+    ibuf = BKE_image_ibuf_ensure_writable(image, ibuf);
     bool changed = false;
     LISTBASE_FOREACH (UndoImageBuf *, ubuf_iter, &uh->buffers) {
       UndoImageBuf *ubuf = use_init ? ubuf_iter : ubuf_iter->post;
@@ -25,7 +25,9 @@
 #include "DNA_light_types.h"
 #include "DNA_linestyle_types.h"
 #include "DNA_material_types.h"
+#include "DNA_modifier_types.h"
 #include "DNA_node_types.h"
+#include "DNA_object_types.h"
 #include "DNA_screen_types.h"
 #include "DNA_space_types.h"
 #include "DNA_texture_types.h"
@@ -39,9 +41,12 @@
 #include "BKE_context.h"
 #include "BKE_lib_id.h"
 #include "BKE_main.h"
+#include "BKE_modifier.h"
 #include "BKE_node.h"
+#include "BKE_object.h"
 
 #include "DEG_depsgraph.h"
+#include "DEG_depsgraph_query.h"
 
 #include "BLF_api.h"
 
@@ -66,6 +71,8 @@
 
 #include "RNA_access.h"
 
+#include "MOD_nodes.h"
+
 #include "node_intern.h" /* own include */
 
 #ifdef WITH_COMPOSITOR
@@ -1120,6 +1127,73 @@ void node_draw_sockets(View2D *v2d,
   GPU_blend(GPU_BLEND_NONE);
 }
 
+/**
+ * Find the evaluated modifier whose node group is shown in the editor, to get the statistics of
+ * its last evaluation.
+ */
+static const NodesModifierData *node_stats_modifier_get(const bContext *C,
+                                                        const SpaceNode *snode,
+                                                        const bNodeTree *ntree)
+{
+  if ((snode->flag & SNODE_SHOW_NODE_STATS) == 0 || ntree != snode->nodetree ||
+      snode->id == NULL || GS(snode->id->name) != ID_OB) {
+    return NULL;
+  }
+  Object *ob = (Object *)snode->id;
+  const ModifierData *md = BKE_object_active_modifier(ob);
+  if (md == NULL || md->type != eModifierType_Nodes ||
+      ((const NodesModifierData *)md)->node_group != ntree) {
+    return NULL;
+  }
+  Depsgraph *depsgraph = CTX_data_depsgraph_pointer(C);
+  if (depsgraph == NULL) {
+    return NULL;
+  }
+  Object *ob_eval = DEG_get_evaluated_object(depsgraph, ob);
+  if (ob_eval == NULL || ob_eval == ob) {
+    return NULL;
+  }
+  return (const NodesModifierData *)BKE_modifiers_findby_name(ob_eval, md->name);
+}
+
+/* Draw the statistics of the last evaluation above the node header. */
+static void node_draw_stats(const bContext *C,
+                            const SpaceNode *snode,
+                            const bNodeTree *ntree,
+                            bNode *node)
+{
+  const NodesModifierData *nmd = node_stats_modifier_get(C, snode, ntree);
+  NodesModifierNodeStats stats;
+  if (nmd == NULL || !MOD_nodes_node_stats_get(nmd, node->name, &stats)) {
+    return;
+  }
+
+  char elements_str[16];
+  char bytes_str[15];
+  char text[64];
+  BLI_str_format_int_grouped(elements_str, (int)MIN2(stats.elements, INT_MAX));
+  BLI_str_format_byte_unit(bytes_str, stats.bytes, true);
+  BLI_snprintf(
+      text, sizeof(text), "%.2f ms | %s | %s", stats.time * 1000.0, elements_str, bytes_str);
+
+  const rctf *rct = &node->totr;
+  uiDefBut(node->block,
+           UI_BTYPE_LABEL,
+           0,
+           text,
+           (int)rct->xmin,
+           (int)(rct->ymax + 0.1f * U.widget_unit),
+           (short)BLI_rctf_size_x(rct),
+           (short)NODE_DY,
+           NULL,
+           0,
+           0,
+           0,
+           0,
+           TIP_("Execution time, elements and memory of the node's geometry outputs in the last "
+                "evaluation"));
+}
+
 static void node_draw_basis(const bContext *C,
                             ARegion *region,
                             SpaceNode *snode,
@@ -1340,6 +1414,8 @@ static void node_draw_basis(const bContext *C,
     }
   }
 
+  node_draw_stats(C, snode, ntree, node);
+
   UI_block_end(C, node->block);
   UI_block_draw(C, node->block);
   node->block = NULL;
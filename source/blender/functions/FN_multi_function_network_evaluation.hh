@@ -39,6 +39,10 @@ class MFNetworkEvaluator : public MultiFunction {
  private:
   using Storage = MFNetworkEvaluationStorage;
 
+  bool can_evaluate_in_chunks() const;
+  void call_in_chunks(IndexMask mask, MFParams params, MFContext context) const;
+  void call_chunk(IndexMask mask, MFParams params, MFContext context) const;
+
   void copy_inputs_to_storage(MFParams params, Storage &storage) const;
   void copy_outputs_to_storage(
       MFParams params,
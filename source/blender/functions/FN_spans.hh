@@ -425,6 +425,29 @@ class GVSpan : public VSpanBase<void> {
     return (*this)[0];
   }
 
+  /**
+   * Returns a virtual span that starts `n` elements later. Single values stay single values.
+   */
+  GVSpan drop_front(int64_t n) const
+  {
+    BLI_assert(n >= 0);
+    BLI_assert(n <= this->virtual_size_);
+    GVSpan ref = *this;
+    ref.virtual_size_ -= n;
+    switch (this->category_) {
+      case VSpanCategory::Single:
+        break;
+      case VSpanCategory::FullArray:
+        ref.data_.full_array.data = POINTER_OFFSET(this->data_.full_array.data,
+                                                   n * type_->size());
+        break;
+      case VSpanCategory::FullPointerArray:
+        ref.data_.full_pointer_array.data = this->data_.full_pointer_array.data + n;
+        break;
+    }
+    return ref;
+  }
+
   GSpan as_full_array() const
   {
     BLI_assert(this->is_full_array());
@@ -28,6 +28,8 @@
  * - Avoids data copies in many cases.
  * - Every node is executed at most once.
  * - Can compute sub-functions on a single element, when the result is the same for all elements.
+ * - Large masks are split into chunks that are evaluated in parallel. Temporary buffers are only
+ *   as large as a chunk then, so they stay in cache between function nodes.
  *
  * Possible improvements:
  * - Cache and reuse buffers.
@@ -37,7 +39,9 @@
 
 #include "FN_multi_function_network_evaluation.hh"
 
+#include "BLI_array.hh"
 #include "BLI_stack.hh"
+#include "BLI_task.hh"
 
 namespace blender::fn {
 
@@ -135,12 +139,94 @@ MFNetworkEvaluator::MFNetworkEvaluator(Vector<const MFOutputSocket *> inputs,
   }
 }
 
+/**
+ * Amount of indices that are evaluated together. Every function node processes the whole chunk
+ * at once, so this should be large enough to amortize the per-node overhead, while the temporary
+ * buffers of a chunk should still fit into the cache.
+ */
+static constexpr int64_t evaluation_chunk_size = 4096;
+
 void MFNetworkEvaluator::call(IndexMask mask, MFParams params, MFContext context) const
 {
   if (mask.size() == 0) {
     return;
   }
 
+  if (mask.size() > evaluation_chunk_size && this->can_evaluate_in_chunks()) {
+    this->call_in_chunks(mask, params, context);
+    return;
+  }
+
+  this->call_chunk(mask, params, context);
+}
+
+/**
+ * Vector outputs are appended to by the functions, so they cannot be shared between chunks.
+ */
+bool MFNetworkEvaluator::can_evaluate_in_chunks() const
+{
+  for (int param_index : this->param_indices()) {
+    MFParamType param_type = this->param_type(param_index);
+    if (!ELEM(param_type.category(), MFParamType::SingleInput, MFParamType::SingleOutput)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Split the mask into chunks that are evaluated independently. The indices of every chunk are
+ * shifted so that the chunk starts at zero, otherwise the temporary buffers would be sized for
+ * all indices before the chunk as well.
+ */
+BLI_NOINLINE void MFNetworkEvaluator::call_in_chunks(IndexMask mask,
+                                                     MFParams params,
+                                                     MFContext context) const
+{
+  const int64_t chunk_amount = (mask.size() + evaluation_chunk_size - 1) / evaluation_chunk_size;
+
+  parallel_for(IndexRange(chunk_amount), 1, [&](IndexRange chunk_range) {
+    for (int64_t chunk_index : chunk_range) {
+      const int64_t chunk_start = chunk_index * evaluation_chunk_size;
+      const int64_t chunk_size = std::min(evaluation_chunk_size, mask.size() - chunk_start);
+      Span<int64_t> indices = mask.indices().slice(chunk_start, chunk_size);
+      const int64_t offset = indices.first();
+      const int64_t chunk_array_size = indices.last() - offset + 1;
+
+      Array<int64_t> shifted_indices;
+      IndexMask chunk_mask;
+      if (mask.is_range()) {
+        chunk_mask = IndexRange(chunk_size);
+      }
+      else {
+        shifted_indices.reinitialize(chunk_size);
+        for (int64_t i : indices.index_range()) {
+          shifted_indices[i] = indices[i] - offset;
+        }
+        chunk_mask = shifted_indices.as_span();
+      }
+
+      MFParamsBuilder chunk_params{*this, chunk_array_size};
+      for (int param_index : this->param_indices()) {
+        MFParamType param_type = this->param_type(param_index);
+        if (param_type.category() == MFParamType::SingleInput) {
+          GVSpan values = params.readonly_single_input(param_index);
+          chunk_params.add_readonly_single_input(values.drop_front(offset));
+        }
+        else {
+          GMutableSpan values = params.uninitialized_single_output(param_index);
+          chunk_params.add_uninitialized_single_output(
+              GMutableSpan(values.type(), values[offset], values.size() - offset));
+        }
+      }
+
+      this->call_chunk(chunk_mask, chunk_params, context);
+    }
+  });
+}
+
+void MFNetworkEvaluator::call_chunk(IndexMask mask, MFParams params, MFContext context) const
+{
   const MFNetwork &network = outputs_[0]->node().network();
   Storage storage(mask, network.socket_id_amount());
 
@@ -65,6 +65,66 @@ TEST(multi_function_network, Test1)
   }
 }
 
+TEST(multi_function_network, ChunkedEvaluation)
+{
+  CustomMF_SI_SO<int, int> add_10_fn("add 10", [](int value) { return value + 10; });
+  CustomMF_SI_SI_SO<int, int, int> add_fn("add", [](int a, int b) { return a + b; });
+
+  MFNetwork network;
+
+  MFNode &node1 = network.add_function(add_10_fn);
+  MFNode &node2 = network.add_function(add_fn);
+  MFOutputSocket &input_socket = network.add_input("Input", MFDataType::ForSingle<int>());
+  MFInputSocket &output_socket = network.add_output("Output", MFDataType::ForSingle<int>());
+  network.add_link(input_socket, node1.input(0));
+  network.add_link(node1.output(0), node2.input(0));
+  network.add_link(input_socket, node2.input(1));
+  network.add_link(node2.output(0), output_socket);
+
+  MFNetworkEvaluator network_fn{{&input_socket}, {&output_socket}};
+
+  const int size = 20001;
+  Array<int> values(size);
+  for (int i : values.index_range()) {
+    values[i] = i;
+  }
+
+  {
+    Array<int> results(size, -1);
+
+    MFParamsBuilder params(network_fn, size);
+    params.add_readonly_single_input(values.as_span());
+    params.add_uninitialized_single_output(results.as_mutable_span());
+
+    MFContextBuilder context;
+
+    network_fn.call(IndexRange(size), params, context);
+
+    for (int i : results.index_range()) {
+      EXPECT_EQ(results[i], 2 * i + 10);
+    }
+  }
+  {
+    Array<int> results(size, -1);
+    Vector<int64_t> indices;
+    for (int64_t i = 1; i < size; i += 3) {
+      indices.append(i);
+    }
+
+    MFParamsBuilder params(network_fn, size);
+    params.add_readonly_single_input(values.as_span());
+    params.add_uninitialized_single_output(results.as_mutable_span());
+
+    MFContextBuilder context;
+
+    network_fn.call(indices.as_span(), params, context);
+
+    for (int i : results.index_range()) {
+      EXPECT_EQ(results[i], (i % 3 == 1) ? 2 * i + 10 : -1);
+    }
+  }
+}
+
 class ConcatVectorsFunction : public MultiFunction {
  public:
   ConcatVectorsFunction()
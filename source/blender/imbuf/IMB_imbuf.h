@@ -122,6 +122,16 @@ struct ImBuf *IMB_testiffname(const char *filepath, int flags);
  */
 struct ImBuf *IMB_loadiffname(const char *filepath, int flags, char colorspace[IM_MAX_SPACE]);
 
+/**
+ *
+ * \attention Defined in shared_cache.c
+ */
+struct ImBuf *IMB_loadiffname_shared(const char *filepath,
+                                     int flags,
+                                     char colorspace[IM_MAX_SPACE]);
+void IMB_shared_cache_remove_ibuf(struct ImBuf *ibuf);
+void IMB_shared_cache_remove_file(const char *filepath);
+
 /**
  *
  * \attention Defined in allocimbuf.c
@@ -172,6 +172,8 @@ typedef enum eImBufFlags {
   IB_thumbnail = 1 << 16,
   IB_multiview = 1 << 17,
   IB_halffloat = 1 << 18,
+  /** with IB_multilayer, passes are only decoded on request, see #IMB_exr_read_pass */
+  IB_multilayer_lazy = 1 << 19,
 } eImBufFlags;
 
 /** \} */
@@ -299,6 +301,9 @@ enum {
   IB_DISPLAY_BUFFER_INVALID = (1 << 4),
   /** image buffer is persistent in the memory and should never be removed from the cache */
   IB_PERSISTENT = (1 << 5),
+  /** image buffer is shared with other users through the shared file cache, copy before
+   * modifying it in place */
+  IB_SHARED = (1 << 6),
 };
 
 /**
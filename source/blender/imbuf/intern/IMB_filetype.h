@@ -77,6 +77,8 @@ void imb_filetypes_exit(void);
 void imb_tile_cache_init(void);
 void imb_tile_cache_exit(void);
 
+void imb_shared_cache_exit(void);
+
 void imb_loadtile(struct ImBuf *ibuf, int tx, int ty, unsigned int *rect);
 void imb_tile_cache_tile_free(struct ImBuf *ibuf, int tx, int ty);
 
@@ -615,6 +615,9 @@ ImBuf *IMB_dupImBuf(const ImBuf *ibuf1)
   tbuf.c_handle = NULL;
   tbuf.refcounter = 0;
 
+  /* the copy is not in the shared file cache */
+  tbuf.userflags &= ~IB_SHARED;
+
   /* for now don't duplicate metadata */
   tbuf.metadata = NULL;
 
@@ -38,6 +38,7 @@ void IMB_init(void)
 
 void IMB_exit(void)
 {
+  imb_shared_cache_exit();
   imb_tile_cache_exit();
   imb_filetypes_exit();
   colormanagement_exit();
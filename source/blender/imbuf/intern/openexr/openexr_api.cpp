@@ -98,6 +98,7 @@ using namespace Imath;
 extern "C" {
 /* prototype */
 static struct ExrPass *imb_exr_get_pass(ListBase *lb, char *passname);
+static void imb_exr_pass_set_rect(struct ExrHandle *data, struct ExrPass *pass, float *rect);
 static bool exr_has_multiview(MultiPartInputFile &file);
 static bool exr_has_multipart_file(MultiPartInputFile &file);
 static bool exr_has_alpha(MultiPartInputFile &file);
@@ -627,6 +628,13 @@ typedef struct ExrHandle {
   IStream *ifile_stream;
   MultiPartInputFile *ifile;
 
+  /* Lazy reading: passes get no buffers on open, they are decoded on request by
+   * #IMB_exr_read_pass. The handle keeps its own copy of the encoded file and serializes
+   * reads, since parts of a multi-part file can't be read concurrently. */
+  bool lazy;
+  unsigned char *ifile_mem;
+  ThreadMutex *read_mutex;
+
   OFileStream *ofile_stream;
   MultiPartOutputFile *mpofile;
   OutputFile *ofile;
@@ -1210,9 +1218,20 @@ void IMB_exrtile_write_channels(
   }
 }
 
-void IMB_exr_read_channels(void *handle)
+static bool imb_exr_pass_has_channel(const ExrPass *pass, const ExrChannel *echan)
+{
+  for (int a = 0; a < pass->totchan; a++) {
+    if (pass->chan[a] == echan) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/* Read channels into their rects. When pass is given only its channels are read and parts
+ * without any of them are skipped. */
+static void imb_exr_read_channels_ex(ExrHandle *data, const ExrPass *pass)
 {
-  ExrHandle *data = (ExrHandle *)handle;
   int numparts = data->ifile->parts();
 
   /* Check if EXR was saved with previous versions of blender which flipped images. */
@@ -1239,11 +1258,15 @@ void IMB_exr_read_channels(void *handle)
     /* Insert all matching channel into framebuffer. */
     FrameBuffer frameBuffer;
     ExrChannel *echan;
+    int totslice = 0;
 
     for (echan = (ExrChannel *)data->channels.first; echan; echan = echan->next) {
       if (echan->m->part_number != i) {
         continue;
       }
+      if (pass && !imb_exr_pass_has_channel(pass, echan)) {
+        continue;
+      }
 
       exr_printf("%d %-6s %-22s \"%s\"\n",
                  echan->m->part_number,
@@ -1270,12 +1293,17 @@ void IMB_exr_read_channels(void *handle)
 
         frameBuffer.insert(echan->m->internal_name,
                            Slice(Imf::FLOAT, (char *)rect, xstride, ystride));
+        totslice++;
       }
       else {
         printf("warning, channel with no rect set %s\n", echan->m->internal_name.c_str());
       }
     }
 
+    if (pass && totslice == 0) {
+      continue;
+    }
+
     /* Read pixels. */
     try {
       in.setFrameBuffer(frameBuffer);
@@ -1289,6 +1317,58 @@ void IMB_exr_read_channels(void *handle)
   }
 }
 
+void IMB_exr_read_channels(void *handle)
+{
+  imb_exr_read_channels_ex((ExrHandle *)handle, nullptr);
+}
+
+bool IMB_exr_is_lazy(void *handle)
+{
+  ExrHandle *data = (ExrHandle *)handle;
+  return data->lazy;
+}
+
+float *IMB_exr_read_pass(void *handle,
+                         const char *layname,
+                         const char *passname,
+                         const char *viewname)
+{
+  ExrHandle *data = (ExrHandle *)handle;
+  ExrLayer *lay = (ExrLayer *)BLI_findstring(&data->layers, layname, offsetof(ExrLayer, name));
+  ExrPass *pass;
+
+  if (lay == nullptr || data->ifile == nullptr) {
+    return nullptr;
+  }
+
+  for (pass = (ExrPass *)lay->passes.first; pass; pass = pass->next) {
+    if (STREQ(pass->internal_name, passname) && STREQ(pass->view, viewname)) {
+      break;
+    }
+  }
+  if (pass == nullptr || pass->totchan == 0) {
+    return nullptr;
+  }
+
+  float *rect = (float *)MEM_callocN(
+      sizeof(float) * (size_t)data->width * data->height * pass->totchan, "exr lazy pass rect");
+
+  if (data->read_mutex) {
+    BLI_mutex_lock(data->read_mutex);
+  }
+
+  /* Channels point into the pass buffer only while reading. */
+  imb_exr_pass_set_rect(data, pass, rect);
+  imb_exr_read_channels_ex(data, pass);
+  imb_exr_pass_set_rect(data, pass, nullptr);
+
+  if (data->read_mutex) {
+    BLI_mutex_unlock(data->read_mutex);
+  }
+
+  return rect;
+}
+
 void IMB_exr_multilayer_convert(void *handle,
                                 void *base,
                                 void *(*addview)(void *base, const char *str),
@@ -1359,6 +1439,15 @@ void IMB_exr_close(void *handle)
   data->mpofile = nullptr;
   data->ofile_stream = nullptr;
 
+  if (data->ifile_mem) {
+    MEM_freeN(data->ifile_mem);
+    data->ifile_mem = nullptr;
+  }
+  if (data->read_mutex) {
+    BLI_mutex_free(data->read_mutex);
+    data->read_mutex = nullptr;
+  }
+
   for (chan = (ExrChannel *)data->channels.first; chan; chan = chan->next) {
     delete chan->m;
   }
@@ -1530,17 +1619,78 @@ static ExrPass *imb_exr_get_pass(ListBase *lb, char *passname)
   return pass;
 }
 
+/* Point the channels of a pass into rect, interleaved in canonical order where the channel
+ * names allow it. Also fills in the pass channel ids, rect may be null for that alone. */
+static void imb_exr_pass_set_rect(ExrHandle *data, ExrPass *pass, float *rect)
+{
+  const int width = data->width;
+  ExrChannel *echan;
+  int offset[EXR_PASS_MAXCHAN];
+  int a;
+
+  if (pass->totchan == 1) {
+    offset[0] = 0;
+    pass->chan_id[0] = pass->chan[0]->chan_id;
+  }
+  else {
+    char lookup[256];
+
+    memset(lookup, 0, sizeof(lookup));
+
+    /* we can have RGB(A), XYZ(W), UVA */
+    if (ELEM(pass->totchan, 3, 4)) {
+      if (pass->chan[0]->chan_id == 'B' || pass->chan[1]->chan_id == 'B' ||
+          pass->chan[2]->chan_id == 'B') {
+        lookup[(unsigned int)'R'] = 0;
+        lookup[(unsigned int)'G'] = 1;
+        lookup[(unsigned int)'B'] = 2;
+        lookup[(unsigned int)'A'] = 3;
+      }
+      else if (pass->chan[0]->chan_id == 'Y' || pass->chan[1]->chan_id == 'Y' ||
+               pass->chan[2]->chan_id == 'Y') {
+        lookup[(unsigned int)'X'] = 0;
+        lookup[(unsigned int)'Y'] = 1;
+        lookup[(unsigned int)'Z'] = 2;
+        lookup[(unsigned int)'W'] = 3;
+      }
+      else {
+        lookup[(unsigned int)'U'] = 0;
+        lookup[(unsigned int)'V'] = 1;
+        lookup[(unsigned int)'A'] = 2;
+      }
+      for (a = 0; a < pass->totchan; a++) {
+        echan = pass->chan[a];
+        offset[a] = lookup[(unsigned int)echan->chan_id];
+        pass->chan_id[offset[a]] = echan->chan_id;
+      }
+    }
+    else { /* unknown */
+      for (a = 0; a < pass->totchan; a++) {
+        offset[a] = a;
+        pass->chan_id[a] = pass->chan[a]->chan_id;
+      }
+    }
+  }
+
+  for (a = 0; a < pass->totchan; a++) {
+    echan = pass->chan[a];
+    echan->rect = rect ? rect + offset[a] : nullptr;
+    echan->xstride = pass->totchan;
+    echan->ystride = width * pass->totchan;
+  }
+}
+
 /* creates channels, makes a hierarchy and assigns memory to channels */
 static ExrHandle *imb_exr_begin_read_mem(IStream &file_stream,
                                          MultiPartInputFile &file,
                                          int width,
-                                         int height)
+                                         int height,
+                                         bool lazy)
 {
   ExrLayer *lay;
   ExrPass *pass;
   ExrChannel *echan;
   ExrHandle *data = (ExrHandle *)IMB_exr_get_handle();
-  int a;
   char layname[EXR_TOT_MAXNAME], passname[EXR_TOT_MAXNAME];
 
   data->ifile_stream = &file_stream;
@@ -1548,6 +1698,7 @@ static ExrHandle *imb_exr_begin_read_mem(IStream &file_stream,
 
   data->width = width;
   data->height = height;
+  data->lazy = lazy;
 
   std::vector<MultiViewChannelName> channels;
   GetChannelsInMultiPartFile(*data->ifile, channels);
@@ -1605,59 +1756,11 @@ static ExrHandle *imb_exr_begin_read_mem(IStream &file_stream,
   for (lay = (ExrLayer *)data->layers.first; lay; lay = lay->next) {
     for (pass = (ExrPass *)lay->passes.first; pass; pass = pass->next) {
       if (pass->totchan) {
-        pass->rect = (float *)MEM_callocN(width * height * pass->totchan * sizeof(float),
-                                          "pass rect");
-        if (pass->totchan == 1) {
-          echan = pass->chan[0];
-          echan->rect = pass->rect;
-          echan->xstride = 1;
-          echan->ystride = width;
-          pass->chan_id[0] = echan->chan_id;
-        }
-        else {
-          char lookup[256];
-
-          memset(lookup, 0, sizeof(lookup));
-
-          /* we can have RGB(A), XYZ(W), UVA */
-          if (ELEM(pass->totchan, 3, 4)) {
-            if (pass->chan[0]->chan_id == 'B' || pass->chan[1]->chan_id == 'B' ||
-                pass->chan[2]->chan_id == 'B') {
-              lookup[(unsigned int)'R'] = 0;
-              lookup[(unsigned int)'G'] = 1;
-              lookup[(unsigned int)'B'] = 2;
-              lookup[(unsigned int)'A'] = 3;
-            }
-            else if (pass->chan[0]->chan_id == 'Y' || pass->chan[1]->chan_id == 'Y' ||
-                     pass->chan[2]->chan_id == 'Y') {
-              lookup[(unsigned int)'X'] = 0;
-              lookup[(unsigned int)'Y'] = 1;
-              lookup[(unsigned int)'Z'] = 2;
-              lookup[(unsigned int)'W'] = 3;
-            }
-            else {
-              lookup[(unsigned int)'U'] = 0;
-              lookup[(unsigned int)'V'] = 1;
-              lookup[(unsigned int)'A'] = 2;
-            }
-            for (a = 0; a < pass->totchan; a++) {
-              echan = pass->chan[a];
-              echan->rect = pass->rect + lookup[(unsigned int)echan->chan_id];
-              echan->xstride = pass->totchan;
-              echan->ystride = width * pass->totchan;
-              pass->chan_id[(unsigned int)lookup[(unsigned int)echan->chan_id]] = echan->chan_id;
-            }
-          }
-          else { /* unknown */
-            for (a = 0; a < pass->totchan; a++) {
-              echan = pass->chan[a];
-              echan->rect = pass->rect + a;
-              echan->xstride = pass->totchan;
-              echan->ystride = width * pass->totchan;
-              pass->chan_id[a] = echan->chan_id;
-            }
-          }
+        if (!lazy) {
+          pass->rect = (float *)MEM_callocN(width * height * pass->totchan * sizeof(float),
+                                            "pass rect");
         }
+        imb_exr_pass_set_rect(data, pass, pass->rect);
       }
     }
   }
@@ -1973,11 +2076,42 @@ struct ImBuf *imb_load_openexr(const unsigned char *mem,
 
         /* Only enters with IB_multilayer flag set. */
         if (is_multi && ((flags & IB_thumbnail) == 0)) {
-          /* constructs channels for reading, allocates memory in channels */
-          ExrHandle *handle = imb_exr_begin_read_mem(*membuf, *file, width, height);
-          if (handle) {
-            IMB_exr_read_channels(handle);
-            ibuf->userdata = handle; /* potential danger, the caller has to check for this! */
+          if (flags & IB_multilayer_lazy) {
+            /* The memory is only valid during loading, read the passes from a copy. */
+            unsigned char *mem_copy = (unsigned char *)MEM_mallocN(size, "exr lazy file");
+            memcpy(mem_copy, mem, size);
+
+            delete file;
+            delete membuf;
+            file = nullptr;
+            membuf = new IMemStream(mem_copy, size);
+
+            try {
+              file = new MultiPartInputFile(*membuf);
+            }
+            catch (const std::exception &) {
+              MEM_freeN(mem_copy);
+              throw;
+            }
+
+            /* constructs channels for reading, passes are decoded on request */
+            ExrHandle *handle = imb_exr_begin_read_mem(*membuf, *file, width, height, true);
+            if (handle) {
+              handle->ifile_mem = mem_copy;
+              handle->read_mutex = BLI_mutex_alloc();
+              ibuf->userdata = handle; /* potential danger, the caller has to check for this! */
+            }
+            else {
+              MEM_freeN(mem_copy);
+            }
+          }
+          else {
+            /* constructs channels for reading, allocates memory in channels */
+            ExrHandle *handle = imb_exr_begin_read_mem(*membuf, *file, width, height, false);
+            if (handle) {
+              IMB_exr_read_channels(handle);
+              ibuf->userdata = handle; /* potential danger, the caller has to check for this! */
+            }
           }
         }
         else {
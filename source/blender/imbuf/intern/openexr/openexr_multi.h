@@ -72,6 +72,11 @@ float *IMB_exr_channel_rect(void *handle,
                             const char *view);
 
 void IMB_exr_read_channels(void *handle);
+bool IMB_exr_is_lazy(void *handle);
+float *IMB_exr_read_pass(void *handle,
+                         const char *layname,
+                         const char *passname,
+                         const char *viewname);
 void IMB_exr_write_channels(void *handle);
 void IMB_exrtile_write_channels(
     void *handle, int partx, int party, int level, const char *viewname, bool empty);
@@ -88,6 +88,17 @@ float *IMB_exr_channel_rect(void * /*handle*/,
 void IMB_exr_read_channels(void * /*handle*/)
 {
 }
+bool IMB_exr_is_lazy(void * /*handle*/)
+{
+  return false;
+}
+float *IMB_exr_read_pass(void * /*handle*/,
+                         const char * /*layname*/,
+                         const char * /*passname*/,
+                         const char * /*viewname*/)
+{
+  return nullptr;
+}
 void IMB_exr_write_channels(void * /*handle*/)
 {
 }
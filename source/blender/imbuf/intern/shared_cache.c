@@ -0,0 +1,192 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup imbuf
+ *
+ * Process-wide cache of decoded image files.
+ *
+ * Images, compositor image nodes and sequencer image strips which load the same file with the
+ * same settings share one decoded #ImBuf instead of each decoding their own copy. Entries are
+ * keyed by file path, modification time and size, load flags and color space, so files changed
+ * on disk are decoded again. Buffers are reference counted, the cache holds one reference and
+ * is part of the movie cache memory limiter, so it is bounded by the memory cache limit in
+ * the preferences. Evicted buffers stay alive as long as a user still references them.
+ *
+ * Shared buffers are tagged with #IB_SHARED and must not be modified in place. Users which do so
+ * replace them by a private copy first, see #BKE_image_ibuf_ensure_writable.
+ */
+
+#include <string.h>
+
+#include "BLI_fileops.h"
+#include "BLI_ghash.h"
+#include "BLI_string.h"
+#include "BLI_threads.h"
+#include "BLI_utildefines.h"
+
+#include "IMB_imbuf.h"
+#include "IMB_imbuf_types.h"
+#include "IMB_moviecache.h"
+
+typedef struct SharedCacheKey {
+  char filepath[IMB_FILENAME_SIZE];
+  char colorspace[IM_MAX_SPACE];
+  int flags;
+  int64_t mtime;
+  int64_t size;
+} SharedCacheKey;
+
+static struct MovieCache *shared_cache = NULL;
+static ThreadMutex shared_cache_lock = BLI_MUTEX_INITIALIZER;
+
+/* Flags which don't change the decoded pixels. Metadata is always read for shared buffers. */
+#define SHARED_CACHE_IGNORED_FLAGS (IB_metadata | IB_multilayer | IB_multilayer_lazy)
+
+static unsigned int shared_cache_hash(const void *key_v)
+{
+  const SharedCacheKey *key = key_v;
+  unsigned int hash = BLI_ghashutil_strhash_p(key->filepath);
+
+  hash ^= BLI_ghashutil_uinthash((unsigned int)key->flags);
+  hash ^= BLI_ghashutil_uinthash((unsigned int)key->mtime);
+
+  return hash;
+}
+
+static bool shared_cache_cmp(const void *a_v, const void *b_v)
+{
+  const SharedCacheKey *a = a_v;
+  const SharedCacheKey *b = b_v;
+
+  return (a->flags != b->flags) || (a->mtime != b->mtime) || (a->size != b->size) ||
+         !STREQ(a->filepath, b->filepath) || !STREQ(a->colorspace, b->colorspace);
+}
+
+static bool shared_cache_key_init(SharedCacheKey *key,
+                                  const char *filepath,
+                                  int flags,
+                                  const char *colorspace)
+{
+  BLI_stat_t st;
+
+  if (BLI_stat(filepath, &st) == -1) {
+    return false;
+  }
+
+  memset(key, 0, sizeof(*key));
+  BLI_strncpy(key->filepath, filepath, sizeof(key->filepath));
+  BLI_strncpy(key->colorspace, colorspace, sizeof(key->colorspace));
+  key->flags = flags & ~SHARED_CACHE_IGNORED_FLAGS;
+  key->mtime = (int64_t)st.st_mtime;
+  key->size = (int64_t)st.st_size;
+
+  return true;
+}
+
+/**
+ * Load an image file through the shared cache. The returned buffer may be shared with other
+ * users and must not be modified in place, see the notes at the top of this file.
+ *
+ * Only requests with a known color space are shared, since loading otherwise detects the
+ * color space from the file. Multi-layer files, tile caches and test loads bypass the cache.
+ */
+ImBuf *IMB_loadiffname_shared(const char *filepath, int flags, char colorspace[IM_MAX_SPACE])
+{
+  SharedCacheKey key;
+  ImBuf *ibuf;
+
+  if ((flags & (IB_test | IB_tilecache | IB_thumbnail)) || colorspace == NULL ||
+      colorspace[0] == '\0' || !shared_cache_key_init(&key, filepath, flags, colorspace)) {
+    return IMB_loadiffname(filepath, flags, colorspace);
+  }
+
+  BLI_mutex_lock(&shared_cache_lock);
+  ibuf = shared_cache ? IMB_moviecache_get(shared_cache, &key) : NULL;
+  BLI_mutex_unlock(&shared_cache_lock);
+
+  if (ibuf) {
+    return ibuf;
+  }
+
+  /* Decode outside of the lock, concurrent misses on the same file decode twice and the last
+   * one ends up in the cache, which is harmless. */
+  ibuf = IMB_loadiffname(filepath, flags | IB_metadata, colorspace);
+  if (ibuf == NULL || ibuf->userdata != NULL) {
+    return ibuf;
+  }
+
+  ibuf->userflags |= IB_SHARED;
+
+  BLI_mutex_lock(&shared_cache_lock);
+  if (shared_cache == NULL) {
+    shared_cache = IMB_moviecache_create(
+        "shared image cache", sizeof(SharedCacheKey), shared_cache_hash, shared_cache_cmp);
+  }
+  IMB_moviecache_put(shared_cache, &key, ibuf);
+  BLI_mutex_unlock(&shared_cache_lock);
+
+  return ibuf;
+}
+
+static bool shared_cache_check_ibuf(ImBuf *ibuf, void *UNUSED(userkey), void *userdata)
+{
+  return ibuf == userdata;
+}
+
+static bool shared_cache_check_filepath(ImBuf *UNUSED(ibuf), void *userkey, void *userdata)
+{
+  const SharedCacheKey *key = userkey;
+  return STREQ(key->filepath, (const char *)userdata);
+}
+
+/**
+ * Remove a buffer from the cache, so later loads of its file decode it again.
+ * Users which already hold a reference keep it.
+ */
+void IMB_shared_cache_remove_ibuf(ImBuf *ibuf)
+{
+  BLI_mutex_lock(&shared_cache_lock);
+  if (shared_cache) {
+    IMB_moviecache_cleanup(shared_cache, shared_cache_check_ibuf, ibuf);
+  }
+  BLI_mutex_unlock(&shared_cache_lock);
+}
+
+/**
+ * Remove all entries of a file, for explicit reloads.
+ */
+void IMB_shared_cache_remove_file(const char *filepath)
+{
+  BLI_mutex_lock(&shared_cache_lock);
+  if (shared_cache) {
+    IMB_moviecache_cleanup(shared_cache, shared_cache_check_filepath, (void *)filepath);
+  }
+  BLI_mutex_unlock(&shared_cache_lock);
+}
+
+void imb_shared_cache_exit(void)
+{
+  BLI_mutex_lock(&shared_cache_lock);
+  if (shared_cache) {
+    IMB_moviecache_free(shared_cache);
+    shared_cache = NULL;
+  }
+  BLI_mutex_unlock(&shared_cache_lock);
+}
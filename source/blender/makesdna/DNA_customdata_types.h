@@ -53,6 +53,11 @@ typedef struct CustomDataLayer {
   char name[64];
   /** Layer data. */
   void *data;
+  /**
+   * Run-time owner of `data` when it is shared with layers of other #CustomData, see
+   * #CD_SHARE. Shared layers also have #CD_FLAG_NOFREE set.
+   */
+  struct CustomDataLayerSharing *sharing;
 } CustomDataLayer;
 
 #define MAX_CUSTOMDATA_LAYER_NAME 64
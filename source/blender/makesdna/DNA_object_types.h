@@ -122,7 +122,13 @@ typedef struct Object_Runtime {
   /** Did last modifier stack generation need mapping support? */
   char last_need_mapping;
 
-  char _pad0[3];
+  /**
+   * The evaluated mesh took over the GPU batch cache of the previous evaluation because only its
+   * vertex positions changed, so drawing only has to update the position dependent buffers.
+   */
+  char is_batch_cache_deform_only;
+
+  char _pad0[2];
 
   /** Only used for drawing the parent/child help-line. */
   float parent_display_origin[3];
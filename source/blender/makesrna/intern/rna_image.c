@@ -500,6 +500,7 @@ static void rna_Image_pixels_set(PointerRNA *ptr, const float *values)
   int i, size;
 
   ibuf = BKE_image_acquire_ibuf(ima, NULL, &lock);
+  ibuf = BKE_image_ibuf_ensure_writable(ima, ibuf);
 
   if (ibuf) {
     size = ibuf->x * ibuf->y * ibuf->channels;
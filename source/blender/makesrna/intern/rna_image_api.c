@@ -198,6 +198,8 @@ static void rna_Image_update(Image *image, ReportList *reports)
     return;
   }
 
+  ibuf = BKE_image_ibuf_ensure_writable(image, ibuf);
+
   if (ibuf->rect) {
     IMB_rect_from_float(ibuf);
   }
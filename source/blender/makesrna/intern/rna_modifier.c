@@ -1619,6 +1619,24 @@ static void rna_NodesModifier_node_group_update(Main *bmain, Scene *scene, Point
   MOD_nodes_update_interface(object, nmd);
 }
 
+static void rna_NodesModifier_node_stats(NodesModifierData *nmd,
+                                         ReportList *reports,
+                                         const char *node_name,
+                                         float *r_time,
+                                         int *r_elements,
+                                         float *r_memory)
+{
+  NodesModifierNodeStats stats = {0};
+  if (nmd->modifier.runtime == NULL) {
+    BKE_report(reports, RPT_ERROR, "Statistics are only available on the evaluated modifier");
+  }
+  /* Nodes which were not executed have no statistics. */
+  MOD_nodes_node_stats_get(nmd, node_name, &stats);
+  *r_time = (float)stats.time;
+  *r_elements = (int)MIN2(stats.elements, INT_MAX);
+  *r_memory = (float)stats.bytes;
+}
+
 static IDProperty *rna_NodesModifierSettings_properties(PointerRNA *ptr, bool create)
 {
   NodesModifierSettings *settings = ptr->data;
@@ -6968,6 +6986,8 @@ static void rna_def_modifier_nodes(BlenderRNA *brna)
 {
   StructRNA *srna;
   PropertyRNA *prop;
+  FunctionRNA *func;
+  PropertyRNA *parm;
 
   srna = RNA_def_struct(brna, "NodesModifier", "Modifier");
   RNA_def_struct_ui_text(srna, "Nodes Modifier", "");
@@ -6988,6 +7008,38 @@ static void rna_def_modifier_nodes(BlenderRNA *brna)
 
   RNA_define_lib_overridable(false);
 
+  func = RNA_def_function(srna, "node_stats", "rna_NodesModifier_node_stats");
+  RNA_def_function_ui_description(func,
+                                  "Statistics of a node in the last evaluation, only available "
+                                  "on the evaluated modifier. Nodes inside of groups are "
+                                  "accounted to the group node");
+  RNA_def_function_flag(func, FUNC_USE_REPORTS);
+  parm = RNA_def_string(func, "node_name", NULL, MAX_NAME, "", "Name of the node");
+  RNA_def_parameter_flags(parm, 0, PARM_REQUIRED);
+  parm = RNA_def_float(
+      func, "time", 0.0f, 0.0f, FLT_MAX, "Time", "Execution time in seconds", 0.0f, FLT_MAX);
+  RNA_def_function_output(func, parm);
+  parm = RNA_def_int(func,
+                     "elements",
+                     0,
+                     0,
+                     INT_MAX,
+                     "Elements",
+                     "Number of vertices, points and instances in the geometry outputs",
+                     0,
+                     INT_MAX);
+  RNA_def_function_output(func, parm);
+  parm = RNA_def_float(func,
+                       "memory",
+                       0.0f,
+                       0.0f,
+                       FLT_MAX,
+                       "Memory",
+                       "Size of the attribute data in the geometry outputs in bytes",
+                       0.0f,
+                       FLT_MAX);
+  RNA_def_function_output(func, parm);
+
   rna_def_modifier_nodes_settings(brna);
 }
 
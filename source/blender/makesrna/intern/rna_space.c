@@ -6353,6 +6353,14 @@ static void rna_def_space_node(BlenderRNA *brna)
   RNA_def_property_ui_text(prop, "Show Annotation", "Show annotations for this view");
   RNA_def_property_update(prop, NC_SPACE | ND_SPACE_NODE_VIEW, NULL);
 
+  prop = RNA_def_property(srna, "show_node_stats", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", SNODE_SHOW_NODE_STATS);
+  RNA_def_property_ui_text(prop,
+                           "Show Node Statistics",
+                           "Show the execution time and output size of geometry nodes in the "
+                           "last evaluation of the active modifier");
+  RNA_def_property_update(prop, NC_SPACE | ND_SPACE_NODE_VIEW, NULL);
+
   prop = RNA_def_property(srna, "use_auto_render", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, NULL, "flag", SNODE_AUTO_RENDER);
   RNA_def_property_ui_text(
@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include "BLI_sys_types.h"
+
 struct Main;
 struct Object;
 struct NodesModifierData;
@@ -28,6 +30,20 @@ void MOD_nodes_update_interface(struct Object *object, struct NodesModifierData
 
 void MOD_nodes_init(struct Main *bmain, struct NodesModifierData *nmd);
 
+/** Statistics of a node in the last evaluation of a nodes modifier. */
+typedef struct NodesModifierNodeStats {
+  /** Execution time in seconds, zero when the outputs were cached. */
+  double time;
+  /** Number of vertices, points and instances in the geometry outputs. */
+  int64_t elements;
+  /** Size of the attribute data in the geometry outputs in bytes. */
+  int64_t bytes;
+} NodesModifierNodeStats;
+
+bool MOD_nodes_node_stats_get(const struct NodesModifierData *nmd,
+                              const char *node_name,
+                              NodesModifierNodeStats *r_stats);
+
 #ifdef __cplusplus
 }
 #endif
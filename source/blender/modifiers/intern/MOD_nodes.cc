@@ -21,16 +21,24 @@
  * \ingroup modifiers
  */
 
+#include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_array.hh"
 #include "BLI_float3.hh"
 #include "BLI_listbase.h"
 #include "BLI_set.hh"
 #include "BLI_string.h"
+#include "BLI_task.h"
+#include "BLI_task.hh"
 #include "BLI_utildefines.h"
 
 #include "DNA_defaults.h"
@@ -54,6 +62,8 @@
 
 #include "BLO_read_write.h"
 
+#include "PIL_time.h"
+
 #include "UI_interface.h"
 #include "UI_resources.h"
 
@@ -73,13 +83,16 @@
 #include "NOD_node_tree_multi_function.hh"
 #include "NOD_type_callbacks.hh"
 
+using blender::Array;
 using blender::float3;
 using blender::IndexRange;
 using blender::Map;
 using blender::Set;
 using blender::Span;
 using blender::StringRef;
+using blender::StringRefNull;
 using blender::Vector;
+using blender::fn::CPPType;
 using blender::fn::GMutablePointer;
 using blender::fn::GValueMap;
 using blender::nodes::GeoNodeExecParams;
@@ -184,38 +197,430 @@ static bool isDisabled(const struct Scene *UNUSED(scene),
   return false;
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Node Output Cache
+ *
+ * The outputs of geometry nodes are kept between evaluations of the modifier, so that only the
+ * nodes that depend on a changed input have to be executed again. A cached output is identified
+ * by a key that is computed from the node settings and the keys of the values passed to its
+ * inputs, recursively. Inputs for which no key can be computed make the node and everything
+ * after it uncachable. That is the case for objects, which can change without the node tree
+ * noticing.
+ *
+ * The size of the cached geometry is limited per modifier, and nothing is cached for final
+ * renders, which evaluate the modifier only once.
+ * \{ */
+
+/**
+ * Combines values into a 64 bit key. Unlike the hashes used for hash tables, every added value
+ * changes all bits of the key, so that accidental collisions are extremely unlikely.
+ */
+class CacheKeyBuilder {
+ private:
+  uint64_t key_ = 0x2545f4914f6cdd1dULL;
+
+ public:
+  void add(const uint64_t value)
+  {
+    uint64_t x = key_ ^ value;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    key_ = x ^ (x >> 31);
+  }
+
+  void add_bytes(const void *data, const int64_t size)
+  {
+    const char *bytes = static_cast<const char *>(data);
+    uint64_t hash = static_cast<uint64_t>(size);
+    int64_t offset = 0;
+    for (; offset + 8 <= size; offset += 8) {
+      uint64_t word;
+      memcpy(&word, bytes + offset, 8);
+      hash = (hash ^ word) * 0x9e3779b97f4a7c15ULL;
+      hash ^= hash >> 29;
+    }
+    uint64_t word = 0;
+    memcpy(&word, bytes + offset, static_cast<size_t>(size - offset));
+    hash = (hash ^ word) * 0x9e3779b97f4a7c15ULL;
+    this->add(hash);
+  }
+
+  /**
+   * Same as #add_bytes, but large arrays are split into blocks that are hashed in parallel. The
+   * keys of the blocks are added in order, so the result does not depend on the threading.
+   */
+  void add_large_bytes(const void *data, const int64_t size)
+  {
+    constexpr int64_t block_size = 1 << 16;
+    if (size <= block_size) {
+      this->add_bytes(data, size);
+      return;
+    }
+    const char *bytes = static_cast<const char *>(data);
+    Array<uint64_t> block_keys((size + block_size - 1) / block_size);
+    blender::parallel_for(block_keys.index_range(), 16, [&](IndexRange range) {
+      for (const int64_t i : range) {
+        const int64_t offset = i * block_size;
+        CacheKeyBuilder block_key;
+        block_key.add_bytes(bytes + offset, std::min(block_size, size - offset));
+        block_keys[i] = block_key.get();
+      }
+    });
+    this->add_bytes(block_keys.data(), static_cast<int64_t>(sizeof(uint64_t)) * block_keys.size());
+  }
+
+  void add_string(StringRef str)
+  {
+    this->add_bytes(str.data(), str.size());
+  }
+
+  uint64_t get() const
+  {
+    return key_;
+  }
+};
+
+/* Returns false when the layers contain data that can not be hashed. */
+static bool custom_data_add_to_cache_key(const CustomData &data,
+                                         const int totelem,
+                                         CacheKeyBuilder &key)
+{
+  key.add(static_cast<uint64_t>(totelem));
+  for (const int i : IndexRange(data.totlayer)) {
+    const CustomDataLayer &layer = data.layers[i];
+    key.add(static_cast<uint64_t>(layer.type));
+    key.add_string(layer.name);
+    key.add(static_cast<uint64_t>(layer.active));
+    key.add(static_cast<uint64_t>(layer.active_rnd));
+    if (layer.data == nullptr) {
+      continue;
+    }
+    switch (layer.type) {
+      case CD_MDEFORMVERT: {
+        const MDeformVert *dverts = static_cast<const MDeformVert *>(layer.data);
+        for (const int j : IndexRange(totelem)) {
+          const MDeformVert &dvert = dverts[j];
+          key.add(static_cast<uint64_t>(dvert.totweight));
+          if (dvert.totweight > 0) {
+            key.add_bytes(dvert.dw, sizeof(MDeformWeight) * dvert.totweight);
+          }
+        }
+        break;
+      }
+      case CD_MDISPS:
+      case CD_GRID_PAINT_MASK:
+      case CD_BM_ELEM_PYPTR:
+        /* These layers reference more data. They are not used by geometry nodes, so it is not
+         * worth it to support them here. */
+        return false;
+      default:
+        key.add_large_bytes(layer.data,
+                            static_cast<int64_t>(CustomData_sizeof(layer.type)) * totelem);
+        break;
+    }
+  }
+  return true;
+}
+
+static bool mesh_add_to_cache_key(const Mesh &mesh, CacheKeyBuilder &key)
+{
+  if (mesh.runtime.wrapper_type != ME_WRAPPER_TYPE_MDATA) {
+    return false;
+  }
+  key.add(static_cast<uint64_t>(mesh.flag));
+  key.add_bytes(&mesh.smoothresh, sizeof(mesh.smoothresh));
+  key.add(static_cast<uint64_t>(mesh.totcol));
+  if (mesh.totcol > 0) {
+    key.add_bytes(mesh.mat, sizeof(*mesh.mat) * mesh.totcol);
+  }
+  return custom_data_add_to_cache_key(mesh.vdata, mesh.totvert, key) &&
+         custom_data_add_to_cache_key(mesh.edata, mesh.totedge, key) &&
+         custom_data_add_to_cache_key(mesh.ldata, mesh.totloop, key) &&
+         custom_data_add_to_cache_key(mesh.pdata, mesh.totpoly, key);
+}
+
+/**
+ * Compute a key for the content of a geometry that is passed into the node tree. This has to look
+ * at all the data, but that is still much cheaper than executing the nodes that use it.
+ */
+static std::optional<uint64_t> geometry_cache_key(const GeometrySet &geometry_set)
+{
+  if (geometry_set.has<InstancesComponent>()) {
+    /* Instances reference objects. */
+    return {};
+  }
+  CacheKeyBuilder key;
+  const MeshComponent *mesh_component = geometry_set.get_component_for_read<MeshComponent>();
+  if (mesh_component != nullptr) {
+    key.add(static_cast<uint64_t>(GeometryComponentType::Mesh));
+    const Mesh *mesh = mesh_component->get_for_read();
+    if (mesh != nullptr && !mesh_add_to_cache_key(*mesh, key)) {
+      return {};
+    }
+    for (auto item : mesh_component->vertex_group_names().items()) {
+      key.add_string(item.key);
+      key.add(static_cast<uint64_t>(item.value));
+    }
+  }
+  const PointCloudComponent *pointcloud_component =
+      geometry_set.get_component_for_read<PointCloudComponent>();
+  if (pointcloud_component != nullptr) {
+    key.add(static_cast<uint64_t>(GeometryComponentType::PointCloud));
+    const PointCloud *pointcloud = pointcloud_component->get_for_read();
+    if (pointcloud != nullptr &&
+        !custom_data_add_to_cache_key(pointcloud->pdata, pointcloud->totpoint, key)) {
+      return {};
+    }
+  }
+  return key.get();
+}
+
+static std::optional<uint64_t> value_cache_key(const CPPType &type, const void *value)
+{
+  if (type.is<GeometrySet>()) {
+    return geometry_cache_key(*static_cast<const GeometrySet *>(value));
+  }
+  if (type.is<blender::bke::PersistentObjectHandle>()) {
+    /* Object handles are only valid for one evaluation, and the objects can change anyway. */
+    return {};
+  }
+  CacheKeyBuilder key;
+  key.add(type.hash());
+  key.add(type.hash(value));
+  return key.get();
+}
+
+/** The outputs of one node, indexed like the node outputs. Unavailable outputs are empty. */
+struct CachedNodeOutputs {
+  Array<GMutablePointer> values;
+  /* Size of the geometry in the outputs, see #NodesModifierNodeStats. */
+  int64_t bytes = 0;
+
+  CachedNodeOutputs(const int outputs_num) : values(outputs_num)
+  {
+  }
+
+  ~CachedNodeOutputs()
+  {
+    for (GMutablePointer value : values) {
+      if (value.get() != nullptr) {
+        value.destruct();
+        MEM_freeN(value.get());
+      }
+    }
+  }
+
+  MEM_CXX_CLASS_ALLOC_FUNCS("CachedNodeOutputs")
+};
+
+/**
+ * Part of #NodesModifierRuntime. Only outputs that were used by the last evaluation
+ * are kept, so the cache does not grow when the node tree or its inputs change.
+ * New outputs are only added as long as the cached geometry stays below #max_bytes.
+ */
+class NodeOutputCache {
+ public:
+  static constexpr int64_t max_bytes = 256 * 1024 * 1024;
+
+ private:
+  Map<uint64_t, std::unique_ptr<CachedNodeOutputs>> outputs_;
+  Set<uint64_t> used_keys_;
+  int64_t bytes_ = 0;
+
+ public:
+  const CachedNodeOutputs *lookup(const uint64_t key) const
+  {
+    const std::unique_ptr<CachedNodeOutputs> *outputs = outputs_.lookup_ptr(key);
+    return (outputs == nullptr) ? nullptr : outputs->get();
+  }
+
+  /* Returns false when the outputs don't fit into the cache, they are freed then. */
+  bool add(const uint64_t key, std::unique_ptr<CachedNodeOutputs> outputs)
+  {
+    BLI_assert(!outputs_.contains(key));
+    if (bytes_ + outputs->bytes > max_bytes) {
+      return false;
+    }
+    bytes_ += outputs->bytes;
+    outputs_.add_new(key, std::move(outputs));
+    used_keys_.add(key);
+    return true;
+  }
+
+  void mark_used(const uint64_t key)
+  {
+    used_keys_.add(key);
+  }
+
+  /* Free all outputs that have not been used since the last call. */
+  void remove_unused()
+  {
+    Vector<uint64_t> unused_keys;
+    for (const uint64_t key : outputs_.keys()) {
+      if (!used_keys_.contains(key)) {
+        unused_keys.append(key);
+      }
+    }
+    for (const uint64_t key : unused_keys) {
+      bytes_ -= outputs_.lookup(key)->bytes;
+      outputs_.remove(key);
+    }
+    used_keys_.clear();
+  }
+
+  MEM_CXX_CLASS_ALLOC_FUNCS("NodeOutputCache")
+};
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Node Statistics
+ * \{ */
+
+static int64_t custom_data_size(const CustomData &data, const int64_t size)
+{
+  int64_t bytes = 0;
+  for (const CustomDataLayer &layer : Span<CustomDataLayer>(data.layers, data.totlayer)) {
+    bytes += CustomData_sizeof(layer.type) * size;
+  }
+  return bytes;
+}
+
+static void geometry_set_add_stats(const GeometrySet &geometry_set, NodesModifierNodeStats &stats)
+{
+  if (const Mesh *mesh = geometry_set.get_mesh_for_read()) {
+    stats.elements += mesh->totvert;
+    stats.bytes += custom_data_size(mesh->vdata, mesh->totvert) +
+                   custom_data_size(mesh->edata, mesh->totedge) +
+                   custom_data_size(mesh->ldata, mesh->totloop) +
+                   custom_data_size(mesh->pdata, mesh->totpoly);
+  }
+  if (const PointCloud *pointcloud = geometry_set.get_pointcloud_for_read()) {
+    stats.elements += pointcloud->totpoint;
+    stats.bytes += custom_data_size(pointcloud->pdata, pointcloud->totpoint);
+  }
+  if (const InstancesComponent *instances =
+          geometry_set.get_component_for_read<InstancesComponent>()) {
+    const int64_t amount = instances->instances_amount();
+    stats.elements += amount;
+    stats.bytes += amount * static_cast<int64_t>(3 * sizeof(float3) + sizeof(Object *));
+  }
+}
+
+static void value_add_stats(const GMutablePointer value, NodesModifierNodeStats &stats)
+{
+  if (value.type()->is<GeometrySet>()) {
+    geometry_set_add_stats(*static_cast<const GeometrySet *>(value.get()), stats);
+  }
+}
+
+/* Nodes inside of groups are accounted to the group node in the modifier's node group. */
+static StringRefNull node_stats_name(const DNode &node)
+{
+  const DParentNode *parent = node.parent();
+  if (parent == nullptr) {
+    return node.name();
+  }
+  while (parent->parent() != nullptr) {
+    parent = parent->parent();
+  }
+  return parent->node_ref().name();
+}
+
+/**
+ * Stored in the runtime data of the evaluated modifier.
+ */
+struct NodesModifierRuntime {
+  NodeOutputCache cache;
+  /* Statistics of the last evaluation by node name, see #node_stats_name. */
+  Map<std::string, NodesModifierNodeStats> node_stats;
+
+  MEM_CXX_CLASS_ALLOC_FUNCS("NodesModifierRuntime")
+};
+
+/** \} */
+
+/**
+ * Evaluates the nodes that are required to compute the group outputs. Nodes are executed on the
+ * task pool as soon as all their linked inputs have been computed, so independent branches of the
+ * tree are evaluated in parallel. Nodes that the outputs do not depend on are not executed.
+ *
+ * When a #NodeOutputCache is given, geometry nodes whose outputs are cached are not executed, and
+ * neither are the nodes that only they depend on.
+ */
 class GeometryNodesEvaluator {
  private:
+  /* Evaluation state of a node that has to be executed. */
+  struct NodeState {
+    /* Number of linked inputs that have not been computed yet. The node is scheduled for
+     * execution when this drops to zero. */
+    std::atomic<int> missing_inputs = 0;
+    /* Values created while executing the node are allocated here, so that every thread uses its
+     * own allocator. */
+    blender::LinearAllocator<> allocator;
+    /* Key of the node outputs in the cache, if they can be cached. */
+    std::optional<uint64_t> cache_key;
+    /* Outputs from the cache that are used instead of executing the node. */
+    const CachedNodeOutputs *cached_outputs = nullptr;
+    /* Copies of the computed outputs that are added to the cache after the evaluation. */
+    std::unique_ptr<CachedNodeOutputs> outputs_to_cache;
+    /* Execution time and size of the outputs. */
+    NodesModifierNodeStats stats = {0};
+  };
+
   blender::LinearAllocator<> allocator_;
   Map<const DInputSocket *, GMutablePointer> value_by_input_;
+  /* Protects #value_by_input_ while nodes are executed. */
+  std::mutex value_by_input_mutex_;
+  /* Contains all nodes that have to be executed. Not modified during execution. */
+  Map<const DNode *, std::unique_ptr<NodeState>> node_states_;
   Vector<const DInputSocket *> group_outputs_;
   blender::nodes::MultiFunctionByNode &mf_by_node_;
   const blender::nodes::DataTypeConversions &conversions_;
   const blender::bke::PersistentDataHandleMap &handle_map_;
   const Object *self_object_;
+  NodeOutputCache *cache_;
+  /* Cache keys of the group inputs and of all nodes that the outputs depend on. Only accessed
+   * before nodes are executed. */
+  Map<const DOutputSocket *, std::optional<uint64_t>> group_input_keys_;
+  Map<const DNode *, std::optional<uint64_t>> node_keys_;
 
  public:
   GeometryNodesEvaluator(const Map<const DOutputSocket *, GMutablePointer> &group_input_data,
                          Vector<const DInputSocket *> group_outputs,
                          blender::nodes::MultiFunctionByNode &mf_by_node,
                          const blender::bke::PersistentDataHandleMap &handle_map,
-                         const Object *self_object)
+                         const Object *self_object,
+                         NodeOutputCache *cache)
       : group_outputs_(std::move(group_outputs)),
         mf_by_node_(mf_by_node),
         conversions_(blender::nodes::get_implicit_type_conversions()),
         handle_map_(handle_map),
-        self_object_(self_object)
+        self_object_(self_object),
+        cache_(cache)
   {
     for (auto item : group_input_data.items()) {
-      this->forward_to_inputs(*item.key, item.value);
+      if (cache_ != nullptr) {
+        group_input_keys_.add_new(item.key, value_cache_key(*item.value.type(), item.value.get()));
+      }
+      this->forward_to_inputs(*item.key, item.value, allocator_);
     }
   }
 
   Vector<GMutablePointer> execute()
   {
+    Vector<const DNode *> ready_nodes;
+    for (const DInputSocket *group_output : group_outputs_) {
+      this->prepare_input(*group_output, ready_nodes);
+    }
+    this->execute_nodes(ready_nodes);
+    if (cache_ != nullptr) {
+      this->update_cache();
+    }
+
     Vector<GMutablePointer> results;
     for (const DInputSocket *group_output : group_outputs_) {
-      GMutablePointer result = this->get_input_value(*group_output);
+      GMutablePointer result = this->get_input_value(*group_output, allocator_);
       results.append(result);
     }
     for (GMutablePointer value : value_by_input_.values()) {
@@ -224,73 +629,348 @@ class GeometryNodesEvaluator {
     return results;
   }
 
+  /* Statistics of the nodes executed by #execute. */
+  Map<std::string, NodesModifierNodeStats> node_stats() const
+  {
+    Map<std::string, NodesModifierNodeStats> stats_by_name;
+    for (auto item : node_states_.items()) {
+      const NodesModifierNodeStats &node_stats = item.value->stats;
+      NodesModifierNodeStats &stats = stats_by_name.lookup_or_add_default_as(
+          StringRef(node_stats_name(*item.key)));
+      stats.time += node_stats.time;
+      stats.elements += node_stats.elements;
+      stats.bytes += node_stats.bytes;
+    }
+    return stats_by_name;
+  }
+
  private:
-  GMutablePointer get_input_value(const DInputSocket &socket_to_compute)
+  /* Find the nodes which have to be executed to compute the input. Returns true when the value
+   * of the input is computed by a node that has to be executed first. */
+  bool prepare_input(const DInputSocket &socket, Vector<const DNode *> &r_ready_nodes)
   {
-    std::optional<GMutablePointer> value = value_by_input_.pop_try(&socket_to_compute);
-    if (value.has_value()) {
-      /* This input has been computed before, return it directly. */
-      return *value;
+    if (value_by_input_.contains(&socket)) {
+      /* The value is known already. */
+      return false;
     }
 
-    Span<const DOutputSocket *> from_sockets = socket_to_compute.linked_sockets();
-    Span<const DGroupInput *> from_group_inputs = socket_to_compute.linked_group_inputs();
-    const int total_inputs = from_sockets.size() + from_group_inputs.size();
-    BLI_assert(total_inputs <= 1);
+    Span<const DOutputSocket *> from_sockets = socket.linked_sockets();
+    BLI_assert(from_sockets.size() + socket.linked_group_inputs().size() <= 1);
+    if (from_sockets.size() == 0) {
+      /* The value comes from the socket itself or from an unlinked group input. */
+      return false;
+    }
 
-    if (total_inputs == 0) {
-      /* The input is not connected, use the value from the socket itself. */
-      return get_unlinked_input_value(socket_to_compute);
+    const DOutputSocket &from_socket = *from_sockets[0];
+    if (!from_socket.is_available()) {
+      /* If the output is not available, use a default value. */
+      const CPPType &type = *blender::nodes::socket_cpp_type_get(*from_socket.typeinfo());
+      void *buffer = allocator_.allocate(type.size(), type.alignment());
+      type.copy_to_uninitialized(type.default_value(), buffer);
+      this->forward_to_inputs(from_socket, {type, buffer}, allocator_);
+      return false;
     }
-    if (from_group_inputs.size() == 1) {
-      /* The input gets its value from the input of a group that is not further connected. */
-      return get_unlinked_input_value(socket_to_compute);
+
+    this->prepare_node(from_socket.node(), r_ready_nodes);
+    return true;
+  }
+
+  void prepare_node(const DNode &node, Vector<const DNode *> &r_ready_nodes)
+  {
+    if (node_states_.contains(&node)) {
+      return;
+    }
+    node_states_.add_new(&node, std::make_unique<NodeState>());
+    NodeState &state = *node_states_.lookup(&node);
+
+    if (cache_ != nullptr && node.bnode()->typeinfo->geometry_node_execute != nullptr) {
+      state.cache_key = this->node_cache_key(node);
+      if (state.cache_key.has_value()) {
+        state.cached_outputs = cache_->lookup(*state.cache_key);
+        if (state.cached_outputs != nullptr) {
+          /* The inputs are not needed, the node only forwards the cached outputs. */
+          r_ready_nodes.append(&node);
+          return;
+        }
+      }
     }
 
-    /* Compute the socket now. */
-    const DOutputSocket &from_socket = *from_sockets[0];
-    this->compute_output_and_forward(from_socket);
-    return value_by_input_.pop(&socket_to_compute);
+    int missing_inputs = 0;
+    for (const DInputSocket *input_socket : node.inputs()) {
+      if (input_socket->is_available()) {
+        if (this->prepare_input(*input_socket, r_ready_nodes)) {
+          missing_inputs++;
+        }
+      }
+    }
+    state.missing_inputs = missing_inputs;
+    if (missing_inputs == 0) {
+      r_ready_nodes.append(&node);
+    }
   }
 
-  void compute_output_and_forward(const DOutputSocket &socket_to_compute)
+  std::optional<uint64_t> node_cache_key(const DNode &node)
+  {
+    const std::optional<uint64_t> *computed_key = node_keys_.lookup_ptr(&node);
+    if (computed_key != nullptr) {
+      return *computed_key;
+    }
+    const std::optional<uint64_t> key = this->compute_node_cache_key(node);
+    node_keys_.add_new(&node, key);
+    return key;
+  }
+
+  std::optional<uint64_t> compute_node_cache_key(const DNode &node)
   {
-    const DNode &node = socket_to_compute.node();
     const bNode &bnode = *node.bnode();
+    CacheKeyBuilder key;
+    key.add_string(bnode.idname);
+    key.add(static_cast<uint64_t>(bnode.custom1));
+    key.add(static_cast<uint64_t>(bnode.custom2));
+    key.add_bytes(&bnode.custom3, sizeof(bnode.custom3));
+    key.add_bytes(&bnode.custom4, sizeof(bnode.custom4));
+    if (bnode.storage != nullptr) {
+      key.add_bytes(bnode.storage, static_cast<int64_t>(MEM_allocN_len(bnode.storage)));
+    }
+    for (const DInputSocket *input_socket : node.inputs()) {
+      key.add(input_socket->is_available());
+      if (input_socket->is_available()) {
+        const std::optional<uint64_t> input_key = this->input_cache_key(*input_socket);
+        if (!input_key.has_value()) {
+          return {};
+        }
+        key.add(*input_key);
+      }
+    }
+    for (const DOutputSocket *output_socket : node.outputs()) {
+      key.add(output_socket->is_available());
+    }
+    return key.get();
+  }
 
-    if (!socket_to_compute.is_available()) {
-      /* If the output is not available, use a default value. */
-      const CPPType &type = *blender::nodes::socket_cpp_type_get(*socket_to_compute.typeinfo());
+  /* Compute the key of the value that the input will get, following #prepare_input. */
+  std::optional<uint64_t> input_cache_key(const DInputSocket &socket)
+  {
+    const CPPType &type = *blender::nodes::socket_cpp_type_get(*socket.typeinfo());
+    Span<const DOutputSocket *> from_sockets = socket.linked_sockets();
+    if (from_sockets.size() == 0) {
+      const bNodeSocket &bsocket = (socket.linked_group_inputs().size() == 0) ?
+                                       *socket.bsocket() :
+                                       *socket.linked_group_inputs()[0]->bsocket();
+      if (bsocket.type == SOCK_OBJECT) {
+        return {};
+      }
       void *buffer = allocator_.allocate(type.size(), type.alignment());
-      type.copy_to_uninitialized(type.default_value(), buffer);
-      this->forward_to_inputs(socket_to_compute, {type, buffer});
-      return;
+      blender::nodes::socket_cpp_value_get(bsocket, buffer);
+      const std::optional<uint64_t> key = value_cache_key(type, buffer);
+      type.destruct(buffer);
+      return key;
     }
 
+    const DOutputSocket &from_socket = *from_sockets[0];
+    const std::optional<uint64_t> *group_input_key = group_input_keys_.lookup_ptr(&from_socket);
+    if (group_input_key != nullptr) {
+      if (!group_input_key->has_value()) {
+        return {};
+      }
+      /* Conversions are deterministic, so the type of the input is enough to identify them. */
+      CacheKeyBuilder key;
+      key.add(**group_input_key);
+      key.add(type.hash());
+      return key.get();
+    }
+
+    CacheKeyBuilder key;
+    if (!from_socket.is_available()) {
+      key.add(blender::nodes::socket_cpp_type_get(*from_socket.typeinfo())->hash());
+    }
+    else {
+      const std::optional<uint64_t> from_node_key = this->node_cache_key(from_socket.node());
+      if (!from_node_key.has_value()) {
+        return {};
+      }
+      key.add(*from_node_key);
+      key.add(static_cast<uint64_t>(from_socket.index()));
+    }
+    key.add(type.hash());
+    return key.get();
+  }
+
+  /* Free the outputs which are not needed anymore and store the newly computed ones. Outputs of
+   * nodes that were skipped, because a node after them was cached, are kept as well. When not
+   * all new outputs fit into the cache, the ones of the slowest nodes are kept. */
+  void update_cache()
+  {
+    for (const std::optional<uint64_t> &key : node_keys_.values()) {
+      if (key.has_value()) {
+        cache_->mark_used(*key);
+      }
+    }
+    cache_->remove_unused();
+
+    Vector<NodeState *> states_to_cache;
+    for (std::unique_ptr<NodeState> &state : node_states_.values()) {
+      if (state->outputs_to_cache) {
+        state->outputs_to_cache->bytes = state->stats.bytes;
+        states_to_cache.append(state.get());
+      }
+    }
+    std::sort(states_to_cache.begin(),
+              states_to_cache.end(),
+              [](const NodeState *a, const NodeState *b) { return a->stats.time > b->stats.time; });
+    for (NodeState *state : states_to_cache) {
+      cache_->add(*state->cache_key, std::move(state->outputs_to_cache));
+    }
+  }
+
+  void execute_nodes(Span<const DNode *> ready_nodes)
+  {
+    TaskPool *task_pool = BLI_task_pool_create(this, TASK_PRIORITY_HIGH);
+    for (const DNode *node : ready_nodes) {
+      BLI_task_pool_push(task_pool, execute_node_task, const_cast<DNode *>(node), false, nullptr);
+    }
+    BLI_task_pool_work_and_wait(task_pool);
+    BLI_task_pool_free(task_pool);
+  }
+
+  static void execute_node_task(TaskPool *__restrict pool, void *taskdata)
+  {
+    GeometryNodesEvaluator &evaluator = *(GeometryNodesEvaluator *)BLI_task_pool_user_data(pool);
+    const DNode &node = *(const DNode *)taskdata;
+    evaluator.compute_and_forward(node, pool);
+  }
+
+  GMutablePointer get_input_value(const DInputSocket &socket_to_compute,
+                                  blender::LinearAllocator<> &allocator)
+  {
+    {
+      std::lock_guard<std::mutex> lock{value_by_input_mutex_};
+      std::optional<GMutablePointer> value = value_by_input_.pop_try(&socket_to_compute);
+      if (value.has_value()) {
+        /* This input has been computed before, return it directly. */
+        return *value;
+      }
+    }
+
+    /* Linked inputs are computed before the node is executed. The input is either not connected
+     * or gets its value from the input of a group that is not further connected. */
+    BLI_assert(socket_to_compute.linked_sockets().size() == 0);
+    return this->get_unlinked_input_value(socket_to_compute, allocator);
+  }
+
+  void compute_and_forward(const DNode &node, TaskPool *task_pool)
+  {
+    NodeState &state = *node_states_.lookup(&node);
+    if (state.cached_outputs != nullptr) {
+      this->forward_cached_outputs(node, state);
+    }
+    else {
+      this->compute_and_forward_outputs(node, state);
+    }
+
+    /* Schedule nodes which have all their inputs computed now. */
+    this->schedule_linked_nodes(node, task_pool);
+  }
+
+  void compute_and_forward_outputs(const DNode &node, NodeState &state)
+  {
+    const bNode &bnode = *node.bnode();
+    blender::LinearAllocator<> &allocator = state.allocator;
+
     /* Prepare inputs required to execute the node. */
-    GValueMap<StringRef> node_inputs_map{allocator_};
+    GValueMap<StringRef> node_inputs_map{allocator};
     for (const DInputSocket *input_socket : node.inputs()) {
       if (input_socket->is_available()) {
-        GMutablePointer value = this->get_input_value(*input_socket);
+        GMutablePointer value = this->get_input_value(*input_socket, allocator);
         node_inputs_map.add_new_direct(input_socket->identifier(), value);
       }
     }
 
     /* Execute the node. */
-    GValueMap<StringRef> node_outputs_map{allocator_};
+    GValueMap<StringRef> node_outputs_map{allocator};
     GeoNodeExecParams params{bnode, node_inputs_map, node_outputs_map, handle_map_, self_object_};
-    this->execute_node(node, params);
+    const double start_time = PIL_check_seconds_timer();
+    this->execute_node(node, params, allocator);
+    state.stats.time = PIL_check_seconds_timer() - start_time;
 
     /* Forward computed outputs to linked input sockets. */
+    if (state.cache_key.has_value()) {
+      state.outputs_to_cache = std::make_unique<CachedNodeOutputs>(node.outputs().size());
+    }
+    for (const int i : node.outputs().index_range()) {
+      const DOutputSocket &output_socket = node.output(i);
+      if (output_socket.is_available()) {
+        GMutablePointer value = node_outputs_map.extract(output_socket.identifier());
+        value_add_stats(value, state.stats);
+        if (state.outputs_to_cache) {
+          /* Copy before forwarding, because the value might be moved or modified later on. */
+          state.outputs_to_cache->values[i] = copy_value_for_cache(value);
+        }
+        this->forward_to_inputs(output_socket, value, allocator);
+      }
+    }
+  }
+
+  static GMutablePointer copy_value_for_cache(GMutablePointer value)
+  {
+    const CPPType &type = *value.type();
+    void *buffer = MEM_mallocN_aligned(type.size(), type.alignment(), __func__);
+    type.copy_to_uninitialized(value.get(), buffer);
+    if (type.is<GeometrySet>()) {
+      /* The cache outlives the geometry that was passed to the modifier. Components are shared
+       * with the forwarded value otherwise, so this does not copy any data. */
+      static_cast<GeometrySet *>(buffer)->ensure_owns_direct_data();
+    }
+    return {type, buffer};
+  }
+
+  void forward_cached_outputs(const DNode &node, NodeState &state)
+  {
+    const CachedNodeOutputs &cached_outputs = *state.cached_outputs;
+    blender::LinearAllocator<> &allocator = state.allocator;
+    for (const int i : node.outputs().index_range()) {
+      const DOutputSocket &output_socket = node.output(i);
+      if (output_socket.is_available()) {
+        const GMutablePointer cached_value = cached_outputs.values[i];
+        value_add_stats(cached_value, state.stats);
+        const CPPType &type = *cached_value.type();
+        void *buffer = allocator.allocate(type.size(), type.alignment());
+        type.copy_to_uninitialized(cached_value.get(), buffer);
+        this->forward_to_inputs(output_socket, {type, buffer}, allocator);
+      }
+    }
+  }
+
+  void schedule_linked_nodes(const DNode &node, TaskPool *task_pool)
+  {
     for (const DOutputSocket *output_socket : node.outputs()) {
-      if (output_socket->is_available()) {
-        GMutablePointer value = node_outputs_map.extract(output_socket->identifier());
-        this->forward_to_inputs(*output_socket, value);
+      if (!output_socket->is_available()) {
+        continue;
+      }
+      for (const DInputSocket *to_socket : output_socket->linked_sockets()) {
+        if (!to_socket->is_available()) {
+          continue;
+        }
+        const std::unique_ptr<NodeState> *to_state = node_states_.lookup_ptr(&to_socket->node());
+        if (to_state == nullptr) {
+          /* The node is not required to compute the group outputs. */
+          continue;
+        }
+        if ((*to_state)->cached_outputs != nullptr) {
+          /* The node does not use its inputs and has been scheduled already. */
+          continue;
+        }
+        if ((*to_state)->missing_inputs.fetch_sub(1) == 1) {
+          DNode *to_node = const_cast<DNode *>(&to_socket->node());
+          BLI_task_pool_push(task_pool, execute_node_task, to_node, false, nullptr);
+        }
       }
     }
   }
 
-  void execute_node(const DNode &node, GeoNodeExecParams params)
+  void execute_node(const DNode &node,
+                    GeoNodeExecParams params,
+                    blender::LinearAllocator<> &allocator)
   {
     const bNode &bnode = params.node();
     if (bnode.typeinfo->geometry_node_execute != nullptr) {
@@ -314,7 +994,7 @@ class GeometryNodesEvaluator {
     for (const DOutputSocket *dsocket : node.outputs()) {
       if (dsocket->is_available()) {
         const CPPType &type = *blender::nodes::socket_cpp_type_get(*dsocket->typeinfo());
-        void *buffer = allocator_.allocate(type.size(), type.alignment());
+        void *buffer = allocator.allocate(type.size(), type.alignment());
         fn_params.add_uninitialized_single_output(GMutableSpan(type, buffer, 1));
         output_data.append(GMutablePointer(type, buffer));
       }
@@ -334,8 +1014,11 @@ class GeometryNodesEvaluator {
     }
   }
 
-  void forward_to_inputs(const DOutputSocket &from_socket, GMutablePointer value_to_forward)
+  void forward_to_inputs(const DOutputSocket &from_socket,
+                         GMutablePointer value_to_forward,
+                         blender::LinearAllocator<> &allocator)
   {
+    std::lock_guard<std::mutex> lock{value_by_input_mutex_};
     Span<const DInputSocket *> to_sockets_all = from_socket.linked_sockets();
 
     const CPPType &from_type = *value_to_forward.type();
@@ -347,7 +1030,7 @@ class GeometryNodesEvaluator {
         to_sockets_same_type.append(to_socket);
       }
       else {
-        void *buffer = allocator_.allocate(to_type.size(), to_type.alignment());
+        void *buffer = allocator.allocate(to_type.size(), to_type.alignment());
         if (conversions_.is_convertible(from_type, to_type)) {
           conversions_.convert(from_type, to_type, value_to_forward.get(), buffer);
         }
@@ -375,14 +1058,15 @@ class GeometryNodesEvaluator {
 
       value_by_input_.add_new(first_to_socket, value_to_forward);
       for (const DInputSocket *to_socket : other_to_sockets) {
-        void *buffer = allocator_.allocate(type.size(), type.alignment());
+        void *buffer = allocator.allocate(type.size(), type.alignment());
         type.copy_to_uninitialized(value_to_forward.get(), buffer);
         value_by_input_.add_new(to_socket, GMutablePointer{type, buffer});
       }
     }
   }
 
-  GMutablePointer get_unlinked_input_value(const DInputSocket &socket)
+  GMutablePointer get_unlinked_input_value(const DInputSocket &socket,
+                                           blender::LinearAllocator<> &allocator)
   {
     bNodeSocket *bsocket;
     if (socket.linked_group_inputs().size() == 0) {
@@ -392,7 +1076,7 @@ class GeometryNodesEvaluator {
       bsocket = socket.linked_group_inputs()[0]->bsocket();
     }
     const CPPType &type = *blender::nodes::socket_cpp_type_get(*socket.typeinfo());
-    void *buffer = allocator_.allocate(type.size(), type.alignment());
+    void *buffer = allocator.allocate(type.size(), type.alignment());
 
     if (bsocket->type == SOCK_OBJECT) {
       Object *object = ((bNodeSocketValueObject *)bsocket->default_value)->value;
@@ -766,10 +1450,17 @@ static void fill_data_handle_map(const DerivedNodeTree &tree,
   }
 }
 
+static NodesModifierRuntime &nodes_modifier_runtime_ensure(NodesModifierData &nmd)
+{
+  if (nmd.modifier.runtime == nullptr) {
+    nmd.modifier.runtime = new NodesModifierRuntime();
+  }
+  return *static_cast<NodesModifierRuntime *>(nmd.modifier.runtime);
+}
+
 /**
  * Evaluate a node group to compute the output geometry.
- * Currently, this uses a fairly basic and inefficient algorithm that might compute things more
- * often than necessary. It's going to be replaced soon.
+ * Node outputs are reused from previous evaluations of the modifier when possible.
  */
 static GeometrySet compute_geometry(const DerivedNodeTree &tree,
                                     Span<const DOutputSocket *> group_input_sockets,
@@ -812,9 +1503,14 @@ static GeometrySet compute_geometry(const DerivedNodeTree &tree,
   blender::bke::PersistentDataHandleMap handle_map;
   fill_data_handle_map(tree, handle_map);
 
+  NodesModifierRuntime &runtime = nodes_modifier_runtime_ensure(*nmd);
+  /* A final render evaluates the modifier once, keeping the outputs would only use memory. */
+  NodeOutputCache *cache = (DEG_get_mode(ctx->depsgraph) == DAG_EVAL_RENDER) ? nullptr :
+                                                                                &runtime.cache;
   GeometryNodesEvaluator evaluator{
-      group_inputs, group_outputs, mf_by_node, handle_map, ctx->object};
+      group_inputs, group_outputs, mf_by_node, handle_map, ctx->object, cache};
   Vector<GMutablePointer> results = evaluator.execute();
+  runtime.node_stats = evaluator.node_stats();
   BLI_assert(results.size() == 1);
   GMutablePointer result = results[0];
 
@@ -1034,6 +1730,12 @@ static void copyData(const ModifierData *md, ModifierData *target, const int fla
   }
 }
 
+static void freeRuntimeData(void *runtime_data_v)
+{
+  NodesModifierRuntime *runtime = static_cast<NodesModifierRuntime *>(runtime_data_v);
+  delete runtime;
+}
+
 static void freeData(ModifierData *md)
 {
   NodesModifierData *nmd = reinterpret_cast<NodesModifierData *>(md);
@@ -1041,6 +1743,28 @@ static void freeData(ModifierData *md)
     IDP_FreeProperty_ex(nmd->settings.properties, false);
     nmd->settings.properties = nullptr;
   }
+  freeRuntimeData(md->runtime);
+  md->runtime = nullptr;
+}
+
+/**
+ * Get the statistics of a node in the last evaluation of an evaluated modifier.
+ */
+bool MOD_nodes_node_stats_get(const NodesModifierData *nmd,
+                              const char *node_name,
+                              NodesModifierNodeStats *r_stats)
+{
+  const NodesModifierRuntime *runtime = static_cast<const NodesModifierRuntime *>(
+      nmd->modifier.runtime);
+  if (runtime == nullptr) {
+    return false;
+  }
+  const NodesModifierNodeStats *stats = runtime->node_stats.lookup_ptr_as(StringRef(node_name));
+  if (stats == nullptr) {
+    return false;
+  }
+  *r_stats = *stats;
+  return true;
 }
 
 ModifierTypeInfo modifierType_Nodes = {
@@ -1075,7 +1799,7 @@ ModifierTypeInfo modifierType_Nodes = {
     /* dependsOnNormals */ nullptr,
     /* foreachIDLink */ foreachIDLink,
     /* foreachTexLink */ nullptr,
-    /* freeRuntimeData */ nullptr,
+    /* freeRuntimeData */ freeRuntimeData,
     /* panelRegister */ panelRegister,
     /* blendWrite */ blendWrite,
     /* blendRead */ blendRead,
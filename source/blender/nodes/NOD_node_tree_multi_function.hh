@@ -422,6 +422,10 @@ class DataTypeConversions {
                const CPPType &to_type,
                const void *from_value,
                void *to_value) const;
+
+  /* Convert all values at once, which is much faster than calling #convert for every value.
+   * The values in the destination span are expected to be uninitialized. */
+  void convert_to_uninitialized_n(fn::GSpan from_span, fn::GMutableSpan to_span) const;
 };
 
 const DataTypeConversions &get_implicit_type_conversions();
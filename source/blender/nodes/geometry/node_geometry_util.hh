@@ -37,3 +37,25 @@
 void geo_node_type_base(
     struct bNodeType *ntype, int type, const char *name, short nclass, short flag);
 bool geo_node_poll_default(struct bNodeType *ntype, struct bNodeTree *ntree);
+
+namespace blender::nodes {
+
+/**
+ * Split edges like the Edge Split modifier, without converting to BMesh.
+ * Returns null when no edge is split.
+ */
+Mesh *mesh_edge_split(const Mesh &mesh,
+                      bool use_edge_angle,
+                      float split_angle,
+                      bool use_sharp_flag);
+
+/**
+ * Triangulate faces like the Triangulate modifier, without converting to BMesh.
+ * Returns null when no face has to be triangulated.
+ */
+Mesh *mesh_triangulate(const Mesh &mesh,
+                       GeometryNodeTriangulateQuads quad_method,
+                       GeometryNodeTriangulateNGons ngon_method,
+                       int min_vertices);
+
+}  // namespace blender::nodes
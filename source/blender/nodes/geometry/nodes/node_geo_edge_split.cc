@@ -14,16 +14,21 @@
  * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
  */
 
+#include "BLI_array.hh"
+#include "BLI_disjoint_set.hh"
+#include "BLI_float3.hh"
 #include "BLI_math_base.h"
 #include "BLI_math_rotation.h"
+#include "BLI_task.hh"
+#include "BLI_vector.hh"
 
-#include "DNA_modifier_types.h"
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
 
-#include "node_geometry_util.hh"
+#include "BKE_customdata.h"
+#include "BKE_mesh.h"
 
-extern "C" {
-Mesh *doEdgeSplit(const Mesh *mesh, EdgeSplitModifierData *emd);
-}
+#include "node_geometry_util.hh"
 
 static bNodeSocketTemplate geo_node_edge_split_in[] = {
     {SOCK_GEOMETRY, N_("Geometry")},
@@ -47,6 +52,255 @@ static bNodeSocketTemplate geo_node_edge_split_out[] = {
 };
 
 namespace blender::nodes {
+
+/* -------------------------------------------------------------------- */
+/** \name Mesh Edge Split
+ *
+ * Splits #Mesh data directly instead of going through BMesh. Edges are tagged the same way as
+ * the Edge Split modifier does, the corners around every vertex are then grouped into fans which
+ * are not separated by a tagged edge. Like #BM_mesh_edgesplit, only vertices of tagged edges are
+ * separated: every fan but the first and every loose edge get their own vertex there.
+ * \{ */
+
+/**
+ * Tag the edges to split, see #doEdgeSplit.
+ */
+static Array<bool> mesh_edge_split_tag(const Mesh &mesh,
+                                       const bool use_edge_angle,
+                                       const float split_angle,
+                                       const bool use_sharp_flag)
+{
+  const float threshold = cosf(split_angle + 0.000000175f);
+  const bool do_split_angle = use_edge_angle && split_angle < float(M_PI);
+  const bool do_split_all = do_split_angle && split_angle < FLT_EPSILON;
+
+  /* Number of faces using every edge, and the first two of them. */
+  Array<int> edge_users(mesh.totedge, 0);
+  Array<int> edge_polys(mesh.totedge * 2, -1);
+  for (const int i : IndexRange(mesh.totpoly)) {
+    const MPoly &mpoly = mesh.mpoly[i];
+    for (const int loop : IndexRange(mpoly.loopstart, mpoly.totloop)) {
+      const int edge = mesh.mloop[loop].e;
+      if (edge_users[edge] < 2) {
+        edge_polys[edge * 2 + edge_users[edge]] = i;
+      }
+      edge_users[edge]++;
+    }
+  }
+
+  Array<float3> poly_normals;
+  if (do_split_angle && !do_split_all) {
+    poly_normals.reinitialize(mesh.totpoly);
+    parallel_for(IndexRange(mesh.totpoly), 1024, [&](IndexRange range) {
+      for (const int i : range) {
+        const MPoly &mpoly = mesh.mpoly[i];
+        BKE_mesh_calc_poly_normal(
+            &mpoly, &mesh.mloop[mpoly.loopstart], mesh.mvert, poly_normals[i]);
+      }
+    });
+  }
+
+  Array<bool> split_edges(mesh.totedge);
+  parallel_for(IndexRange(mesh.totedge), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      bool split = false;
+      if (do_split_angle && edge_users[i] >= 2) {
+        /* Edges with 3+ faces are always split. */
+        split = edge_users[i] > 2 || do_split_all ||
+                float3::dot(poly_normals[edge_polys[i * 2]], poly_normals[edge_polys[i * 2 + 1]]) <
+                    threshold;
+      }
+      if (use_sharp_flag && edge_users[i] >= 1 && (mesh.medge[i].flag & ME_SHARP)) {
+        split = true;
+      }
+      split_edges[i] = split;
+    }
+  });
+  return split_edges;
+}
+
+/**
+ * Split the tagged edges. Returns null when the topology doesn't change.
+ */
+static Mesh *mesh_edge_split_tagged(const Mesh &mesh, const Span<bool> split_edges)
+{
+  const Span<MPoly> polys{mesh.mpoly, mesh.totpoly};
+  const Span<MLoop> loops{mesh.mloop, mesh.totloop};
+  const Span<MEdge> edges{mesh.medge, mesh.totedge};
+
+  auto next_loop = [&](const MPoly &mpoly, const int loop) {
+    return (loop + 1 == mpoly.loopstart + mpoly.totloop) ? mpoly.loopstart : loop + 1;
+  };
+
+  /* Join the corners of faces sharing an edge which isn't split, at both ends of the edge. The
+   * corners at the first and second vertex of the edge are stored for the first face using it. */
+  DisjointSet fans(loops.size());
+  Array<int> edge_corners(edges.size() * 2, -1);
+  for (const MPoly &mpoly : polys) {
+    for (const int loop : IndexRange(mpoly.loopstart, mpoly.totloop)) {
+      const int edge = loops[loop].e;
+      if (split_edges[edge]) {
+        continue;
+      }
+      const int loop_next = next_loop(mpoly, loop);
+      const bool flipped = int(loops[loop].v) != int(edges[edge].v1);
+      const int corner_v1 = flipped ? loop_next : loop;
+      const int corner_v2 = flipped ? loop : loop_next;
+      if (edge_corners[edge * 2] == -1) {
+        edge_corners[edge * 2] = corner_v1;
+        edge_corners[edge * 2 + 1] = corner_v2;
+      }
+      else {
+        fans.join(corner_v1, edge_corners[edge * 2]);
+        fans.join(corner_v2, edge_corners[edge * 2 + 1]);
+      }
+    }
+  }
+
+  Array<bool> verts_split(mesh.totvert, false);
+  for (const int i : edges.index_range()) {
+    if (split_edges[i]) {
+      verts_split[edges[i].v1] = true;
+      verts_split[edges[i].v2] = true;
+    }
+  }
+
+  /* The first fan around a vertex keeps it, the others get new vertices. */
+  Array<int> loop_verts(loops.size());
+  Array<int> fan_verts(loops.size(), -1);
+  Array<bool> verts_used(mesh.totvert, false);
+  Vector<int> new_vert_src;
+  for (const int loop : loops.index_range()) {
+    const int fan = int(fans.find_root(loop));
+    if (fan_verts[fan] == -1) {
+      const int vert = loops[loop].v;
+      if (!verts_split[vert] || !verts_used[vert]) {
+        verts_used[vert] = true;
+        fan_verts[fan] = vert;
+      }
+      else {
+        fan_verts[fan] = mesh.totvert + new_vert_src.append_and_get_index(vert);
+      }
+    }
+    loop_verts[loop] = fan_verts[fan];
+  }
+
+  /* Every split edge gets a copy for each distinct pair of vertices of the faces using it. Copies
+   * of the same edge are chained, starting at the original. */
+  Vector<int> edge_verts(edges.size() * 2);
+  Vector<int> edge_next(edges.size(), -1);
+  Vector<int> new_edge_src;
+  Array<bool> edges_used(edges.size(), false);
+  Array<int> loop_edges(loops.size());
+  for (const int i : edges.index_range()) {
+    edge_verts[i * 2] = edges[i].v1;
+    edge_verts[i * 2 + 1] = edges[i].v2;
+  }
+  for (const MPoly &mpoly : polys) {
+    for (const int loop : IndexRange(mpoly.loopstart, mpoly.totloop)) {
+      const int edge = loops[loop].e;
+      const int loop_next = next_loop(mpoly, loop);
+      const bool flipped = int(loops[loop].v) != int(edges[edge].v1);
+      const int v1 = loop_verts[flipped ? loop_next : loop];
+      const int v2 = loop_verts[flipped ? loop : loop_next];
+
+      int result_edge = edge;
+      if (edges_used[edge]) {
+        if (!split_edges[edge]) {
+          loop_edges[loop] = edge;
+          continue;
+        }
+        int last = edge;
+        for (result_edge = edge; result_edge != -1; result_edge = edge_next[result_edge]) {
+          if (edge_verts[result_edge * 2] == v1 && edge_verts[result_edge * 2 + 1] == v2) {
+            break;
+          }
+          last = result_edge;
+        }
+        if (result_edge == -1) {
+          result_edge = edges.size() + new_edge_src.append_and_get_index(edge);
+          edge_verts.append(v1);
+          edge_verts.append(v2);
+          edge_next.append(-1);
+          edge_next[last] = result_edge;
+        }
+      }
+      else {
+        edges_used[edge] = true;
+        edge_verts[edge * 2] = v1;
+        edge_verts[edge * 2 + 1] = v2;
+      }
+      loop_edges[loop] = result_edge;
+    }
+  }
+
+  /* Loose edges are separated from the faces and from each other at split vertices. */
+  for (const int i : edges.index_range()) {
+    if (edges_used[i]) {
+      continue;
+    }
+    for (const int side : IndexRange(2)) {
+      const int vert = edge_verts[i * 2 + side];
+      if (!verts_split[vert]) {
+        continue;
+      }
+      if (verts_used[vert]) {
+        edge_verts[i * 2 + side] = mesh.totvert + new_vert_src.append_and_get_index(vert);
+      }
+      verts_used[vert] = true;
+    }
+  }
+
+  if (new_vert_src.is_empty() && new_edge_src.is_empty()) {
+    return nullptr;
+  }
+
+  Mesh *result = BKE_mesh_new_nomain_from_template(&mesh,
+                                                   mesh.totvert + new_vert_src.size(),
+                                                   edges.size() + new_edge_src.size(),
+                                                   0,
+                                                   loops.size(),
+                                                   polys.size());
+
+  CustomData_copy_data(&mesh.vdata, &result->vdata, 0, 0, mesh.totvert);
+  CustomData_copy_data_indices(
+      &mesh.vdata, &result->vdata, new_vert_src.data(), mesh.totvert, new_vert_src.size());
+  CustomData_copy_data(&mesh.edata, &result->edata, 0, 0, edges.size());
+  CustomData_copy_data_indices(
+      &mesh.edata, &result->edata, new_edge_src.data(), edges.size(), new_edge_src.size());
+  CustomData_copy_data(&mesh.pdata, &result->pdata, 0, 0, polys.size());
+
+  parallel_for(IndexRange(result->totedge), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      result->medge[i].v1 = edge_verts[i * 2];
+      result->medge[i].v2 = edge_verts[i * 2 + 1];
+    }
+  });
+
+  parallel_for(loops.index_range(), 4096, [&](IndexRange range) {
+    CustomData_copy_data(&mesh.ldata, &result->ldata, range.start(), range.start(), range.size());
+    for (const int i : range) {
+      result->mloop[i].v = loop_verts[i];
+      result->mloop[i].e = loop_edges[i];
+    }
+  });
+
+  result->runtime.cd_dirty_vert |= CD_MASK_NORMAL;
+  return result;
+}
+
+Mesh *mesh_edge_split(const Mesh &mesh,
+                      const bool use_edge_angle,
+                      const float split_angle,
+                      const bool use_sharp_flag)
+{
+  const Array<bool> split_edges = mesh_edge_split_tag(
+      mesh, use_edge_angle, split_angle, use_sharp_flag);
+  return mesh_edge_split_tagged(mesh, split_edges);
+}
+
+/** \} */
+
 static void geo_node_edge_split_exec(GeoNodeExecParams params)
 {
   GeometrySet geometry_set = params.extract_input<GeometrySet>("Geometry");
@@ -67,19 +321,10 @@ static void geo_node_edge_split_exec(GeoNodeExecParams params)
   const float split_angle = params.extract_input<float>("Angle");
   const Mesh *mesh_in = geometry_set.get_mesh_for_read();
 
-  /* Use modifier struct to pass arguments to the modifier code. */
-  EdgeSplitModifierData emd;
-  memset(&emd, 0, sizeof(EdgeSplitModifierData));
-  emd.split_angle = split_angle;
-  if (use_edge_angle) {
-    emd.flags = MOD_EDGESPLIT_FROMANGLE;
+  Mesh *mesh_out = mesh_edge_split(*mesh_in, use_edge_angle, split_angle, use_sharp_flag);
+  if (mesh_out != nullptr) {
+    geometry_set.replace_mesh(mesh_out);
   }
-  if (use_sharp_flag) {
-    emd.flags |= MOD_EDGESPLIT_FROMFLAG;
-  }
-
-  Mesh *mesh_out = doEdgeSplit(mesh_in, &emd);
-  geometry_set.replace_mesh(mesh_out);
 
   params.set_output("Geometry", std::move(geometry_set));
 }
@@ -0,0 +1,198 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 by Blender Foundation.
+ */
+#include "testing/testing.h"
+
+#include "BLI_map.hh"
+#include "BLI_math_rotation.h"
+#include "BLI_math_vector.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_modifier_types.h"
+
+#include "BKE_lib_id.h"
+#include "BKE_mesh.h"
+
+#include "node_geometry_util.hh"
+
+extern "C" {
+Mesh *doEdgeSplit(const Mesh *mesh, EdgeSplitModifierData *emd);
+}
+
+namespace blender::nodes::tests {
+
+/* Create a mesh from the vertex indices of the faces, and extra loose edges. */
+static Mesh *mesh_from_faces(const int totvert,
+                             Span<Vector<int>> faces,
+                             Span<std::pair<int, int>> loose_edges)
+{
+  Map<std::pair<int, int>, int> edge_map;
+  Vector<std::pair<int, int>> edges;
+  auto edge_index = [&](const int v1, const int v2) {
+    const std::pair<int, int> key(std::min(v1, v2), std::max(v1, v2));
+    return edge_map.lookup_or_add_cb(key, [&]() {
+      edges.append(key);
+      return int(edges.size() - 1);
+    });
+  };
+  int totloop = 0;
+  for (const Vector<int> &face : faces) {
+    for (const int i : face.index_range()) {
+      edge_index(face[i], face[(i + 1) % face.size()]);
+    }
+    totloop += face.size();
+  }
+  for (const std::pair<int, int> &edge : loose_edges) {
+    edge_index(edge.first, edge.second);
+  }
+
+  Mesh *mesh = BKE_mesh_new_nomain(totvert, edges.size(), 0, totloop, faces.size());
+  for (const int i : IndexRange(totvert)) {
+    /* Positions on a helix, so that no face is degenerate. */
+    mesh->mvert[i].co[0] = cosf(float(i));
+    mesh->mvert[i].co[1] = sinf(float(i));
+    mesh->mvert[i].co[2] = float(i) * 0.1f;
+  }
+  for (const int i : edges.index_range()) {
+    mesh->medge[i].v1 = edges[i].first;
+    mesh->medge[i].v2 = edges[i].second;
+  }
+  int loop = 0;
+  for (const int i : faces.index_range()) {
+    const Vector<int> &face = faces[i];
+    mesh->mpoly[i].loopstart = loop;
+    mesh->mpoly[i].totloop = face.size();
+    for (const int j : face.index_range()) {
+      mesh->mloop[loop].v = face[j];
+      mesh->mloop[loop].e = edge_index(face[j], face[(j + 1) % face.size()]);
+      loop++;
+    }
+  }
+  return mesh;
+}
+
+static void mesh_edge_set_sharp(Mesh *mesh, const int v1, const int v2)
+{
+  for (const int i : IndexRange(mesh->totedge)) {
+    MEdge &edge = mesh->medge[i];
+    if ((int(edge.v1) == v1 && int(edge.v2) == v2) || (int(edge.v1) == v2 && int(edge.v2) == v1)) {
+      edge.flag |= ME_SHARP;
+    }
+  }
+}
+
+/**
+ * Compare the result of the node with the modifier. Faces and corners keep their order in both,
+ * new vertices and edges are numbered differently, so compare which corners share them.
+ */
+static void expect_same_as_modifier(const Mesh *mesh,
+                                    const bool use_edge_angle,
+                                    const float split_angle,
+                                    const bool use_sharp_flag)
+{
+  EdgeSplitModifierData emd = {};
+  emd.split_angle = split_angle;
+  emd.flags = (use_edge_angle ? MOD_EDGESPLIT_FROMANGLE : 0) |
+              (use_sharp_flag ? MOD_EDGESPLIT_FROMFLAG : 0);
+  Mesh *expected = doEdgeSplit(mesh, &emd);
+  Mesh *result = mesh_edge_split(*mesh, use_edge_angle, split_angle, use_sharp_flag);
+  const Mesh *actual = (result == nullptr) ? mesh : result;
+
+  EXPECT_EQ(actual->totvert, expected->totvert);
+  EXPECT_EQ(actual->totedge, expected->totedge);
+  ASSERT_EQ(actual->totloop, expected->totloop);
+  ASSERT_EQ(actual->totpoly, expected->totpoly);
+  for (const int i : IndexRange(actual->totloop)) {
+    for (const int j : IndexRange(i + 1, actual->totloop - i - 1)) {
+      EXPECT_EQ(actual->mloop[i].v == actual->mloop[j].v,
+                expected->mloop[i].v == expected->mloop[j].v)
+          << "corners " << i << " " << j;
+      EXPECT_EQ(actual->mloop[i].e == actual->mloop[j].e,
+                expected->mloop[i].e == expected->mloop[j].e)
+          << "corners " << i << " " << j;
+    }
+  }
+
+  BKE_id_free(nullptr, expected);
+  if (result != nullptr) {
+    BKE_id_free(nullptr, result);
+  }
+}
+
+/* Two triangles sharing vertex 0, with a quad attached to the first one. */
+static Mesh *bowtie_mesh()
+{
+  const Vector<Vector<int>> faces = {{0, 1, 2}, {0, 3, 4}, {1, 5, 6, 2}};
+  return mesh_from_faces(7, faces, {});
+}
+
+TEST(edge_split, bowtie_not_tagged)
+{
+  /* The bowtie vertex is not used by a tagged edge, so it stays as it is. */
+  Mesh *mesh = bowtie_mesh();
+  mesh_edge_set_sharp(mesh, 1, 2);
+  expect_same_as_modifier(mesh, false, 0.0f, true);
+  Mesh *result = mesh_edge_split(*mesh, false, 0.0f, true);
+  ASSERT_NE(result, nullptr);
+  EXPECT_EQ(result->totvert, 9);
+  BKE_id_free(nullptr, result);
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST(edge_split, bowtie_tagged)
+{
+  Mesh *mesh = bowtie_mesh();
+  mesh_edge_set_sharp(mesh, 0, 1);
+  expect_same_as_modifier(mesh, false, 0.0f, true);
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST(edge_split, loose_edge)
+{
+  /* Two quads split at their shared edge, with loose edges at both of its vertices. */
+  const Vector<Vector<int>> faces = {{0, 1, 2, 3}, {1, 4, 5, 2}};
+  const Vector<std::pair<int, int>> loose_edges = {{1, 6}, {2, 7}};
+  Mesh *mesh = mesh_from_faces(8, faces, loose_edges);
+  mesh_edge_set_sharp(mesh, 1, 2);
+  expect_same_as_modifier(mesh, false, 0.0f, true);
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST(edge_split, edge_angle)
+{
+  /* A cube, all edges are split at 30 degrees. */
+  const Vector<Vector<int>> faces = {
+      {0, 1, 2, 3}, {7, 6, 5, 4}, {0, 4, 5, 1}, {1, 5, 6, 2}, {2, 6, 7, 3}, {3, 7, 4, 0}};
+  Mesh *mesh = mesh_from_faces(8, faces, {});
+  const float corners[8][3] = {{-1.0f, -1.0f, -1.0f},
+                               {1.0f, -1.0f, -1.0f},
+                               {1.0f, 1.0f, -1.0f},
+                               {-1.0f, 1.0f, -1.0f},
+                               {-1.0f, -1.0f, 1.0f},
+                               {1.0f, -1.0f, 1.0f},
+                               {1.0f, 1.0f, 1.0f},
+                               {-1.0f, 1.0f, 1.0f}};
+  for (const int i : IndexRange(8)) {
+    copy_v3_v3(mesh->mvert[i].co, corners[i]);
+  }
+  expect_same_as_modifier(mesh, true, DEG2RADF(30.0f), false);
+  expect_same_as_modifier(mesh, true, DEG2RADF(100.0f), false);
+  BKE_id_free(nullptr, mesh);
+}
+
+}  // namespace blender::nodes::tests
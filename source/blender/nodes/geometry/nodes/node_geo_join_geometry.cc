@@ -14,6 +14,8 @@
  * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
  */
 
+#include "BLI_task.hh"
+
 #include "BKE_mesh.h"
 #include "BKE_mesh_runtime.h"
 #include "BKE_pointcloud.h"
@@ -36,67 +38,91 @@ static bNodeSocketTemplate geo_node_join_geometry_out[] = {
 
 namespace blender::nodes {
 
+/**
+ * Offsets of every component in the joined element arrays, with the total size at the end.
+ */
+template<typename GetSizeFn>
+static Array<int> accumulate_offsets(const int64_t components_num, const GetSizeFn &get_size)
+{
+  Array<int> offsets(components_num + 1);
+  offsets[0] = 0;
+  for (const int i : IndexRange(components_num)) {
+    offsets[i + 1] = offsets[i] + get_size(i);
+  }
+  return offsets;
+}
+
 static Mesh *join_mesh_topology_and_builtin_attributes(Span<const MeshComponent *> src_components)
 {
-  int totverts = 0;
-  int totloops = 0;
-  int totedges = 0;
-  int totpolys = 0;
-
-  for (const MeshComponent *mesh_component : src_components) {
-    const Mesh *mesh = mesh_component->get_for_read();
-    totverts += mesh->totvert;
-    totloops += mesh->totloop;
-    totedges += mesh->totedge;
-    totpolys += mesh->totpoly;
+  Array<const Mesh *> meshes(src_components.size());
+  for (const int i : src_components.index_range()) {
+    meshes[i] = src_components[i]->get_for_read();
   }
 
-  const Mesh *first_input_mesh = src_components[0]->get_for_read();
-  Mesh *new_mesh = BKE_mesh_new_nomain(totverts, totedges, 0, totloops, totpolys);
+  auto mesh_size = [&](const int i, int Mesh::*size) {
+    return meshes[i] == nullptr ? 0 : meshes[i]->*size;
+  };
+  const Array<int> vert_offsets = accumulate_offsets(
+      meshes.size(), [&](const int i) { return mesh_size(i, &Mesh::totvert); });
+  const Array<int> edge_offsets = accumulate_offsets(
+      meshes.size(), [&](const int i) { return mesh_size(i, &Mesh::totedge); });
+  const Array<int> loop_offsets = accumulate_offsets(
+      meshes.size(), [&](const int i) { return mesh_size(i, &Mesh::totloop); });
+  const Array<int> poly_offsets = accumulate_offsets(
+      meshes.size(), [&](const int i) { return mesh_size(i, &Mesh::totpoly); });
+
+  const Mesh *first_input_mesh = meshes[0];
+  Mesh *new_mesh = BKE_mesh_new_nomain(vert_offsets.last(),
+                                       edge_offsets.last(),
+                                       0,
+                                       loop_offsets.last(),
+                                       poly_offsets.last());
   BKE_mesh_copy_settings(new_mesh, first_input_mesh);
 
-  int vert_offset = 0;
-  int loop_offset = 0;
-  int edge_offset = 0;
-  int poly_offset = 0;
-  for (const MeshComponent *mesh_component : src_components) {
-    const Mesh *mesh = mesh_component->get_for_read();
-    if (mesh == nullptr) {
-      continue;
+  /* Every component writes to its own ranges of the preallocated arrays. Large meshes are split
+   * further, many small meshes are copied in parallel with each other. */
+  const int grain_size = 4096;
+  parallel_for(meshes.index_range(), 1, [&](IndexRange range) {
+    for (const int component_index : range) {
+      const Mesh *mesh = meshes[component_index];
+      if (mesh == nullptr) {
+        continue;
+      }
+      const int vert_offset = vert_offsets[component_index];
+      const int edge_offset = edge_offsets[component_index];
+      const int loop_offset = loop_offsets[component_index];
+      const int poly_offset = poly_offsets[component_index];
+
+      parallel_for(IndexRange(mesh->totvert), grain_size, [&](IndexRange elements) {
+        memcpy(new_mesh->mvert + vert_offset + elements.start(),
+               mesh->mvert + elements.start(),
+               sizeof(MVert) * elements.size());
+      });
+      parallel_for(IndexRange(mesh->totedge), grain_size, [&](IndexRange elements) {
+        for (const int i : elements) {
+          MEdge &new_edge = new_mesh->medge[edge_offset + i];
+          new_edge = mesh->medge[i];
+          new_edge.v1 += vert_offset;
+          new_edge.v2 += vert_offset;
+        }
+      });
+      parallel_for(IndexRange(mesh->totloop), grain_size, [&](IndexRange elements) {
+        for (const int i : elements) {
+          MLoop &new_loop = new_mesh->mloop[loop_offset + i];
+          new_loop = mesh->mloop[i];
+          new_loop.v += vert_offset;
+          new_loop.e += edge_offset;
+        }
+      });
+      parallel_for(IndexRange(mesh->totpoly), grain_size, [&](IndexRange elements) {
+        for (const int i : elements) {
+          MPoly &new_poly = new_mesh->mpoly[poly_offset + i];
+          new_poly = mesh->mpoly[i];
+          new_poly.loopstart += loop_offset;
+        }
+      });
     }
-
-    for (const int i : IndexRange(mesh->totvert)) {
-      const MVert &old_vert = mesh->mvert[i];
-      MVert &new_vert = new_mesh->mvert[vert_offset + i];
-      new_vert = old_vert;
-    }
-
-    for (const int i : IndexRange(mesh->totedge)) {
-      const MEdge &old_edge = mesh->medge[i];
-      MEdge &new_edge = new_mesh->medge[edge_offset + i];
-      new_edge = old_edge;
-      new_edge.v1 += vert_offset;
-      new_edge.v2 += vert_offset;
-    }
-    for (const int i : IndexRange(mesh->totloop)) {
-      const MLoop &old_loop = mesh->mloop[i];
-      MLoop &new_loop = new_mesh->mloop[loop_offset + i];
-      new_loop = old_loop;
-      new_loop.v += vert_offset;
-      new_loop.e += edge_offset;
-    }
-    for (const int i : IndexRange(mesh->totpoly)) {
-      const MPoly &old_poly = mesh->mpoly[i];
-      MPoly &new_poly = new_mesh->mpoly[poly_offset + i];
-      new_poly = old_poly;
-      new_poly.loopstart += loop_offset;
-    }
-
-    vert_offset += mesh->totvert;
-    loop_offset += mesh->totloop;
-    edge_offset += mesh->totedge;
-    poly_offset += mesh->totpoly;
-  }
+  });
 
   return new_mesh;
 }
@@ -146,19 +172,27 @@ static void fill_new_attribute(Span<const GeometryComponent *> src_components,
   const CPPType *cpp_type = bke::custom_data_type_to_cpp_type(data_type);
   BLI_assert(cpp_type != nullptr);
 
-  int offset = 0;
-  for (const GeometryComponent *component : src_components) {
-    const int domain_size = component->attribute_domain_size(domain);
-    ReadAttributePtr read_attribute = component->attribute_get_for_read(
-        attribute_name, domain, data_type, nullptr);
-
-    fn::GSpan src_span = read_attribute->get_span();
-    const void *src_buffer = src_span.data();
-    void *dst_buffer = dst_span[offset];
-    cpp_type->copy_to_initialized_n(src_buffer, dst_buffer, domain_size);
-
-    offset += domain_size;
-  }
+  const Array<int> offsets = accumulate_offsets(src_components.size(), [&](const int i) {
+    return src_components[i]->attribute_domain_size(domain);
+  });
+  BLI_assert(offsets.last() == dst_span.size());
+
+  parallel_for(src_components.index_range(), 1, [&](IndexRange range) {
+    for (const int i : range) {
+      const int domain_size = offsets[i + 1] - offsets[i];
+      if (domain_size == 0) {
+        continue;
+      }
+      ReadAttributePtr read_attribute = src_components[i]->attribute_get_for_read(
+          attribute_name, domain, data_type, nullptr);
+
+      /* Read directly into the joined array, without building a span for converted or
+       * interpolated attributes first. */
+      void *dst_buffer = dst_span[offsets[i]];
+      cpp_type->destruct_n(dst_buffer, domain_size);
+      read_attribute->get_range(IndexRange(domain_size), dst_buffer);
+    }
+  });
 }
 
 static void join_attributes(Span<const GeometryComponent *> src_components,
@@ -18,7 +18,9 @@
 
 #include "DNA_pointcloud_types.h"
 
+#include "BKE_customdata.h"
 #include "BKE_mesh.h"
+#include "BKE_pointcloud.h"
 
 #include "node_geometry_util.hh"
 
@@ -71,6 +73,11 @@ static void transform_pointcloud(PointCloud *pointcloud,
                                  const float3 rotation,
                                  const float3 scale)
 {
+  /* The positions might be shared with another point cloud. */
+  CustomData_duplicate_referenced_layer_named(
+      &pointcloud->pdata, CD_PROP_FLOAT3, POINTCLOUD_ATTR_POSITION, pointcloud->totpoint);
+  BKE_pointcloud_update_customdata_pointers(pointcloud);
+
   /* Use only translation if rotation and scale don't apply. */
   if (use_translate(rotation, scale)) {
     for (int i = 0; i < pointcloud->totpoint; i++) {
@@ -14,20 +14,30 @@
  * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
  */
 
+#include <algorithm>
+
+#include "BLI_array.hh"
+#include "BLI_heap.h"
+#include "BLI_math_geom.h"
+#include "BLI_math_matrix.h"
+#include "BLI_math_vector.h"
+#include "BLI_memarena.h"
+#include "BLI_polyfill_2d.h"
+#include "BLI_polyfill_2d_beautify.h"
+#include "BLI_task.hh"
+#include "BLI_vector.hh"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
 #include "DNA_node_types.h"
 
+#include "BKE_customdata.h"
+#include "BKE_mesh.h"
+
 #include "RNA_enum_types.h"
 
 #include "node_geometry_util.hh"
 
-extern "C" {
-Mesh *triangulate_mesh(Mesh *mesh,
-                       const int quad_method,
-                       const int ngon_method,
-                       const int min_vertices,
-                       const int flag);
-}
-
 static bNodeSocketTemplate geo_node_triangulate_in[] = {
     {SOCK_GEOMETRY, N_("Geometry")},
     {SOCK_INT, N_("Minimum Vertices"), 4, 0, 0, 0, 4, 10000},
@@ -46,6 +56,314 @@ static void geo_triangulate_init(bNodeTree *UNUSED(ntree), bNode *node)
 }
 
 namespace blender::nodes {
+
+/* -------------------------------------------------------------------- */
+/** \name Mesh Triangulation
+ *
+ * Triangulates #Mesh data directly instead of going through BMesh. Faces are split the same way
+ * as #BM_face_triangulate does, so the result matches the Triangulate modifier.
+ * \{ */
+
+/**
+ * Same as the area based check of #BM_verts_calc_rotate_beauty: assuming two triangles sharing
+ * the (2 - 4) edge, a negative result means the (1 - 3) edge gives better triangles.
+ */
+static float quad_calc_rotate_beauty(const float v1[3],
+                                     const float v2[3],
+                                     const float v3[3],
+                                     const float v4[3])
+{
+  const float eps = 1e-5f;
+  float no_a[3], no_b[3], no[3];
+  cross_tri_v3(no_a, v2, v3, v4);
+  cross_tri_v3(no_b, v2, v4, v1);
+  add_v3_v3v3(no, no_a, no_b);
+  const float no_scale = normalize_v3(no);
+  if (UNLIKELY(no_scale == 0.0f)) {
+    return FLT_MAX;
+  }
+
+  float axis_mat[3][3];
+  float v1_xy[2], v2_xy[2], v3_xy[2], v4_xy[2];
+  axis_dominant_v3_to_m3(axis_mat, no);
+  mul_v2_m3v3(v1_xy, axis_mat, v1);
+  mul_v2_m3v3(v2_xy, axis_mat, v2);
+  mul_v2_m3v3(v3_xy, axis_mat, v3);
+  mul_v2_m3v3(v4_xy, axis_mat, v4);
+
+  /* Skip quads which are already flipped or fully degenerate. */
+  if (!(signum_i_ex(cross_tri_v2(v2_xy, v3_xy, v4_xy) / no_scale, eps) +
+        signum_i_ex(cross_tri_v2(v2_xy, v4_xy, v1_xy) / no_scale, eps))) {
+    return FLT_MAX;
+  }
+  return BLI_polyfill_beautify_quad_rotate_calc_ex(v1_xy, v2_xy, v3_xy, v4_xy, false, nullptr);
+}
+
+/**
+ * Return the corner the diagonal of a quad starts at: 0 to split along (0 - 2),
+ * 1 to split along (1 - 3).
+ */
+static int quad_split_corner(const MVert *mvert,
+                             const MLoop *mloop,
+                             const GeometryNodeTriangulateQuads quad_method)
+{
+  switch (quad_method) {
+    case GEO_NODE_TRIANGULATE_QUAD_FIXED:
+      return 0;
+    case GEO_NODE_TRIANGULATE_QUAD_ALTERNATE:
+      return 1;
+    case GEO_NODE_TRIANGULATE_QUAD_SHORTEDGE:
+    case GEO_NODE_TRIANGULATE_QUAD_BEAUTY:
+    default:
+      break;
+  }
+
+  /* Same naming as #BM_face_triangulate, `v4` is the first corner. */
+  const float *co_1 = mvert[mloop[1].v].co;
+  const float *co_2 = mvert[mloop[2].v].co;
+  const float *co_3 = mvert[mloop[3].v].co;
+  const float *co_4 = mvert[mloop[0].v].co;
+
+  bool split_24;
+  if (quad_method == GEO_NODE_TRIANGULATE_QUAD_SHORTEDGE) {
+    split_24 = (len_squared_v3v3(co_1, co_3) - len_squared_v3v3(co_4, co_2)) > 0.0f;
+  }
+  else {
+    /* First check if the quad is concave on either diagonal. */
+    const int flip_flag = is_quad_flip_v3(co_1, co_2, co_3, co_4);
+    if (UNLIKELY(flip_flag & (1 << 0))) {
+      split_24 = true;
+    }
+    else if (UNLIKELY(flip_flag & (1 << 1))) {
+      split_24 = false;
+    }
+    else {
+      split_24 = (mloop[1].v == mloop[3].v) ||
+                 (quad_calc_rotate_beauty(co_1, co_2, co_3, co_4) > 0.0f);
+    }
+  }
+  return split_24 ? 0 : 1;
+}
+
+static bool poly_needs_triangulate(const MPoly &mpoly, const int min_vertices)
+{
+  return mpoly.totloop > 3 && mpoly.totloop >= min_vertices;
+}
+
+/**
+ * Per face state of #mesh_triangulate, reused between the faces of a task.
+ */
+struct TriangulateTLS {
+  MemArena *arena = nullptr;
+  Heap *heap = nullptr;
+  Vector<uint> tris;
+  Vector<float> projverts;
+  Vector<int> diagonals;
+
+  ~TriangulateTLS()
+  {
+    if (arena != nullptr) {
+      BLI_memarena_free(arena);
+    }
+    if (heap != nullptr) {
+      BLI_heap_free(heap, nullptr);
+    }
+  }
+};
+
+/**
+ * Fill `tls.tris` with the triangles of a face as indices of its corners.
+ */
+static void poly_calc_tris(const Mesh &mesh,
+                           const MPoly &mpoly,
+                           const GeometryNodeTriangulateQuads quad_method,
+                           const GeometryNodeTriangulateNGons ngon_method,
+                           TriangulateTLS &tls)
+{
+  const int len = mpoly.totloop;
+  const MLoop *mloop = &mesh.mloop[mpoly.loopstart];
+  tls.tris.resize(3 * (len - 2));
+  uint(*tris)[3] = reinterpret_cast<uint(*)[3]>(tls.tris.data());
+
+  if (len == 4) {
+    const uint first = uint(quad_split_corner(mesh.mvert, mloop, quad_method));
+    ARRAY_SET_ITEMS(tris[0], first, (first + 1) % 4, (first + 2) % 4);
+    ARRAY_SET_ITEMS(tris[1], first, (first + 2) % 4, (first + 3) % 4);
+    return;
+  }
+
+  float no[3];
+  float axis_mat[3][3];
+  BKE_mesh_calc_poly_normal(&mpoly, mloop, mesh.mvert, no);
+  axis_dominant_v3_to_m3_negate(axis_mat, no);
+
+  tls.projverts.resize(2 * len);
+  float(*projverts)[2] = reinterpret_cast<float(*)[2]>(tls.projverts.data());
+  for (const int i : IndexRange(len)) {
+    mul_v2_m3v3(projverts[i], axis_mat, mesh.mvert[mloop[i].v].co);
+  }
+
+  if (tls.arena == nullptr) {
+    tls.arena = BLI_memarena_new(BLI_POLYFILL_ARENA_SIZE, __func__);
+  }
+  BLI_polyfill_calc_arena(projverts, uint(len), 1, tris, tls.arena);
+  if (ngon_method == GEO_NODE_TRIANGULATE_NGON_BEAUTY) {
+    if (tls.heap == nullptr) {
+      tls.heap = BLI_heap_new_ex(BLI_POLYFILL_ALLOC_NGON_RESERVE);
+    }
+    BLI_polyfill_beautify(projverts, uint(len), tris, tls.arena, tls.heap);
+  }
+  BLI_memarena_clear(tls.arena);
+}
+
+/**
+ * Triangulate all faces with at least \a min_vertices corners. The new edges are added after
+ * the existing ones, every other element keeps its attributes. Returns null when no face has to
+ * be triangulated.
+ */
+Mesh *mesh_triangulate(const Mesh &mesh,
+                       const GeometryNodeTriangulateQuads quad_method,
+                       const GeometryNodeTriangulateNGons ngon_method,
+                       const int min_vertices)
+{
+  const Span<MPoly> polys{mesh.mpoly, mesh.totpoly};
+
+  /* Offsets of the first result face, corner and new edge of every face. */
+  Array<int> poly_offsets(polys.size() + 1);
+  Array<int> loop_offsets(polys.size() + 1);
+  Array<int> edge_offsets(polys.size() + 1);
+  poly_offsets[0] = loop_offsets[0] = edge_offsets[0] = 0;
+  for (const int i : polys.index_range()) {
+    const int len = polys[i].totloop;
+    const bool triangulate = poly_needs_triangulate(polys[i], min_vertices);
+    poly_offsets[i + 1] = poly_offsets[i] + (triangulate ? len - 2 : 1);
+    loop_offsets[i + 1] = loop_offsets[i] + (triangulate ? 3 * (len - 2) : len);
+    edge_offsets[i + 1] = edge_offsets[i] + (triangulate ? len - 3 : 0);
+  }
+
+  if (edge_offsets.last() == 0) {
+    return nullptr;
+  }
+
+  Mesh *result = BKE_mesh_new_nomain_from_template(&mesh,
+                                                   mesh.totvert,
+                                                   mesh.totedge + edge_offsets.last(),
+                                                   0,
+                                                   loop_offsets.last(),
+                                                   poly_offsets.last());
+
+  CustomData_copy_data(&mesh.vdata, &result->vdata, 0, 0, mesh.totvert);
+  CustomData_copy_data(&mesh.edata, &result->edata, 0, 0, mesh.totedge);
+
+  /* Source face and corner of every result element, and the edge of every result corner. */
+  Array<int> poly_src(result->totpoly);
+  Array<int> loop_src(result->totloop);
+  Array<int> loop_edges(result->totloop);
+
+  parallel_for(polys.index_range(), 256, [&](IndexRange range) {
+    TriangulateTLS tls;
+    for (const int i : range) {
+      const MPoly &mpoly = polys[i];
+      const MLoop *mloop = &mesh.mloop[mpoly.loopstart];
+      const int len = mpoly.totloop;
+      const int loop_offset = loop_offsets[i];
+
+      if (!poly_needs_triangulate(mpoly, min_vertices)) {
+        poly_src[poly_offsets[i]] = i;
+        for (const int corner : IndexRange(len)) {
+          loop_src[loop_offset + corner] = mpoly.loopstart + corner;
+          loop_edges[loop_offset + corner] = mloop[corner].e;
+        }
+        continue;
+      }
+
+      poly_calc_tris(mesh, mpoly, quad_method, ngon_method, tls);
+      const int tris_num = len - 2;
+      const uint(*tris)[3] = reinterpret_cast<const uint(*)[3]>(tls.tris.data());
+
+      /* Every diagonal is shared by two triangles, give each one a single new edge. */
+      tls.diagonals.clear();
+      for (const int tri : IndexRange(tris_num)) {
+        for (const int side : IndexRange(3)) {
+          const int a = int(tris[tri][side]);
+          const int b = int(tris[tri][(side + 1) % 3]);
+          if (!ELEM(b, (a + 1) % len, (a + len - 1) % len)) {
+            tls.diagonals.append(std::min(a, b) * len + std::max(a, b));
+          }
+        }
+      }
+      std::sort(tls.diagonals.begin(), tls.diagonals.end());
+      tls.diagonals.resize(std::unique(tls.diagonals.begin(), tls.diagonals.end()) -
+                           tls.diagonals.begin());
+      BLI_assert(tls.diagonals.size() == len - 3);
+
+      const int edge_offset = mesh.totedge + edge_offsets[i];
+      for (const int diagonal : tls.diagonals.index_range()) {
+        MEdge &medge = result->medge[edge_offset + diagonal];
+        medge.v1 = mloop[tls.diagonals[diagonal] / len].v;
+        medge.v2 = mloop[tls.diagonals[diagonal] % len].v;
+        medge.flag = ME_EDGEDRAW | ME_EDGERENDER;
+      }
+
+      for (const int tri : IndexRange(tris_num)) {
+        poly_src[poly_offsets[i] + tri] = i;
+        for (const int side : IndexRange(3)) {
+          const int a = int(tris[tri][side]);
+          const int b = int(tris[tri][(side + 1) % 3]);
+          const int result_loop = loop_offset + 3 * tri + side;
+          loop_src[result_loop] = mpoly.loopstart + a;
+          if (b == (a + 1) % len) {
+            loop_edges[result_loop] = mloop[a].e;
+          }
+          else if (a == (b + 1) % len) {
+            loop_edges[result_loop] = mloop[b].e;
+          }
+          else {
+            const int key = std::min(a, b) * len + std::max(a, b);
+            const int *diagonal = std::lower_bound(
+                tls.diagonals.begin(), tls.diagonals.end(), key);
+            loop_edges[result_loop] = edge_offset + int(diagonal - tls.diagonals.begin());
+          }
+        }
+      }
+    }
+  });
+
+  parallel_for(IndexRange(result->totloop), 4096, [&](IndexRange range) {
+    CustomData_copy_data_indices(
+        &mesh.ldata, &result->ldata, &loop_src[range.start()], range.start(), range.size());
+    for (const int i : range) {
+      result->mloop[i].e = loop_edges[i];
+    }
+  });
+
+  parallel_for(IndexRange(result->totpoly), 4096, [&](IndexRange range) {
+    CustomData_copy_data_indices(
+        &mesh.pdata, &result->pdata, &poly_src[range.start()], range.start(), range.size());
+    for (const int i : range) {
+      const int src = poly_src[i];
+      MPoly &mpoly = result->mpoly[i];
+      if (poly_needs_triangulate(polys[src], min_vertices)) {
+        mpoly.loopstart = loop_offsets[src] + 3 * (i - poly_offsets[src]);
+        mpoly.totloop = 3;
+      }
+      else {
+        mpoly.loopstart = loop_offsets[src];
+      }
+    }
+  });
+
+  /* Force drawing of all edges, like the Triangulate modifier. */
+  for (MEdge &medge : MutableSpan<MEdge>(result->medge, mesh.totedge)) {
+    medge.flag |= ME_EDGEDRAW | ME_EDGERENDER;
+  }
+
+  result->runtime.cd_dirty_vert |= CD_MASK_NORMAL;
+  return result;
+}
+
+/** \} */
+
 static void geo_node_triangulate_exec(GeoNodeExecParams params)
 {
   GeometrySet geometry_set = params.extract_input<GeometrySet>("Geometry");
@@ -56,11 +374,12 @@ static void geo_node_triangulate_exec(GeoNodeExecParams params)
   GeometryNodeTriangulateNGons ngon_method = static_cast<GeometryNodeTriangulateNGons>(
       params.node().custom2);
 
-  /* #triangulate_mesh might modify the input mesh currently. */
-  Mesh *mesh_in = geometry_set.get_mesh_for_write();
+  const Mesh *mesh_in = geometry_set.get_mesh_for_read();
   if (mesh_in != nullptr) {
-    Mesh *mesh_out = triangulate_mesh(mesh_in, quad_method, ngon_method, min_vertices, 0);
-    geometry_set.replace_mesh(mesh_out);
+    Mesh *mesh_out = mesh_triangulate(*mesh_in, quad_method, ngon_method, min_vertices);
+    if (mesh_out != nullptr) {
+      geometry_set.replace_mesh(mesh_out);
+    }
   }
 
   params.set_output("Geometry", std::move(geometry_set));
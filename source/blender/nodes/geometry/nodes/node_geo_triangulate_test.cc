@@ -0,0 +1,208 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 by Blender Foundation.
+ */
+#include "testing/testing.h"
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "BLI_map.hh"
+#include "BLI_math_vector.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_modifier_types.h"
+
+#include "BKE_lib_id.h"
+#include "BKE_mesh.h"
+
+#include "node_geometry_util.hh"
+
+extern "C" {
+Mesh *triangulate_mesh(Mesh *mesh,
+                       const int quad_method,
+                       const int ngon_method,
+                       const int min_vertices,
+                       const int flag);
+}
+
+namespace blender::nodes::tests {
+
+/* Create a mesh from vertex positions and the vertex indices of the faces. */
+static Mesh *mesh_from_faces(Span<std::array<float, 3>> positions, Span<Vector<int>> faces)
+{
+  Map<std::pair<int, int>, int> edge_map;
+  Vector<std::pair<int, int>> edges;
+  auto edge_index = [&](const int v1, const int v2) {
+    const std::pair<int, int> key(std::min(v1, v2), std::max(v1, v2));
+    return edge_map.lookup_or_add_cb(key, [&]() {
+      edges.append(key);
+      return int(edges.size() - 1);
+    });
+  };
+  int totloop = 0;
+  for (const Vector<int> &face : faces) {
+    for (const int i : face.index_range()) {
+      edge_index(face[i], face[(i + 1) % face.size()]);
+    }
+    totloop += face.size();
+  }
+
+  Mesh *mesh = BKE_mesh_new_nomain(positions.size(), edges.size(), 0, totloop, faces.size());
+  for (const int i : positions.index_range()) {
+    copy_v3_v3(mesh->mvert[i].co, positions[i].data());
+  }
+  for (const int i : edges.index_range()) {
+    mesh->medge[i].v1 = edges[i].first;
+    mesh->medge[i].v2 = edges[i].second;
+  }
+  int loop = 0;
+  for (const int i : faces.index_range()) {
+    const Vector<int> &face = faces[i];
+    mesh->mpoly[i].loopstart = loop;
+    mesh->mpoly[i].totloop = face.size();
+    for (const int j : face.index_range()) {
+      mesh->mloop[loop].v = face[j];
+      mesh->mloop[loop].e = edge_index(face[j], face[(j + 1) % face.size()]);
+      loop++;
+    }
+  }
+  return mesh;
+}
+
+/**
+ * The vertices of every face, rotated to start at the smallest index so that the winding is kept,
+ * in sorted order. Vertices are not renumbered by triangulation, faces are ordered differently.
+ */
+static std::vector<std::vector<int>> mesh_sorted_faces(const Mesh &mesh)
+{
+  std::vector<std::vector<int>> faces;
+  for (const int i : IndexRange(mesh.totpoly)) {
+    const MPoly &mpoly = mesh.mpoly[i];
+    std::vector<int> face;
+    for (const int j : IndexRange(mpoly.totloop)) {
+      face.push_back(mesh.mloop[mpoly.loopstart + j].v);
+    }
+    std::rotate(face.begin(), std::min_element(face.begin(), face.end()), face.end());
+    faces.push_back(std::move(face));
+  }
+  std::sort(faces.begin(), faces.end());
+  return faces;
+}
+
+static void expect_same_as_modifier(Mesh *mesh,
+                                    const GeometryNodeTriangulateQuads quad_method,
+                                    const GeometryNodeTriangulateNGons ngon_method,
+                                    const int min_vertices)
+{
+  /* The node and modifier enums have the same values. */
+  Mesh *expected = triangulate_mesh(mesh, quad_method, ngon_method, min_vertices, 0);
+  Mesh *result = mesh_triangulate(*mesh, quad_method, ngon_method, min_vertices);
+  const Mesh *actual = (result == nullptr) ? mesh : result;
+
+  EXPECT_EQ(actual->totvert, expected->totvert);
+  EXPECT_EQ(actual->totedge, expected->totedge);
+  EXPECT_EQ(actual->totloop, expected->totloop);
+  EXPECT_EQ(actual->totpoly, expected->totpoly);
+  EXPECT_EQ(mesh_sorted_faces(*actual), mesh_sorted_faces(*expected));
+
+  BKE_id_free(nullptr, expected);
+  if (result != nullptr) {
+    BKE_id_free(nullptr, result);
+  }
+}
+
+/**
+ * Quads with different diagonal lengths and a non-planar and a concave one, so that the quad
+ * methods split them differently. A hexagon and a thin concave ngon for the ngon methods.
+ */
+static Mesh *triangulate_test_mesh()
+{
+  const Vector<std::array<float, 3>> positions = {
+      /* Quads. */
+      {0.0f, 0.0f, 0.0f},
+      {2.0f, 0.0f, 0.0f},
+      {3.0f, 1.0f, 0.0f},
+      {0.0f, 1.0f, 0.0f},
+      {3.5f, 0.0f, 0.6f},
+      {4.0f, 1.5f, -0.4f},
+      {5.0f, 0.0f, 0.0f},
+      {6.0f, 0.0f, 0.0f},
+      {5.4f, 0.4f, 0.0f},
+      {5.0f, 2.0f, 0.0f},
+      /* Hexagon. */
+      {0.0f, 3.0f, 0.0f},
+      {1.0f, 2.5f, 0.1f},
+      {2.0f, 3.0f, 0.0f},
+      {2.2f, 4.0f, -0.1f},
+      {1.0f, 4.5f, 0.0f},
+      {-0.3f, 4.0f, 0.05f},
+      /* Concave ngon. */
+      {3.0f, 3.0f, 0.0f},
+      {6.0f, 3.0f, 0.0f},
+      {6.0f, 5.0f, 0.0f},
+      {5.5f, 3.4f, 0.0f},
+      {4.5f, 3.3f, 0.0f},
+      {3.5f, 3.4f, 0.0f},
+      {3.0f, 5.0f, 0.0f},
+  };
+  const Vector<Vector<int>> faces = {
+      {0, 1, 2, 3},
+      {1, 4, 5, 2},
+      {6, 7, 8, 9},
+      {10, 11, 12, 13, 14, 15},
+      {16, 17, 18, 19, 20, 21, 22},
+  };
+  return mesh_from_faces(positions, faces);
+}
+
+TEST(triangulate, quad_methods)
+{
+  Mesh *mesh = triangulate_test_mesh();
+  for (const GeometryNodeTriangulateQuads quad_method : {GEO_NODE_TRIANGULATE_QUAD_BEAUTY,
+                                                         GEO_NODE_TRIANGULATE_QUAD_FIXED,
+                                                         GEO_NODE_TRIANGULATE_QUAD_ALTERNATE,
+                                                         GEO_NODE_TRIANGULATE_QUAD_SHORTEDGE}) {
+    expect_same_as_modifier(mesh, quad_method, GEO_NODE_TRIANGULATE_NGON_BEAUTY, 4);
+  }
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST(triangulate, ngon_methods)
+{
+  Mesh *mesh = triangulate_test_mesh();
+  expect_same_as_modifier(
+      mesh, GEO_NODE_TRIANGULATE_QUAD_BEAUTY, GEO_NODE_TRIANGULATE_NGON_BEAUTY, 4);
+  expect_same_as_modifier(
+      mesh, GEO_NODE_TRIANGULATE_QUAD_BEAUTY, GEO_NODE_TRIANGULATE_NGON_EARCLIP, 4);
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST(triangulate, min_vertices)
+{
+  Mesh *mesh = triangulate_test_mesh();
+  expect_same_as_modifier(
+      mesh, GEO_NODE_TRIANGULATE_QUAD_BEAUTY, GEO_NODE_TRIANGULATE_NGON_BEAUTY, 7);
+  /* No face has enough vertices, the mesh is passed through. */
+  EXPECT_EQ(mesh_triangulate(
+                *mesh, GEO_NODE_TRIANGULATE_QUAD_BEAUTY, GEO_NODE_TRIANGULATE_NGON_BEAUTY, 8),
+            nullptr);
+  BKE_id_free(nullptr, mesh);
+}
+
+}  // namespace blender::nodes::tests
@@ -155,6 +155,12 @@ typedef struct RenderResult {
   char *error;
 
   struct StampData *stamp_data;
+
+  /* Open handle of a lazily loaded multilayer file, passes without pixels are read from it on
+   * first access, see #RE_RenderPassEnsureLoaded. */
+  void *exrhandle;
+  char exr_colorspace[64]; /* MAX_COLORSPACE_NAME */
+  bool exr_predivide;
 } RenderResult;
 
 typedef struct RenderStats {
@@ -320,6 +326,8 @@ bool RE_WriteRenderResult(struct ReportList *reports,
                           int layer);
 struct RenderResult *RE_MultilayerConvert(
     void *exrhandle, const char *colorspace, bool predivide, int rectx, int recty);
+bool RE_RenderPassEnsureLoaded(RenderResult *rr, RenderPass *rpass);
+void RE_RenderResultEnsureLoaded(RenderResult *rr);
 
 /* display and event callbacks */
 void RE_display_init_cb(struct Render *re,
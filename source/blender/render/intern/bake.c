@@ -1014,6 +1014,7 @@ void RE_bake_ibuf_clear(Image *image, const bool is_tangent)
 
   ibuf = BKE_image_acquire_ibuf(image, NULL, &lock);
   BLI_assert(ibuf);
+  ibuf = BKE_image_ibuf_ensure_writable(image, ibuf);
 
   if (is_tangent) {
     IMB_rectfill(ibuf, (ibuf->planes == R_IMF_PLANES_RGBA) ? nor_alpha : nor_solid);
@@ -1405,6 +1405,9 @@ static void bake_images(MultiresBakeRender *bkr, MultiresBakeResult *result)
     Image *ima = (Image *)link->data;
     ImBuf *ibuf = BKE_image_acquire_ibuf(ima, NULL, NULL);
 
+    /* Later acquires of this image return the private copy. */
+    ibuf = BKE_image_ibuf_ensure_writable(ima, ibuf);
+
     if (ibuf->x > 0 && ibuf->y > 0) {
       BakeImBufuserData *userdata = MEM_callocN(sizeof(BakeImBufuserData),
                                                 "MultiresBake userdata");
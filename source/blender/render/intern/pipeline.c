@@ -1510,18 +1510,29 @@ static void do_render_seq(Render *re)
   /* the renderresult gets destroyed during the rendering, so we first collect all ibufs
    * and then we populate the final renderesult */
 
-  for (view_id = 0; view_id < tot_views; view_id++) {
-    context.view_id = view_id;
-    out = SEQ_render_give_ibuf(&context, cfra, 0);
-
-    if (out) {
-      ibuf_arr[view_id] = IMB_dupImBuf(out);
-      IMB_metadata_copy(ibuf_arr[view_id], out);
-      IMB_freeImBuf(out);
-      SEQ_render_imbuf_from_sequencer_space(re->pipeline_scene_eval, ibuf_arr[view_id]);
+  if (recurs_depth == 1 && re->seq_render_pool &&
+      SEQ_render_pool_acquire(re->seq_render_pool, cfra, ibuf_arr)) {
+    /* Frame was rendered ahead by the render pool. */
+    for (view_id = 0; view_id < tot_views; view_id++) {
+      if (ibuf_arr[view_id]) {
+        SEQ_render_imbuf_from_sequencer_space(re->pipeline_scene_eval, ibuf_arr[view_id]);
+      }
     }
-    else {
-      ibuf_arr[view_id] = NULL;
+  }
+  else {
+    for (view_id = 0; view_id < tot_views; view_id++) {
+      context.view_id = view_id;
+      out = SEQ_render_give_ibuf(&context, cfra, 0);
+
+      if (out) {
+        ibuf_arr[view_id] = IMB_dupImBuf(out);
+        IMB_metadata_copy(ibuf_arr[view_id], out);
+        IMB_freeImBuf(out);
+        SEQ_render_imbuf_from_sequencer_space(re->pipeline_scene_eval, ibuf_arr[view_id]);
+      }
+      else {
+        ibuf_arr[view_id] = NULL;
+      }
     }
   }
 
@@ -2385,6 +2396,21 @@ static void get_videos_dimensions(const Render *re,
   BKE_scene_multiview_videos_dimensions_get(rd, width, height, r_width, r_height);
 }
 
+static bool render_use_seq_render_pool(Render *re, Scene *scene)
+{
+  RenderEngineType *type = RE_engines_find(re->r.engine);
+
+  /* Engine renders everything on its own. */
+  if (type->render && (type->flag & RE_USE_POSTPROCESS)) {
+    return false;
+  }
+  /* Frames would be rendered ahead only to be skipped. */
+  if (re->r.mode & R_NO_OVERWRITE) {
+    return false;
+  }
+  return RE_seq_render_active(scene, &re->r) && SEQ_render_pool_is_supported(scene);
+}
+
 static void re_movie_free_all(Render *re, bMovieHandle *mh, int totvideos)
 {
   int i;
@@ -2474,6 +2500,19 @@ void RE_RenderAnim(Render *re,
 
   re->flag |= R_ANIMATION;
 
+  if (render_use_seq_render_pool(re, scene)) {
+    int re_x, re_y;
+    if ((re->r.mode & R_BORDER) && (re->r.mode & R_CROP) == 0) {
+      re_x = re->winx;
+      re_y = re->winy;
+    }
+    else {
+      re_x = re->rectx;
+      re_y = re->recty;
+    }
+    re->seq_render_pool = SEQ_render_pool_create(re->main, scene, re_x, re_y, sfra, efra, tfra);
+  }
+
   {
     for (nfra = sfra, scene->r.cfra = sfra; scene->r.cfra <= efra; scene->r.cfra++) {
       char name[FILE_MAX];
@@ -2642,6 +2681,11 @@ void RE_RenderAnim(Render *re,
     }
   }
 
+  if (re->seq_render_pool) {
+    SEQ_render_pool_free(re->seq_render_pool);
+    re->seq_render_pool = NULL;
+  }
+
   /* end movie */
   if (is_movie) {
     re_movie_free_all(re, mh, totvideos);
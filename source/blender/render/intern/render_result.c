@@ -123,6 +123,10 @@ void render_result_free(RenderResult *rr)
 
   BKE_stamp_data_free(rr->stamp_data);
 
+  if (rr->exrhandle) {
+    IMB_exr_close(rr->exrhandle);
+  }
+
   MEM_freeN(rr);
 }
 
@@ -755,6 +759,14 @@ RenderResult *render_result_new_from_exr(
 
   IMB_exr_multilayer_convert(exrhandle, rr, ml_addview_cb, ml_addlayer_cb, ml_addpass_cb);
 
+  /* Passes of lazily read files are loaded and converted on first access, the result takes
+   * over the handle for that. */
+  if (IMB_exr_is_lazy(exrhandle)) {
+    rr->exrhandle = exrhandle;
+    BLI_strncpy(rr->exr_colorspace, colorspace, sizeof(rr->exr_colorspace));
+    rr->exr_predivide = predivide;
+  }
+
   for (rl = rr->layers.first; rl; rl = rl->next) {
     rl->rectx = rectx;
     rl->recty = recty;
@@ -765,7 +777,7 @@ RenderResult *render_result_new_from_exr(
       rpass->rectx = rectx;
       rpass->recty = recty;
 
-      if (rpass->channels >= 3) {
+      if (rpass->rect && rpass->channels >= 3) {
         IMB_colormanagement_transform(rpass->rect,
                                       rpass->rectx,
                                       rpass->recty,
@@ -780,6 +792,63 @@ RenderResult *render_result_new_from_exr(
   return rr;
 }
 
+/**
+ * Read the pixels of a pass from a lazily loaded multilayer file, when not done yet.
+ * Returns false when the pass has no pixels.
+ */
+bool RE_RenderPassEnsureLoaded(RenderResult *rr, RenderPass *rpass)
+{
+  if (rpass->rect) {
+    return true;
+  }
+  if (rr->exrhandle == NULL) {
+    return false;
+  }
+
+  RenderLayer *rl;
+  for (rl = rr->layers.first; rl; rl = rl->next) {
+    if (BLI_findindex(&rl->passes, rpass) != -1) {
+      break;
+    }
+  }
+  if (rl == NULL) {
+    return false;
+  }
+
+  float *rect = IMB_exr_read_pass(rr->exrhandle, rl->name, rpass->name, rpass->view);
+  if (rect == NULL) {
+    return false;
+  }
+
+  if (rpass->channels >= 3) {
+    IMB_colormanagement_transform(
+        rect,
+        rpass->rectx,
+        rpass->recty,
+        rpass->channels,
+        rr->exr_colorspace,
+        IMB_colormanagement_role_colorspace_name_get(COLOR_ROLE_SCENE_LINEAR),
+        rr->exr_predivide);
+  }
+  rpass->rect = rect;
+
+  return true;
+}
+
+/* Read all passes which are not loaded yet, for code which accesses the passes directly. */
+void RE_RenderResultEnsureLoaded(RenderResult *rr)
+{
+  if (rr->exrhandle == NULL) {
+    return;
+  }
+
+  LISTBASE_FOREACH (RenderLayer *, rl, &rr->layers) {
+    LISTBASE_FOREACH (RenderPass *, rpass, &rl->passes) {
+      RE_RenderPassEnsureLoaded(rr, rpass);
+    }
+  }
+}
+
 void render_result_view_new(RenderResult *rr, const char *viewname)
 {
   RenderView *rv = MEM_callocN(sizeof(RenderView), "new render view");
@@ -904,6 +973,9 @@ bool RE_WriteRenderResult(ReportList *reports,
     layer = 0;
   }
 
+  /* Results of lazily loaded files may not have all passes read yet. */
+  RE_RenderResultEnsureLoaded(rr);
+
   /* First add views since IMB_exr_add_channel checks number of views. */
   if (render_result_has_views(rr)) {
     LISTBASE_FOREACH (RenderView *, rview, &rr->views) {
@@ -1668,9 +1740,13 @@ static RenderView *duplicate_render_view(RenderView *rview)
 
 RenderResult *RE_DuplicateRenderResult(RenderResult *rr)
 {
+  /* The file handle is not shared, the copy gets all passes. */
+  RE_RenderResultEnsureLoaded(rr);
+
   RenderResult *new_rr = MEM_mallocN(sizeof(RenderResult), "new duplicated render result");
   *new_rr = *rr;
   new_rr->next = new_rr->prev = NULL;
+  new_rr->exrhandle = NULL;
   new_rr->layers.first = new_rr->layers.last = NULL;
   new_rr->views.first = new_rr->views.last = NULL;
   for (RenderLayer *rl = rr->layers.first; rl != NULL; rl = rl->next) {
@@ -151,6 +151,8 @@ struct Render {
   struct ReportList *reports;
 
   void **movie_ctx_arr;
+  /* Renders sequencer frames ahead in parallel during animation render, can be NULL. */
+  struct SeqRenderPool *seq_render_pool;
   char viewname[MAX_NAME];
 
   /* TODO replace by a whole draw manager. */
@@ -120,6 +120,7 @@ void BKE_sequence_iterator_end(SeqIterator *iter);
 
 typedef enum eSeqTaskId {
   SEQ_TASK_MAIN_RENDER,
+  /* Prefetch workers use consecutive IDs starting with this one. */
   SEQ_TASK_PREFETCH_RENDER,
 } eSeqTaskId;
 
@@ -136,6 +137,8 @@ typedef struct SeqRenderData {
   bool skip_cache;
   bool is_proxy_render;
   bool is_prefetch_render;
+  /* Scene is an evaluated copy owned by the rendering thread, global render lock is not needed. */
+  bool is_isolated_render;
   int view_id;
   /* ID of task for asigning temp cache entries to particular task(thread, etc.) */
   eSeqTaskId task_id;
@@ -173,6 +176,27 @@ struct StripElem *SEQ_render_give_stripelem(struct Sequence *seq, int timeline_f
 void SEQ_render_imbuf_from_sequencer_space(struct Scene *scene, struct ImBuf *ibuf);
 void SEQ_render_pixel_from_sequencer_space_v4(struct Scene *scene, float pixel[4]);
 
+/* **********************************************************************
+ * render_pool.c
+ *
+ * Parallel rendering of consecutive frames for final renders
+ * ********************************************************************** */
+
+struct SeqRenderPool;
+
+bool SEQ_render_pool_is_supported(struct Scene *scene);
+struct SeqRenderPool *SEQ_render_pool_create(struct Main *bmain,
+                                             struct Scene *scene,
+                                             int rectx,
+                                             int recty,
+                                             int sfra,
+                                             int efra,
+                                             int frame_step);
+bool SEQ_render_pool_acquire(struct SeqRenderPool *pool,
+                             int timeline_frame,
+                             struct ImBuf **r_ibuf_arr);
+void SEQ_render_pool_free(struct SeqRenderPool *pool);
+
 /* **********************************************************************
  * sequencer.c
  *
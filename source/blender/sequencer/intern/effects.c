@@ -63,6 +63,7 @@
 #include "BLF_api.h"
 
 #include "effects.h"
+#include "effects_kernels.h"
 #include "render.h"
 #include "strip_time.h"
 #include "utils.h"
@@ -208,149 +209,24 @@ static void do_alphaover_effect_byte(float facf0,
                                      unsigned char *rect2,
                                      unsigned char *out)
 {
-  float fac2, mfac, fac, fac4;
-  int xo;
-  unsigned char *cp1, *cp2, *rt;
-  float tempc[4], rt1[4], rt2[4];
-
-  xo = x;
-  cp1 = rect1;
-  cp2 = rect2;
-  rt = out;
-
-  fac2 = facf0;
-  fac4 = facf1;
-
-  while (y--) {
-    x = xo;
-    while (x--) {
-      /* rt = rt1 over rt2  (alpha from rt1) */
-
-      straight_uchar_to_premul_float(rt1, cp1);
-      straight_uchar_to_premul_float(rt2, cp2);
-
-      fac = fac2;
-      mfac = 1.0f - fac2 * rt1[3];
-
-      if (fac <= 0.0f) {
-        *((unsigned int *)rt) = *((unsigned int *)cp2);
-      }
-      else if (mfac <= 0.0f) {
-        *((unsigned int *)rt) = *((unsigned int *)cp1);
-      }
-      else {
-        tempc[0] = fac * rt1[0] + mfac * rt2[0];
-        tempc[1] = fac * rt1[1] + mfac * rt2[1];
-        tempc[2] = fac * rt1[2] + mfac * rt2[2];
-        tempc[3] = fac * rt1[3] + mfac * rt2[3];
-
-        premul_float_to_straight_uchar(rt, tempc);
-      }
-      cp1 += 4;
-      cp2 += 4;
-      rt += 4;
-    }
-
-    if (y == 0) {
-      break;
-    }
-    y--;
-
-    x = xo;
-    while (x--) {
-      straight_uchar_to_premul_float(rt1, cp1);
-      straight_uchar_to_premul_float(rt2, cp2);
-
-      fac = fac4;
-      mfac = 1.0f - (fac4 * rt1[3]);
-
-      if (fac <= 0.0f) {
-        *((unsigned int *)rt) = *((unsigned int *)cp2);
-      }
-      else if (mfac <= 0.0f) {
-        *((unsigned int *)rt) = *((unsigned int *)cp1);
-      }
-      else {
-        tempc[0] = fac * rt1[0] + mfac * rt2[0];
-        tempc[1] = fac * rt1[1] + mfac * rt2[1];
-        tempc[2] = fac * rt1[2] + mfac * rt2[2];
-        tempc[3] = fac * rt1[3] + mfac * rt2[3];
-
-        premul_float_to_straight_uchar(rt, tempc);
-      }
-      cp1 += 4;
-      cp2 += 4;
-      rt += 4;
-    }
+  /* rt = rt1 over rt2  (alpha from rt1) */
+  for (int i = 0; i < y; i++) {
+    seq_kernel_alphaover_row_byte(rect1, rect2, out, x, (i & 1) ? facf1 : facf0);
+    rect1 += x * 4;
+    rect2 += x * 4;
+    out += x * 4;
   }
 }
 
 static void do_alphaover_effect_float(
     float facf0, float facf1, int x, int y, float *rect1, float *rect2, float *out)
 {
-  float fac2, mfac, fac, fac4;
-  int xo;
-  float *rt1, *rt2, *rt;
-
-  xo = x;
-  rt1 = rect1;
-  rt2 = rect2;
-  rt = out;
-
-  fac2 = facf0;
-  fac4 = facf1;
-
-  while (y--) {
-    x = xo;
-    while (x--) {
-      /* rt = rt1 over rt2  (alpha from rt1) */
-
-      fac = fac2;
-      mfac = 1.0f - (fac2 * rt1[3]);
-
-      if (fac <= 0.0f) {
-        memcpy(rt, rt2, sizeof(float[4]));
-      }
-      else if (mfac <= 0) {
-        memcpy(rt, rt1, sizeof(float[4]));
-      }
-      else {
-        rt[0] = fac * rt1[0] + mfac * rt2[0];
-        rt[1] = fac * rt1[1] + mfac * rt2[1];
-        rt[2] = fac * rt1[2] + mfac * rt2[2];
-        rt[3] = fac * rt1[3] + mfac * rt2[3];
-      }
-      rt1 += 4;
-      rt2 += 4;
-      rt += 4;
-    }
-
-    if (y == 0) {
-      break;
-    }
-    y--;
-
-    x = xo;
-    while (x--) {
-      fac = fac4;
-      mfac = 1.0f - (fac4 * rt1[3]);
-
-      if (fac <= 0.0f) {
-        memcpy(rt, rt2, sizeof(float[4]));
-      }
-      else if (mfac <= 0.0f) {
-        memcpy(rt, rt1, sizeof(float[4]));
-      }
-      else {
-        rt[0] = fac * rt1[0] + mfac * rt2[0];
-        rt[1] = fac * rt1[1] + mfac * rt2[1];
-        rt[2] = fac * rt1[2] + mfac * rt2[2];
-        rt[3] = fac * rt1[3] + mfac * rt2[3];
-      }
-      rt1 += 4;
-      rt2 += 4;
-      rt += 4;
-    }
+  /* rt = rt1 over rt2  (alpha from rt1) */
+  for (int i = 0; i < y; i++) {
+    seq_kernel_alphaover_row_float(rect1, rect2, out, x, (i & 1) ? facf1 : facf0);
+    rect1 += x * 4;
+    rect2 += x * 4;
+    out += x * 4;
   }
 }
 
@@ -394,170 +270,24 @@ static void do_alphaunder_effect_byte(float facf0,
                                       unsigned char *rect2,
                                       unsigned char *out)
 {
-  float fac2, fac, fac4;
-  int xo;
-  unsigned char *cp1, *cp2, *rt;
-  float tempc[4], rt1[4], rt2[4];
-
-  xo = x;
-  cp1 = rect1;
-  cp2 = rect2;
-  rt = out;
-
-  fac2 = facf0;
-  fac4 = facf1;
-
-  while (y--) {
-    x = xo;
-    while (x--) {
-      /* rt = rt1 under rt2  (alpha from rt2) */
-      straight_uchar_to_premul_float(rt1, cp1);
-      straight_uchar_to_premul_float(rt2, cp2);
-
-      /* this complex optimization is because the
-       * 'skybuf' can be crossed in
-       */
-      if (rt2[3] <= 0.0f && fac2 >= 1.0f) {
-        *((unsigned int *)rt) = *((unsigned int *)cp1);
-      }
-      else if (rt2[3] >= 1.0f) {
-        *((unsigned int *)rt) = *((unsigned int *)cp2);
-      }
-      else {
-        fac = (fac2 * (1.0f - rt2[3]));
-
-        if (fac <= 0) {
-          *((unsigned int *)rt) = *((unsigned int *)cp2);
-        }
-        else {
-          tempc[0] = (fac * rt1[0] + rt2[0]);
-          tempc[1] = (fac * rt1[1] + rt2[1]);
-          tempc[2] = (fac * rt1[2] + rt2[2]);
-          tempc[3] = (fac * rt1[3] + rt2[3]);
-
-          premul_float_to_straight_uchar(rt, tempc);
-        }
-      }
-      cp1 += 4;
-      cp2 += 4;
-      rt += 4;
-    }
-
-    if (y == 0) {
-      break;
-    }
-    y--;
-
-    x = xo;
-    while (x--) {
-      straight_uchar_to_premul_float(rt1, cp1);
-      straight_uchar_to_premul_float(rt2, cp2);
-
-      if (rt2[3] <= 0.0f && fac4 >= 1.0f) {
-        *((unsigned int *)rt) = *((unsigned int *)cp1);
-      }
-      else if (rt2[3] >= 1.0f) {
-        *((unsigned int *)rt) = *((unsigned int *)cp2);
-      }
-      else {
-        fac = (fac4 * (1.0f - rt2[3]));
-
-        if (fac <= 0) {
-          *((unsigned int *)rt) = *((unsigned int *)cp2);
-        }
-        else {
-          tempc[0] = (fac * rt1[0] + rt2[0]);
-          tempc[1] = (fac * rt1[1] + rt2[1]);
-          tempc[2] = (fac * rt1[2] + rt2[2]);
-          tempc[3] = (fac * rt1[3] + rt2[3]);
-
-          premul_float_to_straight_uchar(rt, tempc);
-        }
-      }
-      cp1 += 4;
-      cp2 += 4;
-      rt += 4;
-    }
+  /* rt = rt1 under rt2  (alpha from rt2) */
+  for (int i = 0; i < y; i++) {
+    seq_kernel_alphaunder_row_byte(rect1, rect2, out, x, (i & 1) ? facf1 : facf0);
+    rect1 += x * 4;
+    rect2 += x * 4;
+    out += x * 4;
   }
 }
 
 static void do_alphaunder_effect_float(
     float facf0, float facf1, int x, int y, float *rect1, float *rect2, float *out)
 {
-  float fac2, fac, fac4;
-  int xo;
-  float *rt1, *rt2, *rt;
-
-  xo = x;
-  rt1 = rect1;
-  rt2 = rect2;
-  rt = out;
-
-  fac2 = facf0;
-  fac4 = facf1;
-
-  while (y--) {
-    x = xo;
-    while (x--) {
-      /* rt = rt1 under rt2  (alpha from rt2) */
-
-      /* this complex optimization is because the
-       * 'skybuf' can be crossed in
-       */
-      if (rt2[3] <= 0 && fac2 >= 1.0f) {
-        memcpy(rt, rt1, sizeof(float[4]));
-      }
-      else if (rt2[3] >= 1.0f) {
-        memcpy(rt, rt2, sizeof(float[4]));
-      }
-      else {
-        fac = fac2 * (1.0f - rt2[3]);
-
-        if (fac == 0) {
-          memcpy(rt, rt2, sizeof(float[4]));
-        }
-        else {
-          rt[0] = fac * rt1[0] + rt2[0];
-          rt[1] = fac * rt1[1] + rt2[1];
-          rt[2] = fac * rt1[2] + rt2[2];
-          rt[3] = fac * rt1[3] + rt2[3];
-        }
-      }
-      rt1 += 4;
-      rt2 += 4;
-      rt += 4;
-    }
-
-    if (y == 0) {
-      break;
-    }
-    y--;
-
-    x = xo;
-    while (x--) {
-      if (rt2[3] <= 0 && fac4 >= 1.0f) {
-        memcpy(rt, rt1, sizeof(float[4]));
-      }
-      else if (rt2[3] >= 1.0f) {
-        memcpy(rt, rt2, sizeof(float[4]));
-      }
-      else {
-        fac = fac4 * (1.0f - rt2[3]);
-
-        if (fac == 0) {
-          memcpy(rt, rt2, sizeof(float[4]));
-        }
-        else {
-          rt[0] = fac * rt1[0] + rt2[0];
-          rt[1] = fac * rt1[1] + rt2[1];
-          rt[2] = fac * rt1[2] + rt2[2];
-          rt[3] = fac * rt1[3] + rt2[3];
-        }
-      }
-      rt1 += 4;
-      rt2 += 4;
-      rt += 4;
-    }
+  /* rt = rt1 under rt2  (alpha from rt2) */
+  for (int i = 0; i < y; i++) {
+    seq_kernel_alphaunder_row_float(rect1, rect2, out, x, (i & 1) ? facf1 : facf0);
+    rect1 += x * 4;
+    rect2 += x * 4;
+    out += x * 4;
   }
 }
 
@@ -601,98 +331,22 @@ static void do_cross_effect_byte(float facf0,
                                  unsigned char *rect2,
                                  unsigned char *out)
 {
-  int fac1, fac2, fac3, fac4;
-  int xo;
-  unsigned char *rt1, *rt2, *rt;
-
-  xo = x;
-  rt1 = rect1;
-  rt2 = rect2;
-  rt = out;
-
-  fac2 = (int)(256.0f * facf0);
-  fac1 = 256 - fac2;
-  fac4 = (int)(256.0f * facf1);
-  fac3 = 256 - fac4;
-
-  while (y--) {
-    x = xo;
-    while (x--) {
-      rt[0] = (fac1 * rt1[0] + fac2 * rt2[0]) >> 8;
-      rt[1] = (fac1 * rt1[1] + fac2 * rt2[1]) >> 8;
-      rt[2] = (fac1 * rt1[2] + fac2 * rt2[2]) >> 8;
-      rt[3] = (fac1 * rt1[3] + fac2 * rt2[3]) >> 8;
-
-      rt1 += 4;
-      rt2 += 4;
-      rt += 4;
-    }
-
-    if (y == 0) {
-      break;
-    }
-    y--;
-
-    x = xo;
-    while (x--) {
-      rt[0] = (fac3 * rt1[0] + fac4 * rt2[0]) >> 8;
-      rt[1] = (fac3 * rt1[1] + fac4 * rt2[1]) >> 8;
-      rt[2] = (fac3 * rt1[2] + fac4 * rt2[2]) >> 8;
-      rt[3] = (fac3 * rt1[3] + fac4 * rt2[3]) >> 8;
-
-      rt1 += 4;
-      rt2 += 4;
-      rt += 4;
-    }
+  for (int i = 0; i < y; i++) {
+    seq_kernel_cross_row_byte(rect1, rect2, out, x, (i & 1) ? facf1 : facf0);
+    rect1 += x * 4;
+    rect2 += x * 4;
+    out += x * 4;
   }
 }
 
 static void do_cross_effect_float(
     float facf0, float facf1, int x, int y, float *rect1, float *rect2, float *out)
 {
-  float fac1, fac2, fac3, fac4;
-  int xo;
-  float *rt1, *rt2, *rt;
-
-  xo = x;
-  rt1 = rect1;
-  rt2 = rect2;
-  rt = out;
-
-  fac2 = facf0;
-  fac1 = 1.0f - fac2;
-  fac4 = facf1;
-  fac3 = 1.0f - fac4;
-
-  while (y--) {
-    x = xo;
-    while (x--) {
-      rt[0] = fac1 * rt1[0] + fac2 * rt2[0];
-      rt[1] = fac1 * rt1[1] + fac2 * rt2[1];
-      rt[2] = fac1 * rt1[2] + fac2 * rt2[2];
-      rt[3] = fac1 * rt1[3] + fac2 * rt2[3];
-
-      rt1 += 4;
-      rt2 += 4;
-      rt += 4;
-    }
-
-    if (y == 0) {
-      break;
-    }
-    y--;
-
-    x = xo;
-    while (x--) {
-      rt[0] = fac3 * rt1[0] + fac4 * rt2[0];
-      rt[1] = fac3 * rt1[1] + fac4 * rt2[1];
-      rt[2] = fac3 * rt1[2] + fac4 * rt2[2];
-      rt[3] = fac3 * rt1[3] + fac4 * rt2[3];
-
-      rt1 += 4;
-      rt2 += 4;
-      rt += 4;
-    }
+  for (int i = 0; i < y; i++) {
+    seq_kernel_cross_row_float(rect1, rect2, out, x, (i & 1) ? facf1 : facf0);
+    rect1 += x * 4;
+    rect2 += x * 4;
+    out += x * 4;
   }
 }
 
@@ -882,6 +536,9 @@ static void free_gammacross(Sequence *UNUSED(seq), const bool UNUSED(do_id_user)
 {
 }
 
+/* Number of pixels converted to float at once by #do_gammacross_effect_byte. */
+#define GAMMACROSS_CHUNK_SIZE 256
+
 static void do_gammacross_effect_byte(float facf0,
                                       float UNUSED(facf1),
                                       int x,
@@ -890,59 +547,28 @@ static void do_gammacross_effect_byte(float facf0,
                                       unsigned char *rect2,
                                       unsigned char *out)
 {
-  float fac1, fac2;
-  int xo;
-  unsigned char *cp1, *cp2, *rt;
-  float rt1[4], rt2[4], tempc[4];
+  const float fac2 = facf0;
+  const float fac1 = 1.0f - fac2;
+  float rt1[GAMMACROSS_CHUNK_SIZE * 4], rt2[GAMMACROSS_CHUNK_SIZE * 4];
+  const int len = x * y;
 
-  xo = x;
-  cp1 = rect1;
-  cp2 = rect2;
-  rt = out;
+  /* Lines are contiguous and use the same factor, so the whole slice is processed in chunks.
+   * Conversions go through the row kernels, only the gamma tables are looked up per channel. */
+  for (int offset = 0; offset < len; offset += GAMMACROSS_CHUNK_SIZE) {
+    const int chunk_size = min_ii(GAMMACROSS_CHUNK_SIZE, len - offset);
+    seq_kernel_straight_uchar_to_premul_float_row(rt1, rect1 + offset * 4, chunk_size);
+    seq_kernel_straight_uchar_to_premul_float_row(rt2, rect2 + offset * 4, chunk_size);
 
-  fac2 = facf0;
-  fac1 = 1.0f - fac2;
-
-  while (y--) {
-    x = xo;
-    while (x--) {
-      straight_uchar_to_premul_float(rt1, cp1);
-      straight_uchar_to_premul_float(rt2, cp2);
-
-      tempc[0] = gammaCorrect(fac1 * invGammaCorrect(rt1[0]) + fac2 * invGammaCorrect(rt2[0]));
-      tempc[1] = gammaCorrect(fac1 * invGammaCorrect(rt1[1]) + fac2 * invGammaCorrect(rt2[1]));
-      tempc[2] = gammaCorrect(fac1 * invGammaCorrect(rt1[2]) + fac2 * invGammaCorrect(rt2[2]));
-      tempc[3] = gammaCorrect(fac1 * invGammaCorrect(rt1[3]) + fac2 * invGammaCorrect(rt2[3]));
-
-      premul_float_to_straight_uchar(rt, tempc);
-      cp1 += 4;
-      cp2 += 4;
-      rt += 4;
+    for (int i = 0; i < chunk_size * 4; i++) {
+      rt1[i] = gammaCorrect(fac1 * invGammaCorrect(rt1[i]) + fac2 * invGammaCorrect(rt2[i]));
     }
 
-    if (y == 0) {
-      break;
-    }
-    y--;
-
-    x = xo;
-    while (x--) {
-      straight_uchar_to_premul_float(rt1, cp1);
-      straight_uchar_to_premul_float(rt2, cp2);
-
-      tempc[0] = gammaCorrect(fac1 * invGammaCorrect(rt1[0]) + fac2 * invGammaCorrect(rt2[0]));
-      tempc[1] = gammaCorrect(fac1 * invGammaCorrect(rt1[1]) + fac2 * invGammaCorrect(rt2[1]));
-      tempc[2] = gammaCorrect(fac1 * invGammaCorrect(rt1[2]) + fac2 * invGammaCorrect(rt2[2]));
-      tempc[3] = gammaCorrect(fac1 * invGammaCorrect(rt1[3]) + fac2 * invGammaCorrect(rt2[3]));
-
-      premul_float_to_straight_uchar(rt, tempc);
-      cp1 += 4;
-      cp2 += 4;
-      rt += 4;
-    }
+    seq_kernel_premul_float_to_straight_uchar_row(out + offset * 4, rt1, chunk_size);
   }
 }
 
+#undef GAMMACROSS_CHUNK_SIZE
+
 static void do_gammacross_effect_float(
     float facf0, float UNUSED(facf1), int x, int y, float *rect1, float *rect2, float *out)
 {
@@ -1034,98 +660,22 @@ static void do_add_effect_byte(float facf0,
                                unsigned char *rect2,
                                unsigned char *out)
 {
-  int xo, fac1, fac3;
-  unsigned char *cp1, *cp2, *rt;
-
-  xo = x;
-  cp1 = rect1;
-  cp2 = rect2;
-  rt = out;
-
-  fac1 = (int)(256.0f * facf0);
-  fac3 = (int)(256.0f * facf1);
-
-  while (y--) {
-    x = xo;
-
-    while (x--) {
-      const int m = fac1 * (int)cp2[3];
-      rt[0] = min_ii(cp1[0] + ((m * cp2[0]) >> 16), 255);
-      rt[1] = min_ii(cp1[1] + ((m * cp2[1]) >> 16), 255);
-      rt[2] = min_ii(cp1[2] + ((m * cp2[2]) >> 16), 255);
-      rt[3] = cp1[3];
-
-      cp1 += 4;
-      cp2 += 4;
-      rt += 4;
-    }
-
-    if (y == 0) {
-      break;
-    }
-    y--;
-
-    x = xo;
-    while (x--) {
-      const int m = fac3 * (int)cp2[3];
-      rt[0] = min_ii(cp1[0] + ((m * cp2[0]) >> 16), 255);
-      rt[1] = min_ii(cp1[1] + ((m * cp2[1]) >> 16), 255);
-      rt[2] = min_ii(cp1[2] + ((m * cp2[2]) >> 16), 255);
-      rt[3] = cp1[3];
-
-      cp1 += 4;
-      cp2 += 4;
-      rt += 4;
-    }
+  for (int i = 0; i < y; i++) {
+    seq_kernel_add_row_byte(rect1, rect2, out, x, (i & 1) ? facf1 : facf0);
+    rect1 += x * 4;
+    rect2 += x * 4;
+    out += x * 4;
   }
 }
 
 static void do_add_effect_float(
     float facf0, float facf1, int x, int y, float *rect1, float *rect2, float *out)
 {
-  int xo;
-  float fac1, fac3;
-  float *rt1, *rt2, *rt;
-
-  xo = x;
-  rt1 = rect1;
-  rt2 = rect2;
-  rt = out;
-
-  fac1 = facf0;
-  fac3 = facf1;
-
-  while (y--) {
-    x = xo;
-    while (x--) {
-      const float m = (1.0f - (rt1[3] * (1.0f - fac1))) * rt2[3];
-      rt[0] = rt1[0] + m * rt2[0];
-      rt[1] = rt1[1] + m * rt2[1];
-      rt[2] = rt1[2] + m * rt2[2];
-      rt[3] = rt1[3];
-
-      rt1 += 4;
-      rt2 += 4;
-      rt += 4;
-    }
-
-    if (y == 0) {
-      break;
-    }
-    y--;
-
-    x = xo;
-    while (x--) {
-      const float m = (1.0f - (rt1[3] * (1.0f - fac3))) * rt2[3];
-      rt[0] = rt1[0] + m * rt2[0];
-      rt[1] = rt1[1] + m * rt2[1];
-      rt[2] = rt1[2] + m * rt2[2];
-      rt[3] = rt1[3];
-
-      rt1 += 4;
-      rt2 += 4;
-      rt += 4;
-    }
+  for (int i = 0; i < y; i++) {
+    seq_kernel_add_row_float(rect1, rect2, out, x, (i & 1) ? facf1 : facf0);
+    rect1 += x * 4;
+    rect2 += x * 4;
+    out += x * 4;
   }
 }
 
@@ -1169,98 +719,23 @@ static void do_sub_effect_byte(float facf0,
                                unsigned char *rect2,
                                unsigned char *out)
 {
-  int xo, fac1, fac3;
-  unsigned char *cp1, *cp2, *rt;
-
-  xo = x;
-  cp1 = rect1;
-  cp2 = rect2;
-  rt = out;
-
-  fac1 = (int)(256.0f * facf0);
-  fac3 = (int)(256.0f * facf1);
-
-  while (y--) {
-    x = xo;
-    while (x--) {
-      const int m = fac1 * (int)cp2[3];
-      rt[0] = max_ii(cp1[0] - ((m * cp2[0]) >> 16), 0);
-      rt[1] = max_ii(cp1[1] - ((m * cp2[1]) >> 16), 0);
-      rt[2] = max_ii(cp1[2] - ((m * cp2[2]) >> 16), 0);
-      rt[3] = cp1[3];
-
-      cp1 += 4;
-      cp2 += 4;
-      rt += 4;
-    }
-
-    if (y == 0) {
-      break;
-    }
-    y--;
-
-    x = xo;
-    while (x--) {
-      const int m = fac3 * (int)cp2[3];
-      rt[0] = max_ii(cp1[0] - ((m * cp2[0]) >> 16), 0);
-      rt[1] = max_ii(cp1[1] - ((m * cp2[1]) >> 16), 0);
-      rt[2] = max_ii(cp1[2] - ((m * cp2[2]) >> 16), 0);
-      rt[3] = cp1[3];
-
-      cp1 += 4;
-      cp2 += 4;
-      rt += 4;
-    }
+  for (int i = 0; i < y; i++) {
+    seq_kernel_sub_row_byte(rect1, rect2, out, x, (i & 1) ? facf1 : facf0);
+    rect1 += x * 4;
+    rect2 += x * 4;
+    out += x * 4;
   }
 }
 
 static void do_sub_effect_float(
     float UNUSED(facf0), float facf1, int x, int y, float *rect1, float *rect2, float *out)
 {
-  int xo;
-  float /* fac1, */ fac3_inv;
-  float *rt1, *rt2, *rt;
-
-  xo = x;
-  rt1 = rect1;
-  rt2 = rect2;
-  rt = out;
-
-  /* UNUSED */
-  // fac1 = facf0;
-  fac3_inv = 1.0f - facf1;
-
-  while (y--) {
-    x = xo;
-    while (x--) {
-      const float m = (1.0f - (rt1[3] * fac3_inv)) * rt2[3];
-      rt[0] = max_ff(rt1[0] - m * rt2[0], 0.0f);
-      rt[1] = max_ff(rt1[1] - m * rt2[1], 0.0f);
-      rt[2] = max_ff(rt1[2] - m * rt2[2], 0.0f);
-      rt[3] = rt1[3];
-
-      rt1 += 4;
-      rt2 += 4;
-      rt += 4;
-    }
-
-    if (y == 0) {
-      break;
-    }
-    y--;
-
-    x = xo;
-    while (x--) {
-      const float m = (1.0f - (rt1[3] * fac3_inv)) * rt2[3];
-      rt[0] = max_ff(rt1[0] - m * rt2[0], 0.0f);
-      rt[1] = max_ff(rt1[1] - m * rt2[1], 0.0f);
-      rt[2] = max_ff(rt1[2] - m * rt2[2], 0.0f);
-      rt[3] = rt1[3];
-
-      rt1 += 4;
-      rt2 += 4;
-      rt += 4;
-    }
+  /* Both fields use the second factor, like they always did. */
+  for (int i = 0; i < y; i++) {
+    seq_kernel_sub_row_float(rect1, rect2, out, x, facf1);
+    rect1 += x * 4;
+    rect2 += x * 4;
+    out += x * 4;
   }
 }
 
@@ -1308,48 +783,21 @@ static void do_drop_effect_byte(float facf0,
                                 unsigned char *rect1i,
                                 unsigned char *outi)
 {
-  int temp, fac, fac1, fac2;
-  unsigned char *rt1, *rt2, *out;
-  int field = 1;
-
   const int width = x;
   const int height = y;
   const int xoff = min_ii(XOFF, width);
   const int yoff = min_ii(YOFF, height);
 
-  fac1 = (int)(70.0f * facf0);
-  fac2 = (int)(70.0f * facf1);
-
-  rt2 = rect2i + yoff * 4 * width;
-  rt1 = rect1i;
-  out = outi;
+  const unsigned char *rt2 = rect2i + yoff * 4 * width;
+  const unsigned char *rt1 = rect1i;
+  unsigned char *out = outi;
   for (y = 0; y < height - yoff; y++) {
-    if (field) {
-      fac = fac1;
-    }
-    else {
-      fac = fac2;
-    }
-    field = !field;
-
     memcpy(out, rt1, sizeof(*out) * xoff * 4);
-    rt1 += xoff * 4;
-    out += xoff * 4;
-
-    for (x = xoff; x < width; x++) {
-      temp = ((fac * rt2[3]) >> 8);
-
-      *(out++) = MAX2(0, *rt1 - temp);
-      rt1++;
-      *(out++) = MAX2(0, *rt1 - temp);
-      rt1++;
-      *(out++) = MAX2(0, *rt1 - temp);
-      rt1++;
-      *(out++) = MAX2(0, *rt1 - temp);
-      rt1++;
-      rt2 += 4;
-    }
-    rt2 += xoff * 4;
+    seq_kernel_drop_row_byte(
+        rt1 + xoff * 4, rt2, out + xoff * 4, width - xoff, (y & 1) ? facf1 : facf0);
+    rt1 += width * 4;
+    rt2 += width * 4;
+    out += width * 4;
   }
   memcpy(out, rt1, sizeof(*out) * yoff * 4 * width);
 }
@@ -1357,48 +805,21 @@ static void do_drop_effect_byte(float facf0,
 static void do_drop_effect_float(
     float facf0, float facf1, int x, int y, float *rect2i, float *rect1i, float *outi)
 {
-  float temp, fac, fac1, fac2;
-  float *rt1, *rt2, *out;
-  int field = 1;
-
   const int width = x;
   const int height = y;
   const int xoff = min_ii(XOFF, width);
   const int yoff = min_ii(YOFF, height);
 
-  fac1 = 70.0f * facf0;
-  fac2 = 70.0f * facf1;
-
-  rt2 = rect2i + yoff * 4 * width;
-  rt1 = rect1i;
-  out = outi;
+  const float *rt2 = rect2i + yoff * 4 * width;
+  const float *rt1 = rect1i;
+  float *out = outi;
   for (y = 0; y < height - yoff; y++) {
-    if (field) {
-      fac = fac1;
-    }
-    else {
-      fac = fac2;
-    }
-    field = !field;
-
     memcpy(out, rt1, sizeof(*out) * xoff * 4);
-    rt1 += xoff * 4;
-    out += xoff * 4;
-
-    for (x = xoff; x < width; x++) {
-      temp = fac * rt2[3];
-
-      *(out++) = MAX2(0.0f, *rt1 - temp);
-      rt1++;
-      *(out++) = MAX2(0.0f, *rt1 - temp);
-      rt1++;
-      *(out++) = MAX2(0.0f, *rt1 - temp);
-      rt1++;
-      *(out++) = MAX2(0.0f, *rt1 - temp);
-      rt1++;
-      rt2 += 4;
-    }
-    rt2 += xoff * 4;
+    seq_kernel_drop_row_float(
+        rt1 + xoff * 4, rt2, out + xoff * 4, width - xoff, (y & 1) ? facf1 : facf0);
+    rt1 += width * 4;
+    rt2 += width * 4;
+    out += width * 4;
   }
   memcpy(out, rt1, sizeof(*out) * yoff * 4 * width);
 }
@@ -1413,105 +834,22 @@ static void do_mul_effect_byte(float facf0,
                                unsigned char *rect2,
                                unsigned char *out)
 {
-  int xo, fac1, fac3;
-  unsigned char *rt1, *rt2, *rt;
-
-  xo = x;
-  rt1 = rect1;
-  rt2 = rect2;
-  rt = out;
-
-  fac1 = (int)(256.0f * facf0);
-  fac3 = (int)(256.0f * facf1);
-
-  /* formula:
-   * fac * (a * b) + (1 - fac) * a  => fac * a * (b - 1) + axaux = c * px + py * s; //+centx
-   * yaux = -s * px + c * py; //+centy
-   */
-
-  while (y--) {
-
-    x = xo;
-    while (x--) {
-
-      rt[0] = rt1[0] + ((fac1 * rt1[0] * (rt2[0] - 255)) >> 16);
-      rt[1] = rt1[1] + ((fac1 * rt1[1] * (rt2[1] - 255)) >> 16);
-      rt[2] = rt1[2] + ((fac1 * rt1[2] * (rt2[2] - 255)) >> 16);
-      rt[3] = rt1[3] + ((fac1 * rt1[3] * (rt2[3] - 255)) >> 16);
-
-      rt1 += 4;
-      rt2 += 4;
-      rt += 4;
-    }
-
-    if (y == 0) {
-      break;
-    }
-    y--;
-
-    x = xo;
-    while (x--) {
-
-      rt[0] = rt1[0] + ((fac3 * rt1[0] * (rt2[0] - 255)) >> 16);
-      rt[1] = rt1[1] + ((fac3 * rt1[1] * (rt2[1] - 255)) >> 16);
-      rt[2] = rt1[2] + ((fac3 * rt1[2] * (rt2[2] - 255)) >> 16);
-      rt[3] = rt1[3] + ((fac3 * rt1[3] * (rt2[3] - 255)) >> 16);
-
-      rt1 += 4;
-      rt2 += 4;
-      rt += 4;
-    }
+  for (int i = 0; i < y; i++) {
+    seq_kernel_mul_row_byte(rect1, rect2, out, x, (i & 1) ? facf1 : facf0);
+    rect1 += x * 4;
+    rect2 += x * 4;
+    out += x * 4;
   }
 }
 
 static void do_mul_effect_float(
     float facf0, float facf1, int x, int y, float *rect1, float *rect2, float *out)
 {
-  int xo;
-  float fac1, fac3;
-  float *rt1, *rt2, *rt;
-
-  xo = x;
-  rt1 = rect1;
-  rt2 = rect2;
-  rt = out;
-
-  fac1 = facf0;
-  fac3 = facf1;
-
-  /* formula:
-   * fac * (a * b) + (1 - fac) * a  =>  fac * a * (b - 1) + a
-   */
-
-  while (y--) {
-    x = xo;
-    while (x--) {
-      rt[0] = rt1[0] + fac1 * rt1[0] * (rt2[0] - 1.0f);
-      rt[1] = rt1[1] + fac1 * rt1[1] * (rt2[1] - 1.0f);
-      rt[2] = rt1[2] + fac1 * rt1[2] * (rt2[2] - 1.0f);
-      rt[3] = rt1[3] + fac1 * rt1[3] * (rt2[3] - 1.0f);
-
-      rt1 += 4;
-      rt2 += 4;
-      rt += 4;
-    }
-
-    if (y == 0) {
-      break;
-    }
-    y--;
-
-    x = xo;
-    while (x--) {
-      rt[0] = rt1[0] + fac3 * rt1[0] * (rt2[0] - 1.0f);
-      rt[1] = rt1[1] + fac3 * rt1[1] * (rt2[1] - 1.0f);
-      rt[2] = rt1[2] + fac3 * rt1[2] * (rt2[2] - 1.0f);
-      rt[3] = rt1[3] + fac3 * rt1[3] * (rt2[3] - 1.0f);
-
-      rt1 += 4;
-      rt2 += 4;
-      rt += 4;
-    }
+  for (int i = 0; i < y; i++) {
+    seq_kernel_mul_row_float(rect1, rect2, out, x, (i & 1) ? facf1 : facf0);
+    rect1 += x * 4;
+    rect2 += x * 4;
+    out += x * 4;
   }
 }
 
@@ -1546,11 +884,6 @@ static void do_mul_effect(const SeqRenderData *context,
 }
 
 /*********************** Blend Mode ***************************************/
-typedef void (*IMB_blend_func_byte)(unsigned char *dst,
-                                    const unsigned char *src1,
-                                    const unsigned char *src2);
-typedef void (*IMB_blend_func_float)(float *dst, const float *src1, const float *src2);
-
 BLI_INLINE void apply_blend_function_byte(float facf0,
                                           float facf1,
                                           int x,
@@ -1558,40 +891,13 @@ BLI_INLINE void apply_blend_function_byte(float facf0,
                                           unsigned char *rect1,
                                           unsigned char *rect2,
                                           unsigned char *out,
-                                          IMB_blend_func_byte blend_function)
+                                          SeqBlendFuncByte blend_function)
 {
-  int xo;
-  unsigned char *rt1, *rt2, *rt;
-  unsigned int achannel;
-  xo = x;
-  rt1 = rect1;
-  rt2 = rect2;
-  rt = out;
-  while (y--) {
-    for (x = xo; x > 0; x--) {
-      achannel = rt1[3];
-      rt1[3] = (unsigned int)achannel * facf0;
-      blend_function(rt, rt1, rt2);
-      rt1[3] = achannel;
-      rt[3] = rt1[3];
-      rt1 += 4;
-      rt2 += 4;
-      rt += 4;
-    }
-    if (y == 0) {
-      break;
-    }
-    y--;
-    for (x = xo; x > 0; x--) {
-      achannel = rt1[3];
-      rt1[3] = (unsigned int)achannel * facf1;
-      blend_function(rt, rt1, rt2);
-      rt1[3] = achannel;
-      rt[3] = rt1[3];
-      rt1 += 4;
-      rt2 += 4;
-      rt += 4;
-    }
+  for (int i = 0; i < y; i++) {
+    seq_kernel_blend_row_byte(rect1, rect2, out, x, (i & 1) ? facf1 : facf0, blend_function);
+    rect1 += x * 4;
+    rect2 += x * 4;
+    out += x * 4;
   }
 }
 
@@ -1602,40 +908,13 @@ BLI_INLINE void apply_blend_function_float(float facf0,
                                            float *rect1,
                                            float *rect2,
                                            float *out,
-                                           IMB_blend_func_float blend_function)
+                                           SeqBlendFuncFloat blend_function)
 {
-  int xo;
-  float *rt1, *rt2, *rt;
-  float achannel;
-  xo = x;
-  rt1 = rect1;
-  rt2 = rect2;
-  rt = out;
-  while (y--) {
-    for (x = xo; x > 0; x--) {
-      achannel = rt1[3];
-      rt1[3] = achannel * facf0;
-      blend_function(rt, rt1, rt2);
-      rt1[3] = achannel;
-      rt[3] = rt1[3];
-      rt1 += 4;
-      rt2 += 4;
-      rt += 4;
-    }
-    if (y == 0) {
-      break;
-    }
-    y--;
-    for (x = xo; x > 0; x--) {
-      achannel = rt1[3];
-      rt1[3] = achannel * facf1;
-      blend_function(rt, rt1, rt2);
-      rt1[3] = achannel;
-      rt[3] = rt1[3];
-      rt1 += 4;
-      rt2 += 4;
-      rt += 4;
-    }
+  for (int i = 0; i < y; i++) {
+    seq_kernel_blend_row_float(rect1, rect2, out, x, (i & 1) ? facf1 : facf0, blend_function);
+    rect1 += x * 4;
+    rect2 += x * 4;
+    out += x * 4;
   }
 }
 
@@ -2185,65 +1464,21 @@ static void do_wipe_effect_byte(Sequence *seq,
 {
   WipeZone wipezone;
   WipeVars *wipe = (WipeVars *)seq->effectdata;
-  int xo, yo;
-  unsigned char *cp1, *cp2, *rt;
+  float *fac = MEM_mallocN(sizeof(*fac) * x, __func__);
 
   precalc_wipe_zone(&wipezone, wipe, x, y);
 
-  cp1 = rect1;
-  cp2 = rect2;
-  rt = out;
-
-  xo = x;
-  yo = y;
-  for (y = 0; y < yo; y++) {
-    for (x = 0; x < xo; x++) {
-      float check = check_zone(&wipezone, x, y, seq, facf0);
-      if (check) {
-        if (cp1) {
-          float rt1[4], rt2[4], tempc[4];
-
-          straight_uchar_to_premul_float(rt1, cp1);
-          straight_uchar_to_premul_float(rt2, cp2);
-
-          tempc[0] = rt1[0] * check + rt2[0] * (1 - check);
-          tempc[1] = rt1[1] * check + rt2[1] * (1 - check);
-          tempc[2] = rt1[2] * check + rt2[2] * (1 - check);
-          tempc[3] = rt1[3] * check + rt2[3] * (1 - check);
-
-          premul_float_to_straight_uchar(rt, tempc);
-        }
-        else {
-          rt[0] = 0;
-          rt[1] = 0;
-          rt[2] = 0;
-          rt[3] = 255;
-        }
-      }
-      else {
-        if (cp2) {
-          rt[0] = cp2[0];
-          rt[1] = cp2[1];
-          rt[2] = cp2[2];
-          rt[3] = cp2[3];
-        }
-        else {
-          rt[0] = 0;
-          rt[1] = 0;
-          rt[2] = 0;
-          rt[3] = 255;
-        }
-      }
-
-      rt += 4;
-      if (cp1 != NULL) {
-        cp1 += 4;
-      }
-      if (cp2 != NULL) {
-        cp2 += 4;
-      }
+  for (int j = 0; j < y; j++) {
+    for (int i = 0; i < x; i++) {
+      fac[i] = check_zone(&wipezone, i, j, seq, facf0);
     }
+    seq_kernel_mix_row_byte(rect1, rect2, out, x, fac);
+    rect1 += x * 4;
+    rect2 += x * 4;
+    out += x * 4;
   }
+
+  MEM_freeN(fac);
 }
 
 static void do_wipe_effect_float(Sequence *seq,
@@ -2257,58 +1492,21 @@ static void do_wipe_effect_float(Sequence *seq,
 {
   WipeZone wipezone;
   WipeVars *wipe = (WipeVars *)seq->effectdata;
-  int xo, yo;
-  float *rt1, *rt2, *rt;
+  float *fac = MEM_mallocN(sizeof(*fac) * x, __func__);
 
   precalc_wipe_zone(&wipezone, wipe, x, y);
 
-  rt1 = rect1;
-  rt2 = rect2;
-  rt = out;
-
-  xo = x;
-  yo = y;
-  for (y = 0; y < yo; y++) {
-    for (x = 0; x < xo; x++) {
-      float check = check_zone(&wipezone, x, y, seq, facf0);
-      if (check) {
-        if (rt1) {
-          rt[0] = rt1[0] * check + rt2[0] * (1 - check);
-          rt[1] = rt1[1] * check + rt2[1] * (1 - check);
-          rt[2] = rt1[2] * check + rt2[2] * (1 - check);
-          rt[3] = rt1[3] * check + rt2[3] * (1 - check);
-        }
-        else {
-          rt[0] = 0;
-          rt[1] = 0;
-          rt[2] = 0;
-          rt[3] = 1.0;
-        }
-      }
-      else {
-        if (rt2) {
-          rt[0] = rt2[0];
-          rt[1] = rt2[1];
-          rt[2] = rt2[2];
-          rt[3] = rt2[3];
-        }
-        else {
-          rt[0] = 0;
-          rt[1] = 0;
-          rt[2] = 0;
-          rt[3] = 1.0;
-        }
-      }
-
-      rt += 4;
-      if (rt1 != NULL) {
-        rt1 += 4;
-      }
-      if (rt2 != NULL) {
-        rt2 += 4;
-      }
+  for (int j = 0; j < y; j++) {
+    for (int i = 0; i < x; i++) {
+      fac[i] = check_zone(&wipezone, i, j, seq, facf0);
     }
+    seq_kernel_mix_row_float(rect1, rect2, out, x, fac);
+    rect1 += x * 4;
+    rect2 += x * 4;
+    out += x * 4;
   }
+
+  MEM_freeN(fac);
 }
 
 static ImBuf *do_wipe_effect(const SeqRenderData *context,
@@ -3803,6 +3001,10 @@ static void init_text_effect(Sequence *seq)
   data->align_y = SEQ_TEXT_ALIGN_Y_BOTTOM;
 }
 
+/* BLF font state is global, while text strips can be rendered from prefetch and render pool
+ * workers at the same time. Drawing, loading and unloading fonts is serialized by this mutex. */
+static ThreadMutex text_draw_mutex = BLI_MUTEX_INITIALIZER;
+
 void BKE_sequencer_text_font_unload(TextVars *data, const bool do_id_user)
 {
   if (data) {
@@ -3814,7 +3016,9 @@ void BKE_sequencer_text_font_unload(TextVars *data, const bool do_id_user)
 
     /* Unload the BLF font. */
     if (data->text_blf_id >= 0) {
+      BLI_mutex_lock(&text_draw_mutex);
       BLF_unload_id(data->text_blf_id);
+      BLI_mutex_unlock(&text_draw_mutex);
     }
   }
 }
@@ -3831,7 +3035,9 @@ void BKE_sequencer_text_font_load(TextVars *data, const bool do_id_user)
     BLI_assert(BLI_thread_is_main());
     BLI_path_abs(path, ID_BLEND_PATH_FROM_GLOBAL(&data->text_font->id));
 
+    BLI_mutex_lock(&text_draw_mutex);
     data->text_blf_id = BLF_load(path);
+    BLI_mutex_unlock(&text_draw_mutex);
   }
 }
 
@@ -3897,6 +3103,8 @@ static ImBuf *do_text_effect(const SeqRenderData *context,
   int y_ofs, x, y;
   double proxy_size_comp;
 
+  BLI_mutex_lock(&text_draw_mutex);
+
   if (data->text_blf_id == SEQ_FONT_NOT_LOADED) {
     data->text_blf_id = -1;
 
@@ -4010,6 +3218,8 @@ static ImBuf *do_text_effect(const SeqRenderData *context,
 
   BLF_disable(font, BLF_WORD_WRAP);
 
+  BLI_mutex_unlock(&text_draw_mutex);
+
   return out;
 }
 
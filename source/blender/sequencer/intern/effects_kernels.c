@@ -0,0 +1,824 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup sequencer
+ */
+
+#include <string.h>
+
+#include "BLI_math_base.h"
+#include "BLI_math_color.h"
+#include "BLI_utildefines.h"
+
+#include "effects_kernels.h"
+
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
+/* -------------------------------------------------------------------- */
+/** \name SSE2 Pixel Helpers
+ *
+ * Float pixels are processed one `__m128` per RGBA pixel. Byte pixels are processed four at a
+ * time, either as 16 bit integers or transposed to one `__m128` per channel, which makes the
+ * per-pixel selects of the scalar code plain masks. All conversions round like the scalar
+ * functions in `BLI_math_color.h`.
+ * \{ */
+
+#ifdef __SSE2__
+
+BLI_INLINE __m128i load_pixels(const unsigned char *src)
+{
+  return _mm_loadu_si128((const __m128i *)src);
+}
+
+BLI_INLINE void store_pixels(unsigned char *dst, const __m128i pixels)
+{
+  _mm_storeu_si128((__m128i *)dst, pixels);
+}
+
+/* Per pixel select of packed byte pixels, `mask` has one 32 bit lane per pixel. */
+BLI_INLINE __m128i select_pixels(const __m128i mask, const __m128i a, const __m128i b)
+{
+  return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+BLI_INLINE __m128i byte_alpha_mask(void)
+{
+  return _mm_set1_epi32((int)0xFF000000);
+}
+
+/* Broadcast the alpha of every pixel in four unpacked 16 bit RGBA pixels. */
+BLI_INLINE __m128i broadcast_alpha_epi16(const __m128i color)
+{
+  return _mm_shufflehi_epi16(_mm_shufflelo_epi16(color, _MM_SHUFFLE(3, 3, 3, 3)),
+                             _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+/* Same rounding as #unit_float_to_uchar_clamp. */
+BLI_INLINE __m128i unit_float_to_uchar_clamp_epi32(const __m128 value)
+{
+  __m128 v = _mm_add_ps(_mm_mul_ps(value, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f));
+  v = _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), _mm_set1_ps(255.0f));
+  return _mm_cvttps_epi32(v);
+}
+
+/* Same as #straight_uchar_to_premul_float for four pixels, stored as one vector per channel. */
+BLI_INLINE void straight_uchar_to_premul_float_soa(const unsigned char *src, __m128 r_color[4])
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i packed = load_pixels(src);
+  const __m128i lo = _mm_unpacklo_epi8(packed, zero);
+  const __m128i hi = _mm_unpackhi_epi8(packed, zero);
+  __m128 p0 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero));
+  __m128 p1 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero));
+  __m128 p2 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero));
+  __m128 p3 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero));
+  _MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+
+  const __m128 alpha = _mm_mul_ps(p3, _mm_set1_ps(1.0f / 255.0f));
+  const __m128 fac = _mm_mul_ps(alpha, _mm_set1_ps(1.0f / 255.0f));
+  r_color[0] = _mm_mul_ps(p0, fac);
+  r_color[1] = _mm_mul_ps(p1, fac);
+  r_color[2] = _mm_mul_ps(p2, fac);
+  r_color[3] = alpha;
+}
+
+/* Same as #premul_float_to_straight_uchar for four pixels stored as one vector per channel. */
+BLI_INLINE __m128i premul_float_to_straight_uchar_soa(const __m128 color[4])
+{
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 alpha = color[3];
+  /* Scaling by one where the scalar code skips the division gives the same values. */
+  const __m128 keep = _mm_or_ps(_mm_cmpeq_ps(alpha, _mm_setzero_ps()), _mm_cmpeq_ps(alpha, one));
+  const __m128 alpha_inv = _mm_or_ps(_mm_and_ps(keep, one),
+                                     _mm_andnot_ps(keep, _mm_div_ps(one, alpha)));
+  __m128 p0 = _mm_mul_ps(color[0], alpha_inv);
+  __m128 p1 = _mm_mul_ps(color[1], alpha_inv);
+  __m128 p2 = _mm_mul_ps(color[2], alpha_inv);
+  __m128 p3 = alpha;
+  _MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+
+  const __m128i lo = _mm_packs_epi32(unit_float_to_uchar_clamp_epi32(p0),
+                                     unit_float_to_uchar_clamp_epi32(p1));
+  const __m128i hi = _mm_packs_epi32(unit_float_to_uchar_clamp_epi32(p2),
+                                     unit_float_to_uchar_clamp_epi32(p3));
+  return _mm_packus_epi16(lo, hi);
+}
+
+BLI_INLINE __m128 alpha_mask(void)
+{
+  return _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+}
+
+/* Take RGB from `rgb` and alpha from `alpha`. */
+BLI_INLINE __m128 select_alpha(const __m128 rgb, const __m128 alpha)
+{
+  const __m128 mask = alpha_mask();
+  return _mm_or_ps(_mm_and_ps(mask, alpha), _mm_andnot_ps(mask, rgb));
+}
+
+BLI_INLINE __m128 broadcast_alpha(const __m128 color)
+{
+  return _mm_shuffle_ps(color, color, _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+BLI_INLINE __m128 select_ps(const __m128 mask, const __m128 a, const __m128 b)
+{
+  return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+#endif /* __SSE2__ */
+
+/* Integer factors of the byte kernels are in 1/256 steps, the 16 bit code paths need them to be
+ * in `[0, 256]` so that products of a factor and a channel fit in 16 bits. Other factors, which
+ * only come from animating the effect outside of its range, use the scalar code. */
+#define FAC_FITS_EPI16(fac) ((fac) >= 0 && (fac) <= 256)
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Cross
+ * \{ */
+
+void seq_kernel_cross_row_byte(const unsigned char *src1,
+                               const unsigned char *src2,
+                               unsigned char *dst,
+                               int width,
+                               float fac)
+{
+  const int fac2 = (int)(256.0f * fac);
+  const int fac1 = 256 - fac2;
+  int i = 0;
+  const int len = width * 4;
+
+#ifdef __SSE2__
+  if (FAC_FITS_EPI16(fac2)) {
+    /* `fac1 + fac2 == 256` so the weighted sum fits in 16 bits. */
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i fac1_v = _mm_set1_epi16((short)fac1);
+    const __m128i fac2_v = _mm_set1_epi16((short)fac2);
+    for (; i + 16 <= len; i += 16) {
+      const __m128i a = load_pixels(src1 + i);
+      const __m128i b = load_pixels(src2 + i);
+      __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), fac1_v),
+                                 _mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), fac2_v));
+      __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(a, zero), fac1_v),
+                                 _mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), fac2_v));
+      lo = _mm_srli_epi16(lo, 8);
+      hi = _mm_srli_epi16(hi, 8);
+      store_pixels(dst + i, _mm_packus_epi16(lo, hi));
+    }
+  }
+#endif
+
+  for (; i < len; i++) {
+    dst[i] = (fac1 * src1[i] + fac2 * src2[i]) >> 8;
+  }
+}
+
+void seq_kernel_cross_row_float(
+    const float *src1, const float *src2, float *dst, int width, float fac)
+{
+  const float fac2 = fac;
+  const float fac1 = 1.0f - fac2;
+  int i = 0;
+  const int len = width * 4;
+
+#ifdef __SSE2__
+  const __m128 fac1_v = _mm_set1_ps(fac1);
+  const __m128 fac2_v = _mm_set1_ps(fac2);
+  for (; i + 4 <= len; i += 4) {
+    const __m128 a = _mm_loadu_ps(src1 + i);
+    const __m128 b = _mm_loadu_ps(src2 + i);
+    _mm_storeu_ps(dst + i, _mm_add_ps(_mm_mul_ps(fac1_v, a), _mm_mul_ps(fac2_v, b)));
+  }
+#endif
+
+  for (; i < len; i++) {
+    dst[i] = fac1 * src1[i] + fac2 * src2[i];
+  }
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Alpha Over and Under
+ * \{ */
+
+void seq_kernel_alphaover_row_byte(const unsigned char *src1,
+                                   const unsigned char *src2,
+                                   unsigned char *dst,
+                                   int width,
+                                   float fac)
+{
+  if (fac <= 0.0f) {
+    memcpy(dst, src2, sizeof(*dst) * 4 * width);
+    return;
+  }
+
+  int x = 0;
+
+#ifdef __SSE2__
+  const __m128 fac_v = _mm_set1_ps(fac);
+  for (; x + 4 <= width; x += 4, src1 += 16, src2 += 16, dst += 16) {
+    __m128 rt1[4], rt2[4], result[4];
+    straight_uchar_to_premul_float_soa(src1, rt1);
+    straight_uchar_to_premul_float_soa(src2, rt2);
+    const __m128 mfac = _mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(fac_v, rt1[3]));
+    for (int c = 0; c < 4; c++) {
+      result[c] = _mm_add_ps(_mm_mul_ps(fac_v, rt1[c]), _mm_mul_ps(mfac, rt2[c]));
+    }
+    /* Where `src1` fully covers `src2` it is passed through unchanged. */
+    const __m128i covered = _mm_castps_si128(_mm_cmple_ps(mfac, _mm_setzero_ps()));
+    store_pixels(dst,
+                 select_pixels(covered, load_pixels(src1), premul_float_to_straight_uchar_soa(result)));
+  }
+#endif
+
+  for (; x < width; x++, src1 += 4, src2 += 4, dst += 4) {
+    const float mfac = 1.0f - fac * (src1[3] * (1.0f / 255.0f));
+    if (mfac <= 0.0f) {
+      memcpy(dst, src1, sizeof(*dst) * 4);
+      continue;
+    }
+    float rt1[4], rt2[4], tempc[4];
+    straight_uchar_to_premul_float(rt1, src1);
+    straight_uchar_to_premul_float(rt2, src2);
+    tempc[0] = fac * rt1[0] + mfac * rt2[0];
+    tempc[1] = fac * rt1[1] + mfac * rt2[1];
+    tempc[2] = fac * rt1[2] + mfac * rt2[2];
+    tempc[3] = fac * rt1[3] + mfac * rt2[3];
+    premul_float_to_straight_uchar(dst, tempc);
+  }
+}
+
+void seq_kernel_alphaover_row_float(
+    const float *src1, const float *src2, float *dst, int width, float fac)
+{
+  if (fac <= 0.0f) {
+    memcpy(dst, src2, sizeof(*dst) * 4 * width);
+    return;
+  }
+
+#ifdef __SSE2__
+  const __m128 fac_v = _mm_set1_ps(fac);
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 zero = _mm_setzero_ps();
+  for (int x = 0; x < width; x++, src1 += 4, src2 += 4, dst += 4) {
+    const __m128 rt1 = _mm_loadu_ps(src1);
+    const __m128 rt2 = _mm_loadu_ps(src2);
+    const __m128 mfac = _mm_sub_ps(one, _mm_mul_ps(fac_v, broadcast_alpha(rt1)));
+    const __m128 result = _mm_add_ps(_mm_mul_ps(fac_v, rt1), _mm_mul_ps(mfac, rt2));
+    /* Where `src1` fully covers `src2` it is passed through unchanged, without branching. */
+    _mm_storeu_ps(dst, select_ps(_mm_cmple_ps(mfac, zero), rt1, result));
+  }
+#else
+  for (int x = 0; x < width; x++, src1 += 4, src2 += 4, dst += 4) {
+    const float mfac = 1.0f - (fac * src1[3]);
+    if (mfac <= 0.0f) {
+      memcpy(dst, src1, sizeof(float[4]));
+    }
+    else {
+      dst[0] = fac * src1[0] + mfac * src2[0];
+      dst[1] = fac * src1[1] + mfac * src2[1];
+      dst[2] = fac * src1[2] + mfac * src2[2];
+      dst[3] = fac * src1[3] + mfac * src2[3];
+    }
+  }
+#endif
+}
+
+void seq_kernel_alphaunder_row_byte(const unsigned char *src1,
+                                    const unsigned char *src2,
+                                    unsigned char *dst,
+                                    int width,
+                                    float fac)
+{
+  int x = 0;
+
+#ifdef __SSE2__
+  const __m128 fac_v = _mm_set1_ps(fac);
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 zero = _mm_setzero_ps();
+  /* The "sky" optimization, transparent parts of `src2` pass `src1` through at full factor. */
+  const __m128 sky = (fac >= 1.0f) ? _mm_castsi128_ps(_mm_set1_epi32(-1)) : zero;
+  for (; x + 4 <= width; x += 4, src1 += 16, src2 += 16, dst += 16) {
+    __m128 rt1[4], rt2[4], result[4];
+    straight_uchar_to_premul_float_soa(src1, rt1);
+    straight_uchar_to_premul_float_soa(src2, rt2);
+    const __m128 mfac = _mm_mul_ps(fac_v, _mm_sub_ps(one, rt2[3]));
+    for (int c = 0; c < 4; c++) {
+      result[c] = _mm_add_ps(_mm_mul_ps(mfac, rt1[c]), rt2[c]);
+    }
+    const __m128i use_src1 = _mm_castps_si128(_mm_and_ps(_mm_cmple_ps(rt2[3], zero), sky));
+    const __m128i use_src2 = _mm_castps_si128(
+        _mm_or_ps(_mm_cmpge_ps(rt2[3], one), _mm_cmple_ps(mfac, zero)));
+    __m128i pixels = premul_float_to_straight_uchar_soa(result);
+    pixels = select_pixels(use_src2, load_pixels(src2), pixels);
+    store_pixels(dst, select_pixels(use_src1, load_pixels(src1), pixels));
+  }
+#endif
+
+  for (; x < width; x++, src1 += 4, src2 += 4, dst += 4) {
+    float rt1[4], rt2[4], tempc[4];
+    straight_uchar_to_premul_float(rt1, src1);
+    straight_uchar_to_premul_float(rt2, src2);
+
+    if (rt2[3] <= 0.0f && fac >= 1.0f) {
+      memcpy(dst, src1, sizeof(*dst) * 4);
+    }
+    else if (rt2[3] >= 1.0f) {
+      memcpy(dst, src2, sizeof(*dst) * 4);
+    }
+    else {
+      const float mfac = fac * (1.0f - rt2[3]);
+      if (mfac <= 0) {
+        memcpy(dst, src2, sizeof(*dst) * 4);
+      }
+      else {
+        tempc[0] = (mfac * rt1[0] + rt2[0]);
+        tempc[1] = (mfac * rt1[1] + rt2[1]);
+        tempc[2] = (mfac * rt1[2] + rt2[2]);
+        tempc[3] = (mfac * rt1[3] + rt2[3]);
+        premul_float_to_straight_uchar(dst, tempc);
+      }
+    }
+  }
+}
+
+void seq_kernel_alphaunder_row_float(
+    const float *src1, const float *src2, float *dst, int width, float fac)
+{
+#ifdef __SSE2__
+  const __m128 fac_v = _mm_set1_ps(fac);
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 sky = (fac >= 1.0f) ? _mm_castsi128_ps(_mm_set1_epi32(-1)) : zero;
+  for (int x = 0; x < width; x++, src1 += 4, src2 += 4, dst += 4) {
+    const __m128 rt1 = _mm_loadu_ps(src1);
+    const __m128 rt2 = _mm_loadu_ps(src2);
+    const __m128 alpha2 = broadcast_alpha(rt2);
+    const __m128 mfac = _mm_mul_ps(fac_v, _mm_sub_ps(one, alpha2));
+    __m128 result = _mm_add_ps(_mm_mul_ps(mfac, rt1), rt2);
+    result = select_ps(_mm_or_ps(_mm_cmpge_ps(alpha2, one), _mm_cmpeq_ps(mfac, zero)), rt2, result);
+    result = select_ps(_mm_and_ps(_mm_cmple_ps(alpha2, zero), sky), rt1, result);
+    _mm_storeu_ps(dst, result);
+  }
+#else
+  for (int x = 0; x < width; x++, src1 += 4, src2 += 4, dst += 4) {
+    if (src2[3] <= 0 && fac >= 1.0f) {
+      memcpy(dst, src1, sizeof(float[4]));
+    }
+    else if (src2[3] >= 1.0f) {
+      memcpy(dst, src2, sizeof(float[4]));
+    }
+    else {
+      const float mfac = fac * (1.0f - src2[3]);
+      if (mfac == 0) {
+        memcpy(dst, src2, sizeof(float[4]));
+      }
+      else {
+        dst[0] = mfac * src1[0] + src2[0];
+        dst[1] = mfac * src1[1] + src2[1];
+        dst[2] = mfac * src1[2] + src2[2];
+        dst[3] = mfac * src1[3] + src2[3];
+      }
+    }
+  }
+#endif
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Add, Subtract and Multiply
+ * \{ */
+
+void seq_kernel_add_row_byte(const unsigned char *src1,
+                             const unsigned char *src2,
+                             unsigned char *dst,
+                             int width,
+                             float fac)
+{
+  const int fac_i = (int)(256.0f * fac);
+  int x = 0;
+
+#ifdef __SSE2__
+  if (FAC_FITS_EPI16(fac_i)) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i fac_v = _mm_set1_epi16((short)fac_i);
+    for (; x + 4 <= width; x += 4, src1 += 16, src2 += 16, dst += 16) {
+      const __m128i a = load_pixels(src1);
+      const __m128i b = load_pixels(src2);
+      __m128i result[2];
+      for (int half = 0; half < 2; half++) {
+        const __m128i a16 = half ? _mm_unpackhi_epi8(a, zero) : _mm_unpacklo_epi8(a, zero);
+        const __m128i b16 = half ? _mm_unpackhi_epi8(b, zero) : _mm_unpacklo_epi8(b, zero);
+        /* `m = fac * alpha` is at most 65280, `(m * b) >> 16` is the high half of the product. */
+        const __m128i m = _mm_mullo_epi16(broadcast_alpha_epi16(b16), fac_v);
+        result[half] = _mm_add_epi16(a16, _mm_mulhi_epu16(m, b16));
+      }
+      /* Saturating pack clamps to 255. */
+      const __m128i sum = _mm_packus_epi16(result[0], result[1]);
+      store_pixels(dst, select_pixels(byte_alpha_mask(), a, sum));
+    }
+  }
+#endif
+
+  for (; x < width; x++, src1 += 4, src2 += 4, dst += 4) {
+    const int m = fac_i * (int)src2[3];
+    dst[0] = min_ii(src1[0] + ((m * src2[0]) >> 16), 255);
+    dst[1] = min_ii(src1[1] + ((m * src2[1]) >> 16), 255);
+    dst[2] = min_ii(src1[2] + ((m * src2[2]) >> 16), 255);
+    dst[3] = src1[3];
+  }
+}
+
+void seq_kernel_add_row_float(
+    const float *src1, const float *src2, float *dst, int width, float fac)
+{
+  for (int x = 0; x < width; x++, src1 += 4, src2 += 4, dst += 4) {
+    const float m = (1.0f - (src1[3] * (1.0f - fac))) * src2[3];
+#ifdef __SSE2__
+    const __m128 rt1 = _mm_loadu_ps(src1);
+    const __m128 result = _mm_add_ps(rt1, _mm_mul_ps(_mm_set1_ps(m), _mm_loadu_ps(src2)));
+    _mm_storeu_ps(dst, select_alpha(result, rt1));
+#else
+    dst[0] = src1[0] + m * src2[0];
+    dst[1] = src1[1] + m * src2[1];
+    dst[2] = src1[2] + m * src2[2];
+    dst[3] = src1[3];
+#endif
+  }
+}
+
+void seq_kernel_sub_row_byte(const unsigned char *src1,
+                             const unsigned char *src2,
+                             unsigned char *dst,
+                             int width,
+                             float fac)
+{
+  const int fac_i = (int)(256.0f * fac);
+  int x = 0;
+
+#ifdef __SSE2__
+  if (FAC_FITS_EPI16(fac_i)) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i fac_v = _mm_set1_epi16((short)fac_i);
+    for (; x + 4 <= width; x += 4, src1 += 16, src2 += 16, dst += 16) {
+      const __m128i a = load_pixels(src1);
+      const __m128i b = load_pixels(src2);
+      __m128i result[2];
+      for (int half = 0; half < 2; half++) {
+        const __m128i a16 = half ? _mm_unpackhi_epi8(a, zero) : _mm_unpacklo_epi8(a, zero);
+        const __m128i b16 = half ? _mm_unpackhi_epi8(b, zero) : _mm_unpacklo_epi8(b, zero);
+        const __m128i m = _mm_mullo_epi16(broadcast_alpha_epi16(b16), fac_v);
+        /* Saturating subtraction clamps to 0. */
+        result[half] = _mm_subs_epu16(a16, _mm_mulhi_epu16(m, b16));
+      }
+      const __m128i diff = _mm_packus_epi16(result[0], result[1]);
+      store_pixels(dst, select_pixels(byte_alpha_mask(), a, diff));
+    }
+  }
+#endif
+
+  for (; x < width; x++, src1 += 4, src2 += 4, dst += 4) {
+    const int m = fac_i * (int)src2[3];
+    dst[0] = max_ii(src1[0] - ((m * src2[0]) >> 16), 0);
+    dst[1] = max_ii(src1[1] - ((m * src2[1]) >> 16), 0);
+    dst[2] = max_ii(src1[2] - ((m * src2[2]) >> 16), 0);
+    dst[3] = src1[3];
+  }
+}
+
+void seq_kernel_sub_row_float(
+    const float *src1, const float *src2, float *dst, int width, float fac)
+{
+  const float fac_inv = 1.0f - fac;
+
+  for (int x = 0; x < width; x++, src1 += 4, src2 += 4, dst += 4) {
+    const float m = (1.0f - (src1[3] * fac_inv)) * src2[3];
+#ifdef __SSE2__
+    const __m128 rt1 = _mm_loadu_ps(src1);
+    const __m128 result = _mm_sub_ps(rt1, _mm_mul_ps(_mm_set1_ps(m), _mm_loadu_ps(src2)));
+    _mm_storeu_ps(dst, select_alpha(_mm_max_ps(result, _mm_setzero_ps()), rt1));
+#else
+    dst[0] = max_ff(src1[0] - m * src2[0], 0.0f);
+    dst[1] = max_ff(src1[1] - m * src2[1], 0.0f);
+    dst[2] = max_ff(src1[2] - m * src2[2], 0.0f);
+    dst[3] = src1[3];
+#endif
+  }
+}
+
+void seq_kernel_mul_row_byte(const unsigned char *src1,
+                             const unsigned char *src2,
+                             unsigned char *dst,
+                             int width,
+                             float fac)
+{
+  /* formula:
+   * fac * (a * b) + (1 - fac) * a  =>  fac * a * (b - 1) + a
+   */
+  const int fac_i = (int)(256.0f * fac);
+  int i = 0;
+  const int len = width * 4;
+
+#ifdef __SSE2__
+  if (FAC_FITS_EPI16(fac_i)) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i max = _mm_set1_epi16(255);
+    const __m128i fac_v = _mm_set1_epi16((short)fac_i);
+    for (; i + 16 <= len; i += 16) {
+      const __m128i a = load_pixels(src1 + i);
+      const __m128i b = load_pixels(src2 + i);
+      __m128i result[2];
+      for (int half = 0; half < 2; half++) {
+        const __m128i a16 = half ? _mm_unpackhi_epi8(a, zero) : _mm_unpacklo_epi8(a, zero);
+        const __m128i b16 = half ? _mm_unpackhi_epi8(b, zero) : _mm_unpacklo_epi8(b, zero);
+        /* The scalar code shifts a negative product, which rounds down, so subtract the
+         * rounded up quotient of the positive product. */
+        const __m128i p = _mm_mullo_epi16(fac_v, a16);
+        const __m128i q = _mm_sub_epi16(max, b16);
+        const __m128i exact = _mm_cmpeq_epi16(_mm_mullo_epi16(p, q), zero);
+        const __m128i quotient = _mm_add_epi16(_mm_mulhi_epu16(p, q),
+                                               _mm_andnot_si128(exact, one));
+        result[half] = _mm_sub_epi16(a16, quotient);
+      }
+      store_pixels(dst + i, _mm_packus_epi16(result[0], result[1]));
+    }
+  }
+#endif
+
+  for (; i < len; i++) {
+    dst[i] = src1[i] + ((fac_i * src1[i] * (src2[i] - 255)) >> 16);
+  }
+}
+
+void seq_kernel_mul_row_float(
+    const float *src1, const float *src2, float *dst, int width, float fac)
+{
+  /* formula:
+   * fac * (a * b) + (1 - fac) * a  =>  fac * a * (b - 1) + a
+   */
+  int i = 0;
+  const int len = width * 4;
+
+#ifdef __SSE2__
+  const __m128 fac_v = _mm_set1_ps(fac);
+  const __m128 one = _mm_set1_ps(1.0f);
+  for (; i + 4 <= len; i += 4) {
+    const __m128 a = _mm_loadu_ps(src1 + i);
+    const __m128 b = _mm_loadu_ps(src2 + i);
+    _mm_storeu_ps(dst + i, _mm_add_ps(a, _mm_mul_ps(_mm_mul_ps(fac_v, a), _mm_sub_ps(b, one))));
+  }
+#endif
+
+  for (; i < len; i++) {
+    dst[i] = src1[i] + fac * src1[i] * (src2[i] - 1.0f);
+  }
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Drop
+ * \{ */
+
+void seq_kernel_drop_row_byte(const unsigned char *src,
+                              const unsigned char *shadow,
+                              unsigned char *dst,
+                              int width,
+                              float fac)
+{
+  const int fac_i = (int)(70.0f * fac);
+  int x = 0;
+
+#ifdef __SSE2__
+  if (FAC_FITS_EPI16(fac_i)) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i fac_v = _mm_set1_epi16((short)fac_i);
+    for (; x + 4 <= width; x += 4, src += 16, shadow += 16, dst += 16) {
+      const __m128i a = load_pixels(src);
+      const __m128i b = load_pixels(shadow);
+      __m128i result[2];
+      for (int half = 0; half < 2; half++) {
+        const __m128i a16 = half ? _mm_unpackhi_epi8(a, zero) : _mm_unpacklo_epi8(a, zero);
+        const __m128i b16 = half ? _mm_unpackhi_epi8(b, zero) : _mm_unpacklo_epi8(b, zero);
+        const __m128i temp = _mm_srli_epi16(
+            _mm_mullo_epi16(broadcast_alpha_epi16(b16), fac_v), 8);
+        result[half] = _mm_subs_epu16(a16, temp);
+      }
+      store_pixels(dst, _mm_packus_epi16(result[0], result[1]));
+    }
+  }
+#endif
+
+  for (; x < width; x++, src += 4, shadow += 4, dst += 4) {
+    const int temp = ((fac_i * shadow[3]) >> 8);
+    dst[0] = MAX2(0, src[0] - temp);
+    dst[1] = MAX2(0, src[1] - temp);
+    dst[2] = MAX2(0, src[2] - temp);
+    dst[3] = MAX2(0, src[3] - temp);
+  }
+}
+
+void seq_kernel_drop_row_float(
+    const float *src, const float *shadow, float *dst, int width, float fac)
+{
+  const float fac_f = 70.0f * fac;
+
+  for (int x = 0; x < width; x++, src += 4, shadow += 4, dst += 4) {
+    const float temp = fac_f * shadow[3];
+#ifdef __SSE2__
+    /* Operand order keeps the sign of zero results of #MAX2. */
+    const __m128 result = _mm_sub_ps(_mm_loadu_ps(src), _mm_set1_ps(temp));
+    _mm_storeu_ps(dst, _mm_max_ps(_mm_setzero_ps(), result));
+#else
+    dst[0] = MAX2(0.0f, src[0] - temp);
+    dst[1] = MAX2(0.0f, src[1] - temp);
+    dst[2] = MAX2(0.0f, src[2] - temp);
+    dst[3] = MAX2(0.0f, src[3] - temp);
+#endif
+  }
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Mix
+ * \{ */
+
+void seq_kernel_mix_row_byte(const unsigned char *src1,
+                             const unsigned char *src2,
+                             unsigned char *dst,
+                             int width,
+                             const float *fac)
+{
+  int x = 0;
+
+#ifdef __SSE2__
+  const __m128 one = _mm_set1_ps(1.0f);
+  for (; x + 4 <= width; x += 4, src1 += 16, src2 += 16, dst += 16, fac += 4) {
+    __m128 rt1[4], rt2[4], result[4];
+    const __m128 fac_v = _mm_loadu_ps(fac);
+    const __m128 mfac = _mm_sub_ps(one, fac_v);
+    straight_uchar_to_premul_float_soa(src1, rt1);
+    straight_uchar_to_premul_float_soa(src2, rt2);
+    for (int c = 0; c < 4; c++) {
+      result[c] = _mm_add_ps(_mm_mul_ps(rt1[c], fac_v), _mm_mul_ps(rt2[c], mfac));
+    }
+    const __m128i unchanged = _mm_castps_si128(_mm_cmpeq_ps(fac_v, _mm_setzero_ps()));
+    store_pixels(
+        dst,
+        select_pixels(unchanged, load_pixels(src2), premul_float_to_straight_uchar_soa(result)));
+  }
+#endif
+
+  for (; x < width; x++, src1 += 4, src2 += 4, dst += 4, fac++) {
+    if (*fac == 0.0f) {
+      memcpy(dst, src2, sizeof(*dst) * 4);
+      continue;
+    }
+    float rt1[4], rt2[4], tempc[4];
+    straight_uchar_to_premul_float(rt1, src1);
+    straight_uchar_to_premul_float(rt2, src2);
+    tempc[0] = rt1[0] * *fac + rt2[0] * (1 - *fac);
+    tempc[1] = rt1[1] * *fac + rt2[1] * (1 - *fac);
+    tempc[2] = rt1[2] * *fac + rt2[2] * (1 - *fac);
+    tempc[3] = rt1[3] * *fac + rt2[3] * (1 - *fac);
+    premul_float_to_straight_uchar(dst, tempc);
+  }
+}
+
+void seq_kernel_mix_row_float(
+    const float *src1, const float *src2, float *dst, int width, const float *fac)
+{
+  for (int x = 0; x < width; x++, src1 += 4, src2 += 4, dst += 4, fac++) {
+    if (*fac == 0.0f) {
+      memcpy(dst, src2, sizeof(float[4]));
+      continue;
+    }
+#ifdef __SSE2__
+    const __m128 fac_v = _mm_set1_ps(*fac);
+    const __m128 mfac = _mm_set1_ps(1 - *fac);
+    _mm_storeu_ps(dst,
+                  _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(src1), fac_v),
+                             _mm_mul_ps(_mm_loadu_ps(src2), mfac)));
+#else
+    dst[0] = src1[0] * *fac + src2[0] * (1 - *fac);
+    dst[1] = src1[1] * *fac + src2[1] * (1 - *fac);
+    dst[2] = src1[2] * *fac + src2[2] * (1 - *fac);
+    dst[3] = src1[3] * *fac + src2[3] * (1 - *fac);
+#endif
+  }
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Blend Modes
+ *
+ * The blend functions branch per pixel and mode, so these only share the row loop. The alpha
+ * of `src1` is scaled by the factor on a copy, the inputs may be shared with other threads.
+ * \{ */
+
+void seq_kernel_blend_row_byte(const unsigned char *src1,
+                               const unsigned char *src2,
+                               unsigned char *dst,
+                               int width,
+                               float fac,
+                               SeqBlendFuncByte blend_function)
+{
+  for (int x = 0; x < width; x++, src1 += 4, src2 += 4, dst += 4) {
+    const unsigned char color[4] = {
+        src1[0], src1[1], src1[2], (unsigned char)((unsigned int)src1[3] * fac)};
+    blend_function(dst, color, src2);
+    dst[3] = src1[3];
+  }
+}
+
+void seq_kernel_blend_row_float(const float *src1,
+                                const float *src2,
+                                float *dst,
+                                int width,
+                                float fac,
+                                SeqBlendFuncFloat blend_function)
+{
+  for (int x = 0; x < width; x++, src1 += 4, src2 += 4, dst += 4) {
+    const float color[4] = {src1[0], src1[1], src1[2], src1[3] * fac};
+    blend_function(dst, color, src2);
+    dst[3] = src1[3];
+  }
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Conversion
+ * \{ */
+
+void seq_kernel_straight_uchar_to_premul_float_row(float *dst,
+                                                   const unsigned char *src,
+                                                   int width)
+{
+  int x = 0;
+
+#ifdef __SSE2__
+  for (; x + 4 <= width; x += 4, src += 16, dst += 16) {
+    __m128 color[4];
+    straight_uchar_to_premul_float_soa(src, color);
+    _MM_TRANSPOSE4_PS(color[0], color[1], color[2], color[3]);
+    for (int i = 0; i < 4; i++) {
+      _mm_storeu_ps(dst + i * 4, color[i]);
+    }
+  }
+#endif
+
+  for (; x < width; x++, src += 4, dst += 4) {
+    straight_uchar_to_premul_float(dst, src);
+  }
+}
+
+void seq_kernel_premul_float_to_straight_uchar_row(unsigned char *dst,
+                                                   const float *src,
+                                                   int width)
+{
+  int x = 0;
+
+#ifdef __SSE2__
+  for (; x + 4 <= width; x += 4, src += 16, dst += 16) {
+    __m128 color[4];
+    for (int i = 0; i < 4; i++) {
+      color[i] = _mm_loadu_ps(src + i * 4);
+    }
+    _MM_TRANSPOSE4_PS(color[0], color[1], color[2], color[3]);
+    store_pixels(dst, premul_float_to_straight_uchar_soa(color));
+  }
+#endif
+
+  for (; x < width; x++, src += 4, dst += 4) {
+    premul_float_to_straight_uchar(dst, src);
+  }
+}
+
+/** \} */
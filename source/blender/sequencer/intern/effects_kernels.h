@@ -0,0 +1,135 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 Blender Foundation.
+ * All rights reserved.
+ */
+
+#pragma once
+
+/** \file
+ * \ingroup sequencer
+ *
+ * Row kernels shared by blend and transition effects.
+ *
+ * Every kernel processes one row of `width` RGBA pixels, the effect callbacks are responsible
+ * for alternating the field factors between rows. Kernels use SSE2 when available and fall
+ * back to plain C otherwise, results match the scalar code bit for bit.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Cross: `dst = (1 - fac) * src1 + fac * src2`. */
+void seq_kernel_cross_row_byte(const unsigned char *src1,
+                               const unsigned char *src2,
+                               unsigned char *dst,
+                               int width,
+                               float fac);
+void seq_kernel_cross_row_float(
+    const float *src1, const float *src2, float *dst, int width, float fac);
+
+/* Alpha Over: `src1` over `src2`, alpha taken from `src1`. */
+void seq_kernel_alphaover_row_byte(const unsigned char *src1,
+                                   const unsigned char *src2,
+                                   unsigned char *dst,
+                                   int width,
+                                   float fac);
+void seq_kernel_alphaover_row_float(
+    const float *src1, const float *src2, float *dst, int width, float fac);
+
+/* Alpha Under: `src1` under `src2`, alpha taken from `src2`. */
+void seq_kernel_alphaunder_row_byte(const unsigned char *src1,
+                                    const unsigned char *src2,
+                                    unsigned char *dst,
+                                    int width,
+                                    float fac);
+void seq_kernel_alphaunder_row_float(
+    const float *src1, const float *src2, float *dst, int width, float fac);
+
+/* Add, Subtract and Multiply: `src2` combined into `src1`, alpha taken from `src1` except for
+ * Multiply. */
+void seq_kernel_add_row_byte(const unsigned char *src1,
+                             const unsigned char *src2,
+                             unsigned char *dst,
+                             int width,
+                             float fac);
+void seq_kernel_add_row_float(
+    const float *src1, const float *src2, float *dst, int width, float fac);
+void seq_kernel_sub_row_byte(const unsigned char *src1,
+                             const unsigned char *src2,
+                             unsigned char *dst,
+                             int width,
+                             float fac);
+void seq_kernel_sub_row_float(
+    const float *src1, const float *src2, float *dst, int width, float fac);
+void seq_kernel_mul_row_byte(const unsigned char *src1,
+                             const unsigned char *src2,
+                             unsigned char *dst,
+                             int width,
+                             float fac);
+void seq_kernel_mul_row_float(
+    const float *src1, const float *src2, float *dst, int width, float fac);
+
+/* Drop: darken `src` by the alpha of the matching pixels of the offset `shadow` row. */
+void seq_kernel_drop_row_byte(const unsigned char *src,
+                              const unsigned char *shadow,
+                              unsigned char *dst,
+                              int width,
+                              float fac);
+void seq_kernel_drop_row_float(
+    const float *src, const float *shadow, float *dst, int width, float fac);
+
+/* Mix with one factor per pixel, `src2` is passed through where the factor is zero. */
+void seq_kernel_mix_row_byte(const unsigned char *src1,
+                             const unsigned char *src2,
+                             unsigned char *dst,
+                             int width,
+                             const float *fac);
+void seq_kernel_mix_row_float(
+    const float *src1, const float *src2, float *dst, int width, const float *fac);
+
+/* Blend modes: `blend_function` is one of the `blend_color_*` functions from
+ * `BLI_math_color_blend.h`, the alpha of `src1` is scaled by `fac` and kept in the result. */
+typedef void (*SeqBlendFuncByte)(unsigned char *dst,
+                                 const unsigned char *src1,
+                                 const unsigned char *src2);
+typedef void (*SeqBlendFuncFloat)(float *dst, const float *src1, const float *src2);
+
+void seq_kernel_blend_row_byte(const unsigned char *src1,
+                               const unsigned char *src2,
+                               unsigned char *dst,
+                               int width,
+                               float fac,
+                               SeqBlendFuncByte blend_function);
+void seq_kernel_blend_row_float(const float *src1,
+                                const float *src2,
+                                float *dst,
+                                int width,
+                                float fac,
+                                SeqBlendFuncFloat blend_function);
+
+/* Conversion between straight byte and premultiplied float pixels. */
+void seq_kernel_straight_uchar_to_premul_float_row(float *dst,
+                                                   const unsigned char *src,
+                                                   int width);
+void seq_kernel_premul_float_to_straight_uchar_row(unsigned char *dst,
+                                                   const float *src,
+                                                   int width);
+
+#ifdef __cplusplus
+}
+#endif
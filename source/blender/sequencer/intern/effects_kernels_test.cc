@@ -0,0 +1,426 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 by Blender Foundation.
+ */
+#include "testing/testing.h"
+
+#include <cstring>
+
+#include "BLI_array.hh"
+#include "BLI_math_base.h"
+#include "BLI_math_color.h"
+#include "BLI_math_color_blend.h"
+#include "BLI_rand.hh"
+
+#include "effects_kernels.h"
+
+/* The kernels must give the same results as the per-pixel code the effects used before, so
+ * every test compares against a copy of those formulas. Rows are long enough for the SIMD
+ * loops and end with a scalar tail. Factors outside of `[0, 1]` are tested as well, they are
+ * reachable by animating the effect factor. */
+
+namespace blender::seq::tests {
+
+static const int WIDTH = 37;
+static const float FACTORS[] = {0.0f, 0.1f, 0.25f, 0.5f, 0.73f, 0.999f, 1.0f, 1.5f, -0.2f};
+
+/* Random pixels where alpha is often fully transparent or opaque, to hit every branch. */
+static Array<unsigned char> random_byte_pixels(uint32_t seed)
+{
+  RandomNumberGenerator rng(seed);
+  Array<unsigned char> pixels(WIDTH * 4);
+  for (int i = 0; i < WIDTH; i++) {
+    for (int c = 0; c < 3; c++) {
+      pixels[i * 4 + c] = (unsigned char)rng.get_int32(256);
+    }
+    const int alpha_type = rng.get_int32(3);
+    pixels[i * 4 + 3] = (alpha_type == 0) ? 0 :
+                        (alpha_type == 1) ? 255 :
+                                            (unsigned char)rng.get_int32(256);
+  }
+  return pixels;
+}
+
+static Array<float> random_float_pixels(uint32_t seed)
+{
+  RandomNumberGenerator rng(seed);
+  Array<float> pixels(WIDTH * 4);
+  for (int i = 0; i < WIDTH; i++) {
+    const int alpha_type = rng.get_int32(3);
+    const float alpha = (alpha_type == 0) ? 0.0f : (alpha_type == 1) ? 1.0f : rng.get_float();
+    for (int c = 0; c < 3; c++) {
+      pixels[i * 4 + c] = rng.get_float() * 1.2f * alpha;
+    }
+    pixels[i * 4 + 3] = alpha;
+  }
+  return pixels;
+}
+
+template<typename T> static void expect_rows_eq(const Array<T> &expected, const Array<T> &result)
+{
+  for (int i = 0; i < expected.size(); i++) {
+    EXPECT_EQ(expected[i], result[i]) << "channel " << i % 4 << " of pixel " << i / 4;
+  }
+}
+
+using KernelByte = void (*)(
+    const unsigned char *, const unsigned char *, unsigned char *, int, float);
+using KernelFloat = void (*)(const float *, const float *, float *, int, float);
+using ReferenceByte = void (*)(const unsigned char *,
+                               const unsigned char *,
+                               unsigned char *,
+                               float);
+using ReferenceFloat = void (*)(const float *, const float *, float *, float);
+
+static void test_kernel_byte(KernelByte kernel, ReferenceByte reference)
+{
+  const Array<unsigned char> src1 = random_byte_pixels(1);
+  const Array<unsigned char> src2 = random_byte_pixels(2);
+  for (const float fac : FACTORS) {
+    Array<unsigned char> expected(WIDTH * 4), result(WIDTH * 4);
+    for (int i = 0; i < WIDTH; i++) {
+      reference(&src1[i * 4], &src2[i * 4], &expected[i * 4], fac);
+    }
+    kernel(src1.data(), src2.data(), result.data(), WIDTH, fac);
+    SCOPED_TRACE(fac);
+    expect_rows_eq(expected, result);
+  }
+}
+
+static void test_kernel_float(KernelFloat kernel, ReferenceFloat reference)
+{
+  const Array<float> src1 = random_float_pixels(3);
+  const Array<float> src2 = random_float_pixels(4);
+  for (const float fac : FACTORS) {
+    Array<float> expected(WIDTH * 4), result(WIDTH * 4);
+    for (int i = 0; i < WIDTH; i++) {
+      reference(&src1[i * 4], &src2[i * 4], &expected[i * 4], fac);
+    }
+    kernel(src1.data(), src2.data(), result.data(), WIDTH, fac);
+    SCOPED_TRACE(fac);
+    expect_rows_eq(expected, result);
+  }
+}
+
+TEST(sequencer_effect_kernels, CrossByte)
+{
+  test_kernel_byte(seq_kernel_cross_row_byte,
+                   [](const unsigned char *a, const unsigned char *b, unsigned char *r, float f) {
+                     const int fac2 = (int)(256.0f * f);
+                     const int fac1 = 256 - fac2;
+                     for (int c = 0; c < 4; c++) {
+                       r[c] = (fac1 * a[c] + fac2 * b[c]) >> 8;
+                     }
+                   });
+}
+
+TEST(sequencer_effect_kernels, CrossFloat)
+{
+  test_kernel_float(seq_kernel_cross_row_float,
+                    [](const float *a, const float *b, float *r, float f) {
+                      for (int c = 0; c < 4; c++) {
+                        r[c] = (1.0f - f) * a[c] + f * b[c];
+                      }
+                    });
+}
+
+TEST(sequencer_effect_kernels, AlphaOverByte)
+{
+  test_kernel_byte(seq_kernel_alphaover_row_byte,
+                   [](const unsigned char *a, const unsigned char *b, unsigned char *r, float f) {
+                     float rt1[4], rt2[4], tempc[4];
+                     straight_uchar_to_premul_float(rt1, a);
+                     straight_uchar_to_premul_float(rt2, b);
+                     const float mfac = 1.0f - f * rt1[3];
+                     if (f <= 0.0f) {
+                       memcpy(r, b, 4);
+                     }
+                     else if (mfac <= 0.0f) {
+                       memcpy(r, a, 4);
+                     }
+                     else {
+                       for (int c = 0; c < 4; c++) {
+                         tempc[c] = f * rt1[c] + mfac * rt2[c];
+                       }
+                       premul_float_to_straight_uchar(r, tempc);
+                     }
+                   });
+}
+
+TEST(sequencer_effect_kernels, AlphaOverFloat)
+{
+  test_kernel_float(seq_kernel_alphaover_row_float,
+                    [](const float *a, const float *b, float *r, float f) {
+                      const float mfac = 1.0f - (f * a[3]);
+                      if (f <= 0.0f) {
+                        memcpy(r, b, sizeof(float[4]));
+                      }
+                      else if (mfac <= 0) {
+                        memcpy(r, a, sizeof(float[4]));
+                      }
+                      else {
+                        for (int c = 0; c < 4; c++) {
+                          r[c] = f * a[c] + mfac * b[c];
+                        }
+                      }
+                    });
+}
+
+TEST(sequencer_effect_kernels, AlphaUnderByte)
+{
+  test_kernel_byte(seq_kernel_alphaunder_row_byte,
+                   [](const unsigned char *a, const unsigned char *b, unsigned char *r, float f) {
+                     float rt1[4], rt2[4], tempc[4];
+                     straight_uchar_to_premul_float(rt1, a);
+                     straight_uchar_to_premul_float(rt2, b);
+                     if (rt2[3] <= 0.0f && f >= 1.0f) {
+                       memcpy(r, a, 4);
+                     }
+                     else if (rt2[3] >= 1.0f) {
+                       memcpy(r, b, 4);
+                     }
+                     else {
+                       const float fac = (f * (1.0f - rt2[3]));
+                       if (fac <= 0) {
+                         memcpy(r, b, 4);
+                       }
+                       else {
+                         for (int c = 0; c < 4; c++) {
+                           tempc[c] = (fac * rt1[c] + rt2[c]);
+                         }
+                         premul_float_to_straight_uchar(r, tempc);
+                       }
+                     }
+                   });
+}
+
+TEST(sequencer_effect_kernels, AlphaUnderFloat)
+{
+  test_kernel_float(seq_kernel_alphaunder_row_float,
+                    [](const float *a, const float *b, float *r, float f) {
+                      if (b[3] <= 0 && f >= 1.0f) {
+                        memcpy(r, a, sizeof(float[4]));
+                      }
+                      else if (b[3] >= 1.0f) {
+                        memcpy(r, b, sizeof(float[4]));
+                      }
+                      else {
+                        const float fac = f * (1.0f - b[3]);
+                        if (fac == 0) {
+                          memcpy(r, b, sizeof(float[4]));
+                        }
+                        else {
+                          for (int c = 0; c < 4; c++) {
+                            r[c] = fac * a[c] + b[c];
+                          }
+                        }
+                      }
+                    });
+}
+
+TEST(sequencer_effect_kernels, AddByte)
+{
+  test_kernel_byte(seq_kernel_add_row_byte,
+                   [](const unsigned char *a, const unsigned char *b, unsigned char *r, float f) {
+                     const int m = (int)(256.0f * f) * (int)b[3];
+                     for (int c = 0; c < 3; c++) {
+                       r[c] = min_ii(a[c] + ((m * b[c]) >> 16), 255);
+                     }
+                     r[3] = a[3];
+                   });
+}
+
+TEST(sequencer_effect_kernels, AddFloat)
+{
+  test_kernel_float(seq_kernel_add_row_float,
+                    [](const float *a, const float *b, float *r, float f) {
+                      const float m = (1.0f - (a[3] * (1.0f - f))) * b[3];
+                      for (int c = 0; c < 3; c++) {
+                        r[c] = a[c] + m * b[c];
+                      }
+                      r[3] = a[3];
+                    });
+}
+
+TEST(sequencer_effect_kernels, SubByte)
+{
+  test_kernel_byte(seq_kernel_sub_row_byte,
+                   [](const unsigned char *a, const unsigned char *b, unsigned char *r, float f) {
+                     const int m = (int)(256.0f * f) * (int)b[3];
+                     for (int c = 0; c < 3; c++) {
+                       r[c] = max_ii(a[c] - ((m * b[c]) >> 16), 0);
+                     }
+                     r[3] = a[3];
+                   });
+}
+
+TEST(sequencer_effect_kernels, SubFloat)
+{
+  test_kernel_float(seq_kernel_sub_row_float,
+                    [](const float *a, const float *b, float *r, float f) {
+                      const float m = (1.0f - (a[3] * (1.0f - f))) * b[3];
+                      for (int c = 0; c < 3; c++) {
+                        r[c] = max_ff(a[c] - m * b[c], 0.0f);
+                      }
+                      r[3] = a[3];
+                    });
+}
+
+TEST(sequencer_effect_kernels, MulByte)
+{
+  test_kernel_byte(seq_kernel_mul_row_byte,
+                   [](const unsigned char *a, const unsigned char *b, unsigned char *r, float f) {
+                     const int fac = (int)(256.0f * f);
+                     for (int c = 0; c < 4; c++) {
+                       r[c] = a[c] + ((fac * a[c] * (b[c] - 255)) >> 16);
+                     }
+                   });
+}
+
+TEST(sequencer_effect_kernels, MulFloat)
+{
+  test_kernel_float(seq_kernel_mul_row_float,
+                    [](const float *a, const float *b, float *r, float f) {
+                      for (int c = 0; c < 4; c++) {
+                        r[c] = a[c] + f * a[c] * (b[c] - 1.0f);
+                      }
+                    });
+}
+
+TEST(sequencer_effect_kernels, DropByte)
+{
+  test_kernel_byte(seq_kernel_drop_row_byte,
+                   [](const unsigned char *a, const unsigned char *b, unsigned char *r, float f) {
+                     const int temp = (((int)(70.0f * f) * b[3]) >> 8);
+                     for (int c = 0; c < 4; c++) {
+                       r[c] = MAX2(0, a[c] - temp);
+                     }
+                   });
+}
+
+TEST(sequencer_effect_kernels, DropFloat)
+{
+  test_kernel_float(seq_kernel_drop_row_float,
+                    [](const float *a, const float *b, float *r, float f) {
+                      const float temp = 70.0f * f * b[3];
+                      for (int c = 0; c < 4; c++) {
+                        r[c] = MAX2(0.0f, a[c] - temp);
+                      }
+                    });
+}
+
+TEST(sequencer_effect_kernels, MixByte)
+{
+  const Array<unsigned char> src1 = random_byte_pixels(5);
+  const Array<unsigned char> src2 = random_byte_pixels(6);
+  Array<float> fac(WIDTH);
+  for (int i = 0; i < WIDTH; i++) {
+    fac[i] = FACTORS[i % ARRAY_SIZE(FACTORS)];
+  }
+
+  Array<unsigned char> expected(WIDTH * 4), result(WIDTH * 4);
+  for (int i = 0; i < WIDTH; i++) {
+    unsigned char *r = &expected[i * 4];
+    if (fac[i] == 0.0f) {
+      memcpy(r, &src2[i * 4], 4);
+      continue;
+    }
+    float rt1[4], rt2[4], tempc[4];
+    straight_uchar_to_premul_float(rt1, &src1[i * 4]);
+    straight_uchar_to_premul_float(rt2, &src2[i * 4]);
+    for (int c = 0; c < 4; c++) {
+      tempc[c] = rt1[c] * fac[i] + rt2[c] * (1 - fac[i]);
+    }
+    premul_float_to_straight_uchar(r, tempc);
+  }
+  seq_kernel_mix_row_byte(src1.data(), src2.data(), result.data(), WIDTH, fac.data());
+  expect_rows_eq(expected, result);
+}
+
+TEST(sequencer_effect_kernels, MixFloat)
+{
+  const Array<float> src1 = random_float_pixels(7);
+  const Array<float> src2 = random_float_pixels(8);
+  Array<float> fac(WIDTH);
+  for (int i = 0; i < WIDTH; i++) {
+    fac[i] = FACTORS[i % ARRAY_SIZE(FACTORS)];
+  }
+
+  Array<float> expected(WIDTH * 4), result(WIDTH * 4);
+  for (int i = 0; i < WIDTH; i++) {
+    for (int c = 0; c < 4; c++) {
+      expected[i * 4 + c] = (fac[i] == 0.0f) ? src2[i * 4 + c] :
+                                               src1[i * 4 + c] * fac[i] +
+                                                   src2[i * 4 + c] * (1 - fac[i]);
+    }
+  }
+  seq_kernel_mix_row_float(src1.data(), src2.data(), result.data(), WIDTH, fac.data());
+  expect_rows_eq(expected, result);
+}
+
+TEST(sequencer_effect_kernels, BlendByte)
+{
+  test_kernel_byte(
+      [](const unsigned char *a, const unsigned char *b, unsigned char *r, int width, float f) {
+        seq_kernel_blend_row_byte(a, b, r, width, f, blend_color_overlay_byte);
+      },
+      [](const unsigned char *a, const unsigned char *b, unsigned char *r, float f) {
+        unsigned char rt1[4];
+        memcpy(rt1, a, 4);
+        rt1[3] = (unsigned int)a[3] * f;
+        blend_color_overlay_byte(r, rt1, b);
+        r[3] = a[3];
+      });
+}
+
+TEST(sequencer_effect_kernels, BlendFloat)
+{
+  test_kernel_float(
+      [](const float *a, const float *b, float *r, int width, float f) {
+        seq_kernel_blend_row_float(a, b, r, width, f, blend_color_overlay_float);
+      },
+      [](const float *a, const float *b, float *r, float f) {
+        float rt1[4];
+        memcpy(rt1, a, sizeof(rt1));
+        rt1[3] = a[3] * f;
+        blend_color_overlay_float(r, rt1, b);
+        r[3] = a[3];
+      });
+}
+
+TEST(sequencer_effect_kernels, ConvertRows)
+{
+  const Array<unsigned char> src = random_byte_pixels(9);
+  Array<float> expected_float(WIDTH * 4), result_float(WIDTH * 4);
+  for (int i = 0; i < WIDTH; i++) {
+    straight_uchar_to_premul_float(&expected_float[i * 4], &src[i * 4]);
+  }
+  seq_kernel_straight_uchar_to_premul_float_row(result_float.data(), src.data(), WIDTH);
+  expect_rows_eq(expected_float, result_float);
+
+  /* Include out of range values, which are clamped. */
+  Array<float> src_float = random_float_pixels(10);
+  src_float[0] = -0.5f;
+  src_float[5] = 2.0f;
+  Array<unsigned char> expected(WIDTH * 4), result(WIDTH * 4);
+  for (int i = 0; i < WIDTH; i++) {
+    premul_float_to_straight_uchar(&expected[i * 4], &src_float[i * 4]);
+  }
+  seq_kernel_premul_float_to_straight_uchar_row(result.data(), src_float.data(), WIDTH);
+  expect_rows_eq(expected, result);
+}
+
+}  // namespace blender::seq::tests
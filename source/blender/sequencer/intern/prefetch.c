@@ -33,9 +33,14 @@
 #include "DNA_sequence_types.h"
 #include "DNA_windowmanager_types.h"
 
+#include "BLI_ghash.h"
 #include "BLI_listbase.h"
+#include "BLI_math_base.h"
+#include "BLI_string.h"
 #include "BLI_threads.h"
 
+#include "PIL_time.h"
+
 #include "IMB_imbuf.h"
 #include "IMB_imbuf_types.h"
 
@@ -59,29 +64,60 @@
 #include "prefetch.h"
 #include "render.h"
 
+/* Upper bound of prefetch workers, each one holds its own evaluated copy of the scene. */
+#define SEQ_PREFETCH_WORKERS_MAX 4
+/* Number of frames past the contiguous prefetched range considered for scheduling.
+ * Must not exceed the number of bits in #PrefetchJob.claimed_frames. */
+#define SEQ_PREFETCH_LOOKAHEAD 16
+/* Cost assumed for strips which were not rendered by prefetch yet. */
+#define SEQ_PREFETCH_DEFAULT_STRIP_COST 1.0f
+
+typedef struct PrefetchWorker {
+  struct PrefetchJob *pfjob;
+
+  struct Scene *scene_eval;
+  struct Depsgraph *depsgraph;
+
+  /* context */
+  struct SeqRenderData context;
+  struct SeqRenderData context_cpy;
+
+  /* Frame which is being rendered by this worker. */
+  int cfra;
+
+  /* control */
+  bool running;
+  bool waiting;
+} PrefetchWorker;
+
 typedef struct PrefetchJob {
   struct PrefetchJob *next, *prev;
 
   struct Main *bmain;
   struct Main *bmain_eval;
   struct Scene *scene;
-  struct Scene *scene_eval;
-  struct Depsgraph *depsgraph;
 
+  /* Protects scheduling state below and is used to suspend workers. */
   ThreadMutex prefetch_suspend_mutex;
   ThreadCondition prefetch_suspend_cond;
 
   ListBase threads;
-
-  /* context */
-  struct SeqRenderData context;
-  struct SeqRenderData context_cpy;
-  struct ListBase *seqbasep;
-  struct ListBase *seqbasep_cpy;
-
-  /* prefetch area */
+  PrefetchWorker workers[SEQ_PREFETCH_WORKERS_MAX];
+  int num_workers;
+
+  /* prefetch area
+   * Written with `prefetch_suspend_mutex` locked. The cache reads it while recycling, which can
+   * happen with `prefetch_suspend_mutex` locked by the same thread, so changes are additionally
+   * guarded by `area_lock`. */
+  SpinLock area_lock;
   float cfra;
+  /* All frames before `cfra + num_frames_prefetched` are rendered or being rendered. */
   int num_frames_prefetched;
+  /* Frames after `cfra + num_frames_prefetched` claimed by workers, one bit per frame. */
+  uint64_t claimed_frames;
+
+  /* Strip name -> estimated render cost, learned from rendered frames. */
+  GHash *strip_costs;
 
   /* control */
   bool running;
@@ -169,8 +205,10 @@ Sequence *BKE_sequencer_prefetch_get_original_sequence(Sequence *seq, Scene *sce
 SeqRenderData *BKE_sequencer_prefetch_get_original_context(const SeqRenderData *context)
 {
   PrefetchJob *pfjob = seq_prefetch_job_get(context->scene);
+  const int worker_index = context->task_id - SEQ_TASK_PREFETCH_RENDER;
 
-  return &pfjob->context;
+  BLI_assert(worker_index >= 0 && worker_index < pfjob->num_workers);
+  return &pfjob->workers[worker_index].context;
 }
 
 static bool seq_prefetch_is_cache_full(Scene *scene)
@@ -188,72 +226,205 @@ static float seq_prefetch_cfra(PrefetchJob *pfjob)
 {
   return pfjob->cfra + pfjob->num_frames_prefetched;
 }
-static AnimationEvalContext seq_prefetch_anim_eval_context(PrefetchJob *pfjob)
+static AnimationEvalContext seq_prefetch_anim_eval_context(PrefetchWorker *worker)
 {
-  return BKE_animsys_eval_context_construct(pfjob->depsgraph, seq_prefetch_cfra(pfjob));
+  return BKE_animsys_eval_context_construct(worker->depsgraph, worker->cfra);
 }
 
 void BKE_sequencer_prefetch_get_time_range(Scene *scene, int *start, int *end)
 {
   PrefetchJob *pfjob = seq_prefetch_job_get(scene);
 
+  BLI_spin_lock(&pfjob->area_lock);
   *start = pfjob->cfra;
   *end = seq_prefetch_cfra(pfjob);
+  const uint64_t claimed_frames = pfjob->claimed_frames;
+  BLI_spin_unlock(&pfjob->area_lock);
+
+  /* Frames claimed out of order must not be recycled either. */
+  for (int i = SEQ_PREFETCH_LOOKAHEAD - 1; i > 0; i--) {
+    if (claimed_frames & ((uint64_t)1 << i)) {
+      *end += i;
+      break;
+    }
+  }
 }
 
-static void seq_prefetch_free_depsgraph(PrefetchJob *pfjob)
+static void seq_prefetch_free_depsgraph(PrefetchWorker *worker)
 {
-  if (pfjob->depsgraph != NULL) {
-    DEG_graph_free(pfjob->depsgraph);
+  if (worker->depsgraph != NULL) {
+    DEG_graph_free(worker->depsgraph);
   }
-  pfjob->depsgraph = NULL;
-  pfjob->scene_eval = NULL;
+  worker->depsgraph = NULL;
+  worker->scene_eval = NULL;
 }
 
-static void seq_prefetch_update_depsgraph(PrefetchJob *pfjob)
+static void seq_prefetch_update_depsgraph(PrefetchWorker *worker)
 {
-  DEG_evaluate_on_framechange(pfjob->depsgraph, seq_prefetch_cfra(pfjob));
+  DEG_evaluate_on_framechange(worker->depsgraph, worker->cfra);
 }
 
-static void seq_prefetch_init_depsgraph(PrefetchJob *pfjob)
+static void seq_prefetch_init_depsgraph(PrefetchWorker *worker)
 {
+  PrefetchJob *pfjob = worker->pfjob;
   Main *bmain = pfjob->bmain_eval;
   Scene *scene = pfjob->scene;
   ViewLayer *view_layer = BKE_view_layer_default_render(scene);
 
-  pfjob->depsgraph = DEG_graph_new(bmain, scene, view_layer, DAG_EVAL_RENDER);
-  DEG_debug_name_set(pfjob->depsgraph, "SEQUENCER PREFETCH");
+  worker->depsgraph = DEG_graph_new(bmain, scene, view_layer, DAG_EVAL_RENDER);
+  DEG_debug_name_set(worker->depsgraph, "SEQUENCER PREFETCH");
 
   /* Make sure there is a correct evaluated scene pointer. */
-  DEG_graph_build_for_render_pipeline(pfjob->depsgraph);
+  DEG_graph_build_for_render_pipeline(worker->depsgraph);
 
   /* Update immediately so we have proper evaluated scene. */
-  seq_prefetch_update_depsgraph(pfjob);
+  worker->cfra = seq_prefetch_cfra(pfjob);
+  seq_prefetch_update_depsgraph(worker);
 
-  pfjob->scene_eval = DEG_get_evaluated_scene(pfjob->depsgraph);
-  pfjob->scene_eval->ed->cache_flag = 0;
+  worker->scene_eval = DEG_get_evaluated_scene(worker->depsgraph);
+  worker->scene_eval->ed->cache_flag = 0;
+}
+
+static void seq_prefetch_claimed_frames_shift(PrefetchJob *pfjob, int delta)
+{
+  if (delta <= 0) {
+    return;
+  }
+  pfjob->claimed_frames = (delta < 64) ? pfjob->claimed_frames >> delta : 0;
+}
+
+/* Move start of the unclaimed range past frames which were claimed out of order. */
+static void seq_prefetch_claimed_frames_normalize(PrefetchJob *pfjob)
+{
+  while (pfjob->claimed_frames & 1) {
+    pfjob->claimed_frames >>= 1;
+    pfjob->num_frames_prefetched++;
+  }
 }
 
 static void seq_prefetch_update_area(PrefetchJob *pfjob)
 {
   int cfra = pfjob->scene->r.cfra;
 
+  BLI_spin_lock(&pfjob->area_lock);
+
   /* rebase */
   if (cfra > pfjob->cfra) {
-    int delta = cfra - pfjob->cfra;
+    const int prefetch_cfra = seq_prefetch_cfra(pfjob);
     pfjob->cfra = cfra;
-    pfjob->num_frames_prefetched -= delta;
-
-    if (pfjob->num_frames_prefetched <= 1) {
-      pfjob->num_frames_prefetched = 1;
-    }
+    pfjob->num_frames_prefetched = max_ii(prefetch_cfra - cfra, 1);
+    seq_prefetch_claimed_frames_shift(pfjob, seq_prefetch_cfra(pfjob) - prefetch_cfra);
+    seq_prefetch_claimed_frames_normalize(pfjob);
   }
 
   /* reset */
   if (cfra < pfjob->cfra) {
     pfjob->cfra = cfra;
     pfjob->num_frames_prefetched = 1;
+    pfjob->claimed_frames = 0;
+  }
+  BLI_spin_unlock(&pfjob->area_lock);
+}
+
+static float seq_prefetch_estimate_frame_cost(PrefetchJob *pfjob, int cfra)
+{
+  Sequence *seq_arr[MAXSEQ + 1];
+  int count = seq_get_shown_sequences(pfjob->scene->ed->seqbasep, cfra, 0, seq_arr);
+  float cost = 0.0f;
+
+  for (int i = 0; i < count; i++) {
+    const float *strip_cost = BLI_ghash_lookup(pfjob->strip_costs, seq_arr[i]->name);
+    cost += strip_cost ? *strip_cost : SEQ_PREFETCH_DEFAULT_STRIP_COST;
+  }
+
+  return cost;
+}
+
+/* Distribute measured cost of rendered frame between strips, that were rendered. */
+static void seq_prefetch_update_strip_costs(PrefetchJob *pfjob, int cfra, float cost)
+{
+  Sequence *seq_arr[MAXSEQ + 1];
+  int count = seq_get_shown_sequences(pfjob->scene->ed->seqbasep, cfra, 0, seq_arr);
+
+  for (int i = 0; i < count; i++) {
+    const float strip_cost = cost / count;
+    float *value = BLI_ghash_lookup(pfjob->strip_costs, seq_arr[i]->name);
+
+    if (value == NULL) {
+      value = MEM_mallocN(sizeof(float), __func__);
+      *value = strip_cost;
+      BLI_ghash_insert(pfjob->strip_costs, BLI_strdup(seq_arr[i]->name), value);
+    }
+    else {
+      *value = (*value + strip_cost) * 0.5f;
+    }
+  }
+}
+
+static bool seq_prefetch_has_unclaimed_frame(PrefetchJob *pfjob)
+{
+  const int prefetch_cfra = seq_prefetch_cfra(pfjob);
+
+  for (int i = 0; i < SEQ_PREFETCH_LOOKAHEAD && prefetch_cfra + i <= pfjob->scene->r.efra; i++) {
+    if ((pfjob->claimed_frames & ((uint64_t)1 << i)) == 0) {
+      return true;
+    }
   }
+  return false;
+}
+
+/* Pick next frame to render. Expensive frames close to the playhead are scheduled first, cheap
+ * frames can be rendered later and still be ready in time.
+ * Must be called with `prefetch_suspend_mutex` locked. */
+static bool seq_prefetch_claim_frame(PrefetchJob *pfjob, int *r_cfra)
+{
+  const int prefetch_cfra = seq_prefetch_cfra(pfjob);
+  int best_index = -1;
+  float best_priority = 0.0f;
+
+  for (int i = 0; i < SEQ_PREFETCH_LOOKAHEAD && prefetch_cfra + i <= pfjob->scene->r.efra; i++) {
+    if (pfjob->claimed_frames & ((uint64_t)1 << i)) {
+      continue;
+    }
+
+    const int cfra = prefetch_cfra + i;
+    const float distance = max_ff(cfra - pfjob->cfra, 1.0f);
+    const float priority = seq_prefetch_estimate_frame_cost(pfjob, cfra) / distance;
+
+    if (best_index == -1 || priority > best_priority) {
+      best_index = i;
+      best_priority = priority;
+    }
+  }
+
+  if (best_index == -1) {
+    return false;
+  }
+
+  *r_cfra = prefetch_cfra + best_index;
+  BLI_spin_lock(&pfjob->area_lock);
+  pfjob->claimed_frames |= (uint64_t)1 << best_index;
+  seq_prefetch_claimed_frames_normalize(pfjob);
+  BLI_spin_unlock(&pfjob->area_lock);
+  return true;
+}
+
+/* Must be called with `prefetch_suspend_mutex` locked. */
+static void seq_prefetch_update_job_state(PrefetchJob *pfjob)
+{
+  bool running = false;
+  bool waiting = true;
+
+  for (int i = 0; i < pfjob->num_workers; i++) {
+    PrefetchWorker *worker = &pfjob->workers[i];
+    if (worker->running) {
+      running = true;
+      waiting &= worker->waiting;
+    }
+  }
+
+  pfjob->waiting = running && waiting;
+  pfjob->running = running;
 }
 
 void BKE_sequencer_prefetch_stop_all(void)
@@ -279,41 +450,42 @@ void BKE_sequencer_prefetch_stop(Scene *scene)
   pfjob->stop = true;
 
   while (pfjob->running) {
-    BLI_condition_notify_one(&pfjob->prefetch_suspend_cond);
+    BLI_condition_notify_all(&pfjob->prefetch_suspend_cond);
   }
 }
 
-static void seq_prefetch_update_context(const SeqRenderData *context)
+static void seq_prefetch_update_context(const SeqRenderData *context, PrefetchWorker *worker)
 {
-  PrefetchJob *pfjob;
-  pfjob = seq_prefetch_job_get(context->scene);
+  PrefetchJob *pfjob = worker->pfjob;
+  const eSeqTaskId task_id = SEQ_TASK_PREFETCH_RENDER + (int)(worker - pfjob->workers);
 
   SEQ_render_new_render_data(pfjob->bmain_eval,
-                             pfjob->depsgraph,
-                             pfjob->scene_eval,
+                             worker->depsgraph,
+                             worker->scene_eval,
                              context->rectx,
                              context->recty,
                              context->preview_render_size,
                              false,
-                             &pfjob->context_cpy);
-  pfjob->context_cpy.is_prefetch_render = true;
-  pfjob->context_cpy.task_id = SEQ_TASK_PREFETCH_RENDER;
+                             &worker->context_cpy);
+  worker->context_cpy.is_prefetch_render = true;
+  worker->context_cpy.is_isolated_render = true;
+  worker->context_cpy.task_id = task_id;
 
   SEQ_render_new_render_data(pfjob->bmain,
-                             pfjob->depsgraph,
+                             worker->depsgraph,
                              pfjob->scene,
                              context->rectx,
                              context->recty,
                              context->preview_render_size,
                              false,
-                             &pfjob->context);
-  pfjob->context.is_prefetch_render = false;
+                             &worker->context);
+  worker->context.is_prefetch_render = false;
 
   /* Same ID as prefetch context, because context will be swapped, but we still
    * want to assign this ID to cache entries created in this thread.
    * This is to allow "temp cache" work correctly for both threads.
    */
-  pfjob->context.task_id = SEQ_TASK_PREFETCH_RENDER;
+  worker->context.task_id = task_id;
 }
 
 static void seq_prefetch_update_scene(Scene *scene)
@@ -325,16 +497,18 @@ static void seq_prefetch_update_scene(Scene *scene)
   }
 
   pfjob->scene = scene;
-  seq_prefetch_free_depsgraph(pfjob);
-  seq_prefetch_init_depsgraph(pfjob);
+  for (int i = 0; i < pfjob->num_workers; i++) {
+    seq_prefetch_free_depsgraph(&pfjob->workers[i]);
+    seq_prefetch_init_depsgraph(&pfjob->workers[i]);
+  }
 }
 
 static void seq_prefetch_resume(Scene *scene)
 {
   PrefetchJob *pfjob = seq_prefetch_job_get(scene);
 
-  if (pfjob && pfjob->waiting) {
-    BLI_condition_notify_one(&pfjob->prefetch_suspend_cond);
+  if (pfjob && pfjob->running) {
+    BLI_condition_notify_all(&pfjob->prefetch_suspend_cond);
   }
 }
 
@@ -347,24 +521,29 @@ void BKE_sequencer_prefetch_free(Scene *scene)
 
   BKE_sequencer_prefetch_stop(scene);
 
-  BLI_threadpool_remove(&pfjob->threads, pfjob);
+  for (int i = 0; i < pfjob->num_workers; i++) {
+    BLI_threadpool_remove(&pfjob->threads, &pfjob->workers[i]);
+  }
   BLI_threadpool_end(&pfjob->threads);
   BLI_mutex_end(&pfjob->prefetch_suspend_mutex);
   BLI_condition_end(&pfjob->prefetch_suspend_cond);
-  seq_prefetch_free_depsgraph(pfjob);
+  BLI_spin_end(&pfjob->area_lock);
+  for (int i = 0; i < pfjob->num_workers; i++) {
+    seq_prefetch_free_depsgraph(&pfjob->workers[i]);
+  }
+  BLI_ghash_free(pfjob->strip_costs, MEM_freeN, MEM_freeN);
   BKE_main_free(pfjob->bmain_eval);
   MEM_freeN(pfjob);
   scene->ed->prefetch_job = NULL;
 }
 
-static bool seq_prefetch_do_skip_frame(Scene *scene)
+static bool seq_prefetch_do_skip_frame(PrefetchWorker *worker)
 {
-  Editing *ed = scene->ed;
-  PrefetchJob *pfjob = seq_prefetch_job_get(scene);
-  float cfra = seq_prefetch_cfra(pfjob);
+  Editing *ed = worker->pfjob->scene->ed;
+  float cfra = worker->cfra;
   Sequence *seq_arr[MAXSEQ + 1];
   int count = seq_get_shown_sequences(ed->seqbasep, cfra, 0, seq_arr);
-  SeqRenderData *ctx = &pfjob->context_cpy;
+  SeqRenderData *ctx = &worker->context_cpy;
   ImBuf *ibuf = NULL;
 
   /* Disable prefetching 3D scene strips, but check for disk cache. */
@@ -417,37 +596,60 @@ static bool seq_prefetch_do_skip_frame(Scene *scene)
   return false;
 }
 
+/* Must be called with `prefetch_suspend_mutex` locked. */
 static bool seq_prefetch_need_suspend(PrefetchJob *pfjob)
 {
   return seq_prefetch_is_cache_full(pfjob->scene) || seq_prefetch_is_scrubbing(pfjob->bmain) ||
-         (seq_prefetch_cfra(pfjob) >= pfjob->scene->r.efra);
+         !seq_prefetch_has_unclaimed_frame(pfjob);
 }
 
-static void seq_prefetch_do_suspend(PrefetchJob *pfjob)
+static void seq_prefetch_do_suspend(PrefetchWorker *worker)
 {
+  PrefetchJob *pfjob = worker->pfjob;
+
   BLI_mutex_lock(&pfjob->prefetch_suspend_mutex);
+  seq_prefetch_update_area(pfjob);
   while (seq_prefetch_need_suspend(pfjob) &&
          (pfjob->scene->ed->cache_flag & SEQ_CACHE_PREFETCH_ENABLE) && !pfjob->stop) {
-    pfjob->waiting = true;
+    worker->waiting = true;
+    seq_prefetch_update_job_state(pfjob);
     BLI_condition_wait(&pfjob->prefetch_suspend_cond, &pfjob->prefetch_suspend_mutex);
     seq_prefetch_update_area(pfjob);
   }
-  pfjob->waiting = false;
+  worker->waiting = false;
+  seq_prefetch_update_job_state(pfjob);
   BLI_mutex_unlock(&pfjob->prefetch_suspend_mutex);
 }
 
-static void *seq_prefetch_frames(void *job)
+static void *seq_prefetch_frames(void *data)
 {
-  PrefetchJob *pfjob = (PrefetchJob *)job;
+  PrefetchWorker *worker = (PrefetchWorker *)data;
+  PrefetchJob *pfjob = worker->pfjob;
+
+  while (true) {
+    /* Suspend thread if there is nothing to be prefetched. */
+    seq_prefetch_do_suspend(worker);
+
+    if (!(pfjob->scene->ed->cache_flag & SEQ_CACHE_PREFETCH_ENABLE) || pfjob->stop) {
+      break;
+    }
 
-  while (seq_prefetch_cfra(pfjob) <= pfjob->scene->r.efra) {
-    pfjob->scene_eval->ed->prefetch_job = NULL;
+    BLI_mutex_lock(&pfjob->prefetch_suspend_mutex);
+    const bool has_frame = seq_prefetch_claim_frame(pfjob, &worker->cfra);
+    BLI_mutex_unlock(&pfjob->prefetch_suspend_mutex);
 
-    seq_prefetch_update_depsgraph(pfjob);
-    AnimData *adt = BKE_animdata_from_id(&pfjob->context_cpy.scene->id);
-    AnimationEvalContext anim_eval_context = seq_prefetch_anim_eval_context(pfjob);
+    /* Remaining frames are rendered by other workers. */
+    if (!has_frame) {
+      continue;
+    }
+
+    worker->scene_eval->ed->prefetch_job = NULL;
+
+    seq_prefetch_update_depsgraph(worker);
+    AnimData *adt = BKE_animdata_from_id(&worker->context_cpy.scene->id);
+    AnimationEvalContext anim_eval_context = seq_prefetch_anim_eval_context(worker);
     BKE_animsys_evaluate_animdata(
-        &pfjob->context_cpy.scene->id, adt, &anim_eval_context, ADT_RECALC_ALL, false);
+        &worker->context_cpy.scene->id, adt, &anim_eval_context, ADT_RECALC_ALL, false);
 
     /* This is quite hacky solution:
      * We need cross-reference original scene with copy for cache.
@@ -455,43 +657,50 @@ static void *seq_prefetch_frames(void *job)
      * Scene copy don't reference original scene. Perhaps, this could be done by depsgraph.
      * Set to NULL before return!
      */
-    pfjob->scene_eval->ed->prefetch_job = pfjob;
+    worker->scene_eval->ed->prefetch_job = pfjob;
 
-    if (seq_prefetch_do_skip_frame(pfjob->scene)) {
-      pfjob->num_frames_prefetched++;
+    if (seq_prefetch_do_skip_frame(worker)) {
       continue;
     }
 
-    ImBuf *ibuf = SEQ_render_give_ibuf(&pfjob->context_cpy, seq_prefetch_cfra(pfjob), 0);
-    BKE_sequencer_cache_free_temp_cache(
-        pfjob->scene, pfjob->context.task_id, seq_prefetch_cfra(pfjob));
+    const double time_begin = PIL_check_seconds_timer();
+    ImBuf *ibuf = SEQ_render_give_ibuf(&worker->context_cpy, worker->cfra, 0);
+    const double time_spent = PIL_check_seconds_timer() - time_begin;
+    BKE_sequencer_cache_free_temp_cache(pfjob->scene, worker->context.task_id, worker->cfra);
     IMB_freeImBuf(ibuf);
 
-    /* Suspend thread if there is nothing to be prefetched. */
-    seq_prefetch_do_suspend(pfjob);
+    /* Cost is render time divided by playback frame duration, same as cache uses. */
+    const float frame_duration = pfjob->scene->r.frs_sec_base / pfjob->scene->r.frs_sec;
+    BLI_mutex_lock(&pfjob->prefetch_suspend_mutex);
+    seq_prefetch_update_strip_costs(pfjob, worker->cfra, (float)time_spent / frame_duration);
+    BLI_mutex_unlock(&pfjob->prefetch_suspend_mutex);
 
     /* Avoid "collision" with main thread, but make sure to fetch at least few frames */
-    if (pfjob->num_frames_prefetched > 5 &&
-        (seq_prefetch_cfra(pfjob) - pfjob->scene->r.cfra) < 2) {
-      break;
-    }
-
-    if (!(pfjob->scene->ed->cache_flag & SEQ_CACHE_PREFETCH_ENABLE) || pfjob->stop) {
+    BLI_spin_lock(&pfjob->area_lock);
+    const int num_frames_prefetched = pfjob->num_frames_prefetched;
+    BLI_spin_unlock(&pfjob->area_lock);
+    if (num_frames_prefetched > 5 && (worker->cfra - pfjob->scene->r.cfra) < 2) {
       break;
     }
-
-    seq_prefetch_update_area(pfjob);
-    pfjob->num_frames_prefetched++;
   }
 
-  BKE_sequencer_cache_free_temp_cache(
-      pfjob->scene, pfjob->context.task_id, seq_prefetch_cfra(pfjob));
-  pfjob->running = false;
-  pfjob->scene_eval->ed->prefetch_job = NULL;
+  BKE_sequencer_cache_free_temp_cache(pfjob->scene, worker->context.task_id, worker->cfra);
+  worker->scene_eval->ed->prefetch_job = NULL;
+
+  BLI_mutex_lock(&pfjob->prefetch_suspend_mutex);
+  worker->running = false;
+  seq_prefetch_update_job_state(pfjob);
+  BLI_mutex_unlock(&pfjob->prefetch_suspend_mutex);
 
   return NULL;
 }
 
+static int seq_prefetch_workers_num(void)
+{
+  /* Effects are multi-threaded on their own, leave some threads for them. */
+  return clamp_i(BLI_system_thread_count() / 2, 1, SEQ_PREFETCH_WORKERS_MAX);
+}
+
 static PrefetchJob *seq_prefetch_start(const SeqRenderData *context, float cfra)
 {
   PrefetchJob *pfjob = seq_prefetch_job_get(context->scene);
@@ -501,29 +710,43 @@ static PrefetchJob *seq_prefetch_start(const SeqRenderData *context, float cfra)
       pfjob = (PrefetchJob *)MEM_callocN(sizeof(PrefetchJob), "PrefetchJob");
       context->scene->ed->prefetch_job = pfjob;
 
-      BLI_threadpool_init(&pfjob->threads, seq_prefetch_frames, 1);
+      pfjob->num_workers = seq_prefetch_workers_num();
+      BLI_threadpool_init(&pfjob->threads, seq_prefetch_frames, pfjob->num_workers);
       BLI_mutex_init(&pfjob->prefetch_suspend_mutex);
       BLI_condition_init(&pfjob->prefetch_suspend_cond);
+      BLI_spin_init(&pfjob->area_lock);
+      pfjob->strip_costs = BLI_ghash_str_new(__func__);
 
       pfjob->bmain_eval = BKE_main_new();
       pfjob->scene = context->scene;
-      seq_prefetch_init_depsgraph(pfjob);
+      for (int i = 0; i < pfjob->num_workers; i++) {
+        pfjob->workers[i].pfjob = pfjob;
+        seq_prefetch_init_depsgraph(&pfjob->workers[i]);
+      }
     }
   }
   pfjob->bmain = context->bmain;
 
   pfjob->cfra = cfra;
   pfjob->num_frames_prefetched = 1;
+  pfjob->claimed_frames = 0;
 
   pfjob->waiting = false;
   pfjob->stop = false;
   pfjob->running = true;
 
   seq_prefetch_update_scene(context->scene);
-  seq_prefetch_update_context(context);
 
-  BLI_threadpool_remove(&pfjob->threads, pfjob);
-  BLI_threadpool_insert(&pfjob->threads, pfjob);
+  for (int i = 0; i < pfjob->num_workers; i++) {
+    PrefetchWorker *worker = &pfjob->workers[i];
+
+    seq_prefetch_update_context(context, worker);
+    worker->running = true;
+    worker->waiting = false;
+
+    BLI_threadpool_remove(&pfjob->threads, worker);
+    BLI_threadpool_insert(&pfjob->threads, worker);
+  }
 
   return pfjob;
 }
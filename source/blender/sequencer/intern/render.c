@@ -255,6 +255,7 @@ void SEQ_render_new_render_data(Main *bmain,
   r_context->gpu_offscreen = NULL;
   r_context->task_id = SEQ_TASK_MAIN_RENDER;
   r_context->is_prefetch_render = false;
+  r_context->is_isolated_render = false;
 }
 
 void seq_render_state_init(SeqRenderState *state)
@@ -864,6 +865,20 @@ ImBuf *seq_render_effect_execute_threaded(struct SeqEffectHandle *sh,
   return out;
 }
 
+/**
+ * Effects convert their inputs to the sequencer color space in place, see
+ * #prepare_effect_imbufs. Buffers from the shared image file cache are also used by other strips,
+ * images and prefetch workers, so those are replaced by a private copy first. Takes over the
+ * reference of the passed buffer.
+ */
+static ImBuf *seq_effect_input_ensure_writable(ImBuf *ibuf)
+{
+  if (ibuf != NULL && (ibuf->userflags & IB_SHARED)) {
+    ibuf = IMB_makeSingleUser(ibuf);
+  }
+  return ibuf;
+}
+
 static ImBuf *seq_render_effect_strip_impl(const SeqRenderData *context,
                                            SeqRenderState *state,
                                            Sequence *seq,
@@ -924,6 +939,7 @@ static ImBuf *seq_render_effect_strip_impl(const SeqRenderData *context,
             ibuf[i] = seq_render_strip(context, state, input[i], timeline_frame);
           }
         }
+        ibuf[i] = seq_effect_input_ensure_writable(ibuf[i]);
       }
 
       if (ibuf[0] && (ibuf[1] || BKE_sequence_effect_get_num_inputs(seq->type) == 1)) {
@@ -982,19 +998,28 @@ static ImBuf *seq_render_image_strip_view(const SeqRenderData *context,
   }
 
   if (prefix[0] == '\0') {
-    ibuf = IMB_loadiffname(name, flag, seq->strip->colorspace_settings.name);
+    ibuf = IMB_loadiffname_shared(name, flag, seq->strip->colorspace_settings.name);
   }
   else {
     char str[FILE_MAX];
     BKE_scene_multiview_view_prefix_get(context->scene, name, prefix, &ext);
     seq_multiview_name(context->scene, view_id, prefix, ext, str, FILE_MAX);
-    ibuf = IMB_loadiffname(str, flag, seq->strip->colorspace_settings.name);
+    ibuf = IMB_loadiffname_shared(str, flag, seq->strip->colorspace_settings.name);
   }
 
   if (ibuf == NULL) {
     return NULL;
   }
 
+  /* The loaded buffer may be shared with other users, convert a copy of it. Byte buffers which
+   * already are in the sequencer color space are used as they are, preprocessing and effects copy
+   * them before modifying them in place. */
+  if (ibuf->rect_float != NULL ||
+      !STREQ(IMB_colormanagement_get_rect_colorspace(ibuf),
+             context->scene->sequencer_colorspace_settings.name)) {
+    ibuf = IMB_makeSingleUser(ibuf);
+  }
+
   /* We don't need both (speed reasons)! */
   if (ibuf->rect_float != NULL && ibuf->rect != NULL) {
     imb_freerectImBuf(ibuf);
@@ -1954,7 +1979,8 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
           begin = seq_estimate_render_cost_begin();
 
           ImBuf *ibuf1 = IMB_allocImBuf(context->rectx, context->recty, 32, IB_rect);
-          ImBuf *ibuf2 = seq_render_strip(context, state, seq, timeline_frame);
+          ImBuf *ibuf2 = seq_effect_input_ensure_writable(
+              seq_render_strip(context, state, seq, timeline_frame));
 
           out = seq_render_strip_stack_apply_effect(context, seq, timeline_frame, ibuf1, ibuf2);
 
@@ -1978,8 +2004,9 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
     Sequence *seq = seq_arr[i];
 
     if (seq_get_early_out_for_blend_mode(seq) == EARLY_DO_EFFECT) {
-      ImBuf *ibuf1 = out;
-      ImBuf *ibuf2 = seq_render_strip(context, state, seq, timeline_frame);
+      ImBuf *ibuf1 = seq_effect_input_ensure_writable(out);
+      ImBuf *ibuf2 = seq_effect_input_ensure_writable(
+          seq_render_strip(context, state, seq, timeline_frame));
 
       out = seq_render_strip_stack_apply_effect(context, seq, timeline_frame, ibuf1, ibuf2);
 
@@ -2038,7 +2065,12 @@ ImBuf *SEQ_render_give_ibuf(const SeqRenderData *context, float timeline_frame,
   float cost = 0;
 
   if (count && !out) {
-    BLI_mutex_lock(&seq_render_mutex);
+    /* Prefetch and render pool workers render their own evaluated copy of the scene, so they
+     * share no strip data with other threads. The cache has its own lock. */
+    const bool use_render_mutex = !context->is_isolated_render;
+    if (use_render_mutex) {
+      BLI_mutex_lock(&seq_render_mutex);
+    }
     out = seq_render_strip_stack(context, &state, seqbasep, timeline_frame, chanshown);
     cost = seq_estimate_render_cost_end(context->scene, begin);
 
@@ -2060,7 +2092,9 @@ ImBuf *SEQ_render_give_ibuf(const SeqRenderData *context, float timeline_frame,
                                           cost,
                                           false);
     }
-    BLI_mutex_unlock(&seq_render_mutex);
+    if (use_render_mutex) {
+      BLI_mutex_unlock(&seq_render_mutex);
+    }
   }
 
   BKE_sequencer_prefetch_start(context, timeline_frame, cost);
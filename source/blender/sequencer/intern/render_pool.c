@@ -0,0 +1,340 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup sequencer
+ *
+ * Render pool renders consecutive frames of final (animation) render in parallel.
+ *
+ * Each worker evaluates its own copy of the scene, so strips, movie decoders and cache are
+ * private to the worker and no locking is needed while rendering. Workers claim frames in
+ * contiguous chunks, so movie decoders read their input sequentially. Rendered frames are
+ * handed to the render pipeline in order by #SEQ_render_pool_acquire.
+ */
+
+#include <string.h>
+
+#include "MEM_guardedalloc.h"
+
+#include "DNA_anim_types.h"
+#include "DNA_scene_types.h"
+#include "DNA_sequence_types.h"
+#include "DNA_space_types.h"
+
+#include "BLI_listbase.h"
+#include "BLI_math_base.h"
+#include "BLI_threads.h"
+
+#include "IMB_imbuf.h"
+#include "IMB_imbuf_types.h"
+#include "IMB_metadata.h"
+
+#include "BKE_anim_data.h"
+#include "BKE_animsys.h"
+#include "BKE_layer.h"
+#include "BKE_main.h"
+#include "BKE_scene.h"
+
+#include "DEG_depsgraph.h"
+#include "DEG_depsgraph_build.h"
+#include "DEG_depsgraph_debug.h"
+#include "DEG_depsgraph_query.h"
+
+#include "SEQ_sequencer.h"
+
+/* Upper bound of workers, each one holds its own evaluated copy of the scene. */
+#define SEQ_RENDER_POOL_WORKERS_MAX 8
+/* Number of consecutive frames claimed by worker at once. */
+#define SEQ_RENDER_POOL_CHUNK_SIZE 8
+/* Number of rendered frames that can wait for being written, per worker. */
+#define SEQ_RENDER_POOL_FRAMES_AHEAD 4
+
+typedef struct SeqRenderPoolFrame {
+  /* One buffer per view, NULL when nothing was rendered. */
+  struct ImBuf **ibuf_arr;
+  bool is_done;
+} SeqRenderPoolFrame;
+
+typedef struct SeqRenderPoolWorker {
+  struct SeqRenderPool *pool;
+
+  struct Depsgraph *depsgraph;
+  struct Scene *scene_eval;
+  SeqRenderData context;
+} SeqRenderPoolWorker;
+
+typedef struct SeqRenderPool {
+  ListBase threads;
+  SeqRenderPoolWorker workers[SEQ_RENDER_POOL_WORKERS_MAX];
+  int num_workers;
+
+  /* Protects all members below. */
+  ThreadMutex mutex;
+  /* Notified when frame is rendered or acquired. */
+  ThreadCondition cond;
+
+  int sfra;
+  int frame_step;
+  int tot_views;
+
+  SeqRenderPoolFrame *frames;
+  int tot_frames;
+  /* First frame which was not claimed by any worker. */
+  int next_frame_index;
+  /* First frame which was not handed over to the render pipeline. */
+  int acquired_frame_index;
+  int max_frames_ahead;
+
+  bool stop;
+} SeqRenderPool;
+
+static bool seq_render_pool_check_seqbase(ListBase *seqbase)
+{
+  LISTBASE_FOREACH (Sequence *, seq, seqbase) {
+    /* Scene strips go through render pipeline of another scene, which is not thread safe. */
+    if (seq->type == SEQ_TYPE_SCENE) {
+      return false;
+    }
+    if (seq->type == SEQ_TYPE_META && !seq_render_pool_check_seqbase(&seq->seqbase)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Check if render pool can be used to render sequencer of given scene. */
+bool SEQ_render_pool_is_supported(Scene *scene)
+{
+  if (scene->ed == NULL) {
+    return false;
+  }
+  if (BLI_system_thread_count() < 2) {
+    return false;
+  }
+  return seq_render_pool_check_seqbase(&scene->ed->seqbase);
+}
+
+static void seq_render_pool_frame_free(SeqRenderPool *pool, SeqRenderPoolFrame *frame)
+{
+  if (frame->ibuf_arr == NULL) {
+    return;
+  }
+  for (int view_id = 0; view_id < pool->tot_views; view_id++) {
+    if (frame->ibuf_arr[view_id]) {
+      IMB_freeImBuf(frame->ibuf_arr[view_id]);
+    }
+  }
+  MEM_freeN(frame->ibuf_arr);
+  frame->ibuf_arr = NULL;
+}
+
+static void seq_render_pool_render_frame(SeqRenderPoolWorker *worker, int frame_index)
+{
+  SeqRenderPool *pool = worker->pool;
+  const int timeline_frame = pool->sfra + frame_index * pool->frame_step;
+  Scene *scene_eval = worker->scene_eval;
+
+  DEG_evaluate_on_framechange(worker->depsgraph, timeline_frame);
+  AnimData *adt = BKE_animdata_from_id(&scene_eval->id);
+  const AnimationEvalContext anim_eval_context = BKE_animsys_eval_context_construct(
+      worker->depsgraph, timeline_frame);
+  BKE_animsys_evaluate_animdata(&scene_eval->id, adt, &anim_eval_context, ADT_RECALC_ALL, false);
+  /* Evaluated scene is not updated by time source, but freeing of strip data relies on it. */
+  scene_eval->r.cfra = timeline_frame;
+
+  ImBuf **ibuf_arr = MEM_callocN(sizeof(ImBuf *) * pool->tot_views, "Render Pool ImBufs");
+  for (int view_id = 0; view_id < pool->tot_views; view_id++) {
+    worker->context.view_id = view_id;
+    ImBuf *out = SEQ_render_give_ibuf(&worker->context, timeline_frame, 0);
+
+    if (out) {
+      ibuf_arr[view_id] = IMB_dupImBuf(out);
+      IMB_metadata_copy(ibuf_arr[view_id], out);
+      IMB_freeImBuf(out);
+    }
+  }
+
+  /* Same as render pipeline does after each frame. */
+  BKE_sequencer_free_imbuf(scene_eval, &scene_eval->ed->seqbase, true);
+
+  BLI_mutex_lock(&pool->mutex);
+  pool->frames[frame_index].ibuf_arr = ibuf_arr;
+  pool->frames[frame_index].is_done = true;
+  /* Frame could have been skipped by render pipeline in the meantime. */
+  if (frame_index < pool->acquired_frame_index) {
+    seq_render_pool_frame_free(pool, &pool->frames[frame_index]);
+  }
+  BLI_condition_notify_all(&pool->cond);
+  BLI_mutex_unlock(&pool->mutex);
+}
+
+static void *seq_render_pool_worker_run(void *data)
+{
+  SeqRenderPoolWorker *worker = (SeqRenderPoolWorker *)data;
+  SeqRenderPool *pool = worker->pool;
+
+  BLI_mutex_lock(&pool->mutex);
+  while (!pool->stop && pool->next_frame_index < pool->tot_frames) {
+    /* Don't run too far ahead of the output writer to keep memory usage bounded. */
+    if (pool->next_frame_index >= pool->acquired_frame_index + pool->max_frames_ahead) {
+      BLI_condition_wait(&pool->cond, &pool->mutex);
+      continue;
+    }
+
+    const int start = max_ii(pool->next_frame_index, pool->acquired_frame_index);
+    const int end = min_ii(start + SEQ_RENDER_POOL_CHUNK_SIZE, pool->tot_frames);
+    pool->next_frame_index = end;
+    BLI_mutex_unlock(&pool->mutex);
+
+    for (int frame_index = start; frame_index < end && !pool->stop; frame_index++) {
+      seq_render_pool_render_frame(worker, frame_index);
+    }
+
+    BLI_mutex_lock(&pool->mutex);
+  }
+  BLI_mutex_unlock(&pool->mutex);
+
+  return NULL;
+}
+
+static void seq_render_pool_worker_init(
+    SeqRenderPoolWorker *worker, Main *bmain, Scene *scene, int rectx, int recty)
+{
+  ViewLayer *view_layer = BKE_view_layer_default_render(scene);
+
+  worker->depsgraph = DEG_graph_new(bmain, scene, view_layer, DAG_EVAL_RENDER);
+  DEG_debug_name_set(worker->depsgraph, "SEQUENCER RENDER POOL");
+  DEG_graph_build_for_render_pipeline(worker->depsgraph);
+  DEG_evaluate_on_framechange(worker->depsgraph, scene->r.cfra);
+  worker->scene_eval = DEG_get_evaluated_scene(worker->depsgraph);
+
+  SEQ_render_new_render_data(bmain,
+                             worker->depsgraph,
+                             worker->scene_eval,
+                             rectx,
+                             recty,
+                             SEQ_RENDER_SIZE_SCENE,
+                             true,
+                             &worker->context);
+  worker->context.is_isolated_render = true;
+}
+
+/**
+ * Start rendering frames `sfra` to `efra` in background threads.
+ * Depsgraphs are built here, so this must be called from the main thread.
+ */
+SeqRenderPool *SEQ_render_pool_create(
+    Main *bmain, Scene *scene, int rectx, int recty, int sfra, int efra, int frame_step)
+{
+  SeqRenderPool *pool = MEM_callocN(sizeof(SeqRenderPool), "SeqRenderPool");
+
+  pool->sfra = sfra;
+  pool->frame_step = max_ii(frame_step, 1);
+  pool->tot_frames = max_ii((efra - sfra) / pool->frame_step + 1, 0);
+  pool->tot_views = BKE_scene_multiview_num_views_get(&scene->r);
+  pool->frames = MEM_callocN(sizeof(SeqRenderPoolFrame) * max_ii(pool->tot_frames, 1),
+                             "SeqRenderPoolFrame");
+
+  /* Each effect is multi-threaded on its own too, leave some threads for them. */
+  pool->num_workers = clamp_i(BLI_system_thread_count() / 2, 1, SEQ_RENDER_POOL_WORKERS_MAX);
+  /* Every worker can have one chunk in flight, plus some rendered frames waiting for the
+   * output writer, so that workers don't stall while the writer catches up. */
+  pool->max_frames_ahead = pool->num_workers *
+                           (SEQ_RENDER_POOL_CHUNK_SIZE + SEQ_RENDER_POOL_FRAMES_AHEAD);
+
+  BLI_mutex_init(&pool->mutex);
+  BLI_condition_init(&pool->cond);
+  BLI_threadpool_init(&pool->threads, seq_render_pool_worker_run, pool->num_workers);
+
+  for (int i = 0; i < pool->num_workers; i++) {
+    SeqRenderPoolWorker *worker = &pool->workers[i];
+    worker->pool = pool;
+    seq_render_pool_worker_init(worker, bmain, scene, rectx, recty);
+  }
+  for (int i = 0; i < pool->num_workers; i++) {
+    BLI_threadpool_insert(&pool->threads, &pool->workers[i]);
+  }
+
+  return pool;
+}
+
+/**
+ * Get rendered views of `timeline_frame`, waiting for workers if needed.
+ * Frames must be acquired in increasing order, skipped frames are discarded.
+ *
+ * \param r_ibuf_arr: Array of one buffer per view, ownership is passed to the caller.
+ * \return false when frame is not rendered by this pool, caller should render it directly.
+ */
+bool SEQ_render_pool_acquire(SeqRenderPool *pool, int timeline_frame, ImBuf **r_ibuf_arr)
+{
+  const int offset = timeline_frame - pool->sfra;
+  if (offset < 0 || offset % pool->frame_step != 0) {
+    return false;
+  }
+  const int frame_index = offset / pool->frame_step;
+  if (frame_index < pool->acquired_frame_index || frame_index >= pool->tot_frames) {
+    return false;
+  }
+
+  BLI_mutex_lock(&pool->mutex);
+
+  /* Discard frames which render pipeline has skipped. */
+  for (int i = pool->acquired_frame_index; i < frame_index; i++) {
+    seq_render_pool_frame_free(pool, &pool->frames[i]);
+  }
+  pool->acquired_frame_index = frame_index;
+  BLI_condition_notify_all(&pool->cond);
+
+  SeqRenderPoolFrame *frame = &pool->frames[frame_index];
+  while (!frame->is_done) {
+    BLI_condition_wait(&pool->cond, &pool->mutex);
+  }
+
+  memcpy(r_ibuf_arr, frame->ibuf_arr, sizeof(ImBuf *) * pool->tot_views);
+  MEM_freeN(frame->ibuf_arr);
+  frame->ibuf_arr = NULL;
+
+  pool->acquired_frame_index = frame_index + 1;
+  BLI_condition_notify_all(&pool->cond);
+  BLI_mutex_unlock(&pool->mutex);
+
+  return true;
+}
+
+void SEQ_render_pool_free(SeqRenderPool *pool)
+{
+  BLI_mutex_lock(&pool->mutex);
+  pool->stop = true;
+  BLI_condition_notify_all(&pool->cond);
+  BLI_mutex_unlock(&pool->mutex);
+
+  BLI_threadpool_end(&pool->threads);
+
+  for (int i = 0; i < pool->tot_frames; i++) {
+    seq_render_pool_frame_free(pool, &pool->frames[i]);
+  }
+  for (int i = 0; i < pool->num_workers; i++) {
+    DEG_graph_free(pool->workers[i].depsgraph);
+  }
+
+  BLI_condition_end(&pool->cond);
+  BLI_mutex_end(&pool->mutex);
+  MEM_freeN(pool->frames);
+  MEM_freeN(pool);
+}
@@ -0,0 +1,177 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 by Blender Foundation.
+ */
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BKE_appdir.h"
+#include "BKE_idtype.h"
+#include "BKE_main.h"
+#include "BKE_scene.h"
+
+#include "BLI_fileops.h"
+#include "BLI_path_util.h"
+#include "BLI_string.h"
+#include "BLI_threads.h"
+
+#include "DNA_scene_types.h"
+#include "DNA_sequence_types.h"
+#include "DNA_space_types.h"
+
+#include "IMB_colormanagement.h"
+#include "IMB_imbuf.h"
+#include "IMB_imbuf_types.h"
+
+#include "SEQ_sequencer.h"
+
+#include "CLG_log.h"
+
+namespace blender::seq::tests {
+
+class SequencerSharedImageTest : public testing::Test {
+ protected:
+  Main *bmain = nullptr;
+  Scene *scene = nullptr;
+  char filepath[FILE_MAX];
+  char colorspace[MAX_COLORSPACE_NAME];
+
+  static void SetUpTestCase()
+  {
+    CLG_init();
+    BLI_threadapi_init();
+    BKE_idtype_init();
+    BKE_appdir_init();
+    BKE_tempdir_init(nullptr);
+    IMB_init();
+  }
+
+  static void TearDownTestCase()
+  {
+    IMB_exit();
+    BKE_tempdir_session_purge();
+    BLI_threadapi_exit();
+    CLG_exit();
+  }
+
+  void SetUp() override
+  {
+    BLI_join_dirfile(filepath, sizeof(filepath), BKE_tempdir_session(), "seq_shared_test.png");
+
+    /* A small byte image with every pixel set to the same color. */
+    ImBuf *ibuf = IMB_allocImBuf(4, 4, 32, IB_rect);
+    const float color[4] = {0.25f, 0.5f, 0.75f, 1.0f};
+    IMB_rectfill(ibuf, color);
+    ibuf->ftype = IMB_FTYPE_PNG;
+    ASSERT_TRUE(IMB_saveiff(ibuf, filepath, IB_rect));
+    IMB_freeImBuf(ibuf);
+
+    bmain = BKE_main_new();
+    scene = BKE_scene_add(bmain, "Scene");
+    scene->r.xsch = 4;
+    scene->r.ysch = 4;
+    scene->r.size = 100;
+    scene->r.cfra = 1;
+
+    /* Strip buffers in the sequencer color space are used without a conversion, so they stay
+     * shared until something modifies them. */
+    STRNCPY(colorspace, IMB_colormanagement_role_colorspace_name_get(COLOR_ROLE_DEFAULT_BYTE));
+    STRNCPY(scene->sequencer_colorspace_settings.name, colorspace);
+
+    BKE_sequencer_editing_get(scene, true);
+  }
+
+  void TearDown() override
+  {
+    BKE_main_free(bmain);
+    BLI_delete(filepath, false, false);
+  }
+
+  Sequence *add_image_strip(const int channel)
+  {
+    Sequence *seq = BKE_sequence_alloc(&scene->ed->seqbase, 1, channel, SEQ_TYPE_IMAGE);
+    seq->len = 1;
+    StripElem *se = static_cast<StripElem *>(MEM_callocN(sizeof(StripElem), __func__));
+    seq->strip->stripdata = se;
+    BLI_split_dirfile(
+        filepath, seq->strip->dir, se->name, sizeof(seq->strip->dir), sizeof(se->name));
+    STRNCPY(seq->strip->colorspace_settings.name, colorspace);
+    BKE_sequence_calc_disp(scene, seq);
+    return seq;
+  }
+
+  Sequence *add_effect_strip(const int type, const int channel, Sequence *seq1, Sequence *seq2)
+  {
+    Sequence *seq = BKE_sequence_alloc(&scene->ed->seqbase, 1, channel, type);
+    struct SeqEffectHandle sh = BKE_sequence_get_effect(seq);
+    seq->seq1 = seq1;
+    seq->seq2 = seq2;
+    sh.init(seq);
+    if (seq1 == nullptr) {
+      seq->len = 1;
+    }
+    seq->flag |= SEQ_USE_EFFECT_DEFAULT_FADE;
+    BKE_sequence_calc(scene, seq);
+    return seq;
+  }
+
+  ImBuf *render_strip(Sequence *seq)
+  {
+    SeqRenderData context;
+    SEQ_render_new_render_data(
+        bmain, nullptr, scene, 4, 4, SEQ_RENDER_SIZE_SCENE, false, &context);
+    context.skip_cache = true;
+    return SEQ_render_give_ibuf_direct(&context, 1, seq);
+  }
+};
+
+TEST_F(SequencerSharedImageTest, float_effect_keeps_shared_input)
+{
+  Sequence *seq_a = add_image_strip(1);
+  Sequence *seq_b = add_image_strip(2);
+
+  /* A float color strip makes the add effect convert its image input to float. */
+  Sequence *seq_color = add_effect_strip(SEQ_TYPE_COLOR, 3, nullptr, nullptr);
+  seq_color->flag |= SEQ_MAKE_FLOAT;
+  Sequence *seq_add = add_effect_strip(SEQ_TYPE_ADD, 4, seq_b, seq_color);
+
+  ImBuf *ibuf_a = render_strip(seq_a);
+  ASSERT_NE(ibuf_a, nullptr);
+  ASSERT_NE(ibuf_a->rect, nullptr);
+  EXPECT_EQ(ibuf_a->rect_float, nullptr);
+  EXPECT_TRUE(ibuf_a->userflags & IB_SHARED);
+  const unsigned int original = ibuf_a->rect[0];
+
+  ImBuf *ibuf_add = render_strip(seq_add);
+  ASSERT_NE(ibuf_add, nullptr);
+  EXPECT_NE(ibuf_add->rect_float, nullptr);
+  IMB_freeImBuf(ibuf_add);
+
+  /* The effect converted a copy, the buffer shared by both strips is still the decoded file. */
+  ASSERT_NE(ibuf_a->rect, nullptr);
+  EXPECT_EQ(ibuf_a->rect_float, nullptr);
+  EXPECT_EQ(ibuf_a->rect[0], original);
+
+  ImBuf *ibuf_b = render_strip(seq_b);
+  ASSERT_NE(ibuf_b, nullptr);
+  EXPECT_EQ(ibuf_b, ibuf_a);
+  IMB_freeImBuf(ibuf_b);
+
+  IMB_freeImBuf(ibuf_a);
+}
+
+}  // namespace blender::seq::tests